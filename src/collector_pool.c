@@ -0,0 +1,263 @@
+#include "collector_pool.h"
+#include "thread_compat.h"
+#include <stdint.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+/* How long cleanup waits for workers stuck in a collector */
+#define POOL_STOP_WAIT_MS 1000
+
+typedef struct {
+    collector_job_t job;
+    int work;                           /* Buffer the worker fills */
+    int ready;                          /* Newest finished snapshot */
+    int front;                          /* Buffer handed to the caller */
+    bool fresh;                         /* ready is newer than front */
+    bool has_front;
+    bool in_flight;
+    bool failed;                        /* Last run returned false */
+    uint64_t submitted_ms;
+    uint64_t ready_ms;                  /* When ready was taken */
+    uint64_t front_ms;
+} job_slot_t;
+
+typedef struct {
+    thread_t thread;
+    bool exited;
+} worker_t;
+
+static job_slot_t jobs[MAX_POOL_JOBS];
+static int job_count = 0;
+static int queue[MAX_POOL_JOBS];
+static int queue_len = 0;
+
+static worker_t workers[POOL_WORKERS];
+static int worker_count = 0;
+static bool stopping = false;
+
+static mutex_t pool_lock;
+static cond_t work_cond;                /* Workers wait for queued jobs */
+static cond_t done_cond;                /* The caller waits for finished jobs */
+
+static uint64_t now_ms(void) {
+#ifdef _WIN32
+    return (uint64_t)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+#endif
+}
+
+/* Publish a finished run; called with pool_lock held */
+static void finish_job(job_slot_t *slot, bool ok) {
+    if (ok) {
+        int filled = slot->work;
+        slot->work = slot->ready;
+        slot->ready = filled;
+        slot->ready_ms = now_ms();
+        slot->fresh = true;
+    }
+    slot->failed = !ok;
+    slot->in_flight = false;
+}
+
+static THREAD_FUNC(worker_main, arg) {
+    worker_t *self = arg;
+
+    mutex_lock(&pool_lock);
+    while (!stopping) {
+        if (queue_len == 0) {
+            cond_wait_ms(&work_cond, &pool_lock, 1000);
+            continue;
+        }
+
+        job_slot_t *slot = &jobs[queue[0]];
+        queue_len--;
+        memmove(queue, queue + 1, (size_t)queue_len * sizeof(queue[0]));
+        void *out = slot->job.buffers[slot->work];
+        mutex_unlock(&pool_lock);
+
+        bool ok = slot->job.collect(slot->job.arg, out);
+
+        mutex_lock(&pool_lock);
+        finish_job(slot, ok);
+        cond_broadcast(&done_cond);
+    }
+    self->exited = true;
+    cond_broadcast(&done_cond);
+    mutex_unlock(&pool_lock);
+
+    THREAD_RETURN;
+}
+
+bool collector_pool_init(void) {
+    mutex_init(&pool_lock);
+    cond_init(&work_cond);
+    cond_init(&done_cond);
+    stopping = false;
+    job_count = 0;
+    queue_len = 0;
+
+    worker_count = 0;
+    for (int i = 0; i < POOL_WORKERS; i++) {
+        workers[worker_count].exited = false;
+        if (!thread_start(&workers[worker_count].thread, worker_main, &workers[worker_count])) {
+            break;
+        }
+        worker_count++;
+    }
+    return worker_count > 0;
+}
+
+int collector_pool_add(const collector_job_t *job) {
+    if (job_count >= MAX_POOL_JOBS) {
+        return -1;
+    }
+
+    job_slot_t *slot = &jobs[job_count];
+    memset(slot, 0, sizeof(*slot));
+    slot->job = *job;
+    slot->work = 0;
+    slot->ready = 1;
+    slot->front = 2;
+    return job_count++;
+}
+
+void collector_pool_submit(uint32_t mask) {
+    uint64_t now = now_ms();
+
+    mutex_lock(&pool_lock);
+    for (int i = 0; i < job_count; i++) {
+        job_slot_t *slot = &jobs[i];
+        if (slot->in_flight || !(mask & (1u << i))) continue;
+
+        /* No worker touches an idle job, so its inputs can change here */
+        if (slot->job.prepare) {
+            slot->job.prepare(slot->job.arg);
+        }
+        slot->in_flight = true;
+        slot->submitted_ms = now;
+        queue[queue_len++] = i;
+    }
+    cond_broadcast(&work_cond);
+
+    /* Without workers, run everything here as before */
+    if (worker_count == 0) {
+        for (int i = 0; i < queue_len; i++) {
+            job_slot_t *slot = &jobs[queue[i]];
+            mutex_unlock(&pool_lock);
+            bool ok = slot->job.collect(slot->job.arg, slot->job.buffers[slot->work]);
+            mutex_lock(&pool_lock);
+            finish_job(slot, ok);
+        }
+        queue_len = 0;
+    }
+    mutex_unlock(&pool_lock);
+}
+
+void collector_pool_wait(void) {
+    mutex_lock(&pool_lock);
+    for (;;) {
+        uint64_t now = now_ms();
+        uint64_t wait_ms = 0;
+        for (int i = 0; i < job_count; i++) {
+            const job_slot_t *slot = &jobs[i];
+            uint64_t due = slot->submitted_ms + (uint64_t)slot->job.deadline_ms;
+            if (slot->in_flight && due > now && (wait_ms == 0 || due - now < wait_ms)) {
+                wait_ms = due - now;
+            }
+        }
+        if (wait_ms == 0) break;
+        cond_wait_ms(&done_cond, &pool_lock, (int)wait_ms);
+    }
+    mutex_unlock(&pool_lock);
+}
+
+const void *collector_pool_latest(int id, collector_status_t *status) {
+    if (id < 0 || id >= job_count) {
+        return NULL;
+    }
+
+    mutex_lock(&pool_lock);
+    job_slot_t *slot = &jobs[id];
+    if (slot->fresh) {
+        int newest = slot->ready;
+        slot->ready = slot->front;
+        slot->front = newest;
+        slot->front_ms = slot->ready_ms;
+        slot->fresh = false;
+        slot->has_front = true;
+    }
+
+    uint64_t now = now_ms();
+    bool overdue = slot->in_flight &&
+                   now - slot->submitted_ms >= (uint64_t)slot->job.deadline_ms;
+    status->stale = overdue || slot->failed;
+    status->age_sec = slot->has_front ? (double)(now - slot->front_ms) / 1000.0 : 0.0;
+    const void *snapshot = slot->has_front ? slot->job.buffers[slot->front] : NULL;
+    mutex_unlock(&pool_lock);
+
+    return snapshot;
+}
+
+uint32_t collector_pool_cleanup(void) {
+    mutex_lock(&pool_lock);
+    stopping = true;
+    cond_broadcast(&work_cond);
+
+    /* Jobs no worker picked up yet never started */
+    for (int i = 0; i < queue_len; i++) {
+        jobs[queue[i]].in_flight = false;
+    }
+    queue_len = 0;
+
+    uint64_t give_up = now_ms() + POOL_STOP_WAIT_MS;
+    for (;;) {
+        bool all_exited = true;
+        for (int i = 0; i < worker_count; i++) {
+            all_exited = all_exited && workers[i].exited;
+        }
+        uint64_t now = now_ms();
+        if (all_exited || now >= give_up) break;
+        cond_wait_ms(&done_cond, &pool_lock, (int)(give_up - now));
+    }
+
+    /* A worker stuck in a collector keeps running detached; the job it
+       holds keeps its buffers */
+    for (int i = 0; i < worker_count; i++) {
+        if (workers[i].exited) {
+            mutex_unlock(&pool_lock);
+            thread_join(workers[i].thread);
+            mutex_lock(&pool_lock);
+        } else {
+            thread_detach(workers[i].thread);
+        }
+    }
+
+    uint32_t running = 0;
+    for (int i = 0; i < job_count; i++) {
+        job_slot_t *slot = &jobs[i];
+        if (slot->in_flight) {
+            running |= 1u << i;
+            continue;
+        }
+        if (slot->job.release) {
+            for (int b = 0; b < 3; b++) slot->job.release(slot->job.buffers[b]);
+        }
+    }
+    worker_count = 0;
+    job_count = 0;
+    mutex_unlock(&pool_lock);
+
+    /* The lock and conditions stay alive for workers left behind */
+    if (!running) {
+        cond_destroy(&done_cond);
+        cond_destroy(&work_cond);
+        mutex_destroy(&pool_lock);
+    }
+    return running;
+}
@@ -0,0 +1,62 @@
+#ifndef COLLECTOR_POOL_H
+#define COLLECTOR_POOL_H
+
+/* Runs collectors that can block (statfs on a hung NFS mount, scans of
+   /proc/<pid>) on a few worker threads, so a slow source cannot stall the
+   frame. Each job writes into one of three snapshot buffers: the worker
+   fills one, one holds the newest finished result, and the caller reads
+   the third, so no snapshot is copied or allocated per run. */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MAX_POOL_JOBS 8
+#define POOL_WORKERS 2
+#define POOL_ALL_JOBS 0xFFFFFFFFu
+
+/* Fill out from arg; runs on a worker thread. false keeps the previous
+   snapshot, marked stale. */
+typedef bool (*collector_fn_t)(void *arg, void *out);
+
+typedef struct {
+    const char *name;
+    collector_fn_t collect;
+    void (*prepare)(void *arg);         /* On the caller's thread before each run, optional */
+    void (*release)(void *buffer);      /* Frees a snapshot at cleanup, optional */
+    void *arg;
+    void *buffers[3];                   /* Three instances of the output type */
+    int deadline_ms;                    /* How long a frame waits for this job */
+} collector_job_t;
+
+/* Per-job state seen by the renderer */
+typedef struct {
+    bool stale;                         /* Overdue, or the last run failed */
+    double age_sec;                     /* Since the snapshot was taken */
+} collector_status_t;
+
+/* Start the worker threads (call once at startup) */
+bool collector_pool_init(void);
+
+/* Register a job; returns its id, or -1 if the table is full */
+int collector_pool_add(const collector_job_t *job);
+
+/* Queue the jobs in mask (bit n = id n) that are not still running. A job
+   still running from an earlier frame is not queued again. Without worker
+   threads the jobs run here instead. */
+void collector_pool_submit(uint32_t mask);
+
+/* Wait until the queued jobs finish or their deadlines pass, counted from
+   their submission */
+void collector_pool_wait(void);
+
+/* The newest finished snapshot of a job, NULL before its first success.
+   Valid until the next call for the same job. */
+const void *collector_pool_latest(int id, collector_status_t *status);
+
+/* Stop the workers. Workers stuck in a collector are given a second to
+   finish and are then left behind, along with their job's buffers.
+   Returns the jobs still running (bit n = id n): whatever their collector
+   uses must not be freed. */
+uint32_t collector_pool_cleanup(void);
+
+#endif /* COLLECTOR_POOL_H */
@@ -1,4 +1,5 @@
 #include "config.h"
+#include "metrics.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -10,12 +11,33 @@ void config_init_defaults(config_t *cfg) {
     cfg->refresh_ms = 1000;
     strncpy(cfg->title, "System Dashboard", MAX_TITLE_LEN - 1);
     cfg->title[MAX_TITLE_LEN - 1] = '\0';
+    cfg->container_mode = CONTAINER_MODE_AUTO;
+    cfg->io_engine = IO_ENGINE_PREAD;
+    cfg->collector_deadline_ms = 200;
+    for (int i = 0; i < COLLECTOR_COUNT; i++) {
+        cfg->interval_ms[i] = 0;
+    }
+    /* Filesystem usage moves slowly and statfs can be expensive */
+    cfg->interval_ms[COLLECTOR_DISK] = 10000;
+    strncpy(cfg->sysfs_root, "/sys", MAX_PATH_LEN - 1);
+    cfg->sysfs_root[MAX_PATH_LEN - 1] = '\0';
 
     cfg->show_cpu = true;
+    cfg->show_cpu_cores = true;
+    cfg->show_cpu_freq = true;
     cfg->show_memory = true;
+    cfg->show_numa = true;
     cfg->show_disk = true;
+    cfg->show_disk_io = true;
     cfg->show_gpu = true;
+    cfg->show_network = true;
+    cfg->show_tcp = true;
     cfg->show_temperature = true;
+    cfg->show_processes = true;
+    cfg->process_count = 5;
+    cfg->show_pressure = true;
+    cfg->show_interrupts = true;
+    cfg->show_perf = false;
 
     cfg->bar_color = COLOR_GREEN;
     cfg->title_color = COLOR_CYAN;
@@ -35,6 +57,20 @@ void config_init_defaults(config_t *cfg) {
 #endif
     cfg->disk_paths[0][MAX_PATH_LEN - 1] = '\0';
     cfg->disk_path_count = 1;
+    cfg->disk_deadline_ms = 0;
+
+    cfg->disk_auto = false;
+    cfg->disk_fstype_count = 0;
+    cfg->disk_pattern_count = 0;
+
+    cfg->net_interface_count = 0;
+    cfg->plugin_count = 0;
+    cfg->exec_command_count = 0;
+
+    cfg->psi_stall_ms = 100;
+    cfg->psi_window_ms = 2000;
+
+    cfg->memory_fields = MEMORY_FIELD_ALL;
 
     cfg->graph_style = GRAPH_STYLE_BAR;
     cfg->bar_fill_char = '#';
@@ -74,6 +110,25 @@ static color_t parse_color(const char *value) {
     return COLOR_DEFAULT;
 }
 
+/* [intervals] key of each collector_id_t */
+static const char *const collector_names[COLLECTOR_COUNT] = {
+    "cpu", "memory", "disk", "disk_io", "gpu", "network",
+    "tcp", "processes", "pressure", "interrupts", "perf"
+};
+
+/* Parse a comma-separated list of memory breakdown groups */
+static unsigned parse_memory_fields(char *value) {
+    unsigned fields = 0;
+    for (char *name = strtok(value, ", "); name; name = strtok(NULL, ", ")) {
+        if (strcmp(name, "cache") == 0) fields |= MEMORY_FIELD_CACHE;
+        else if (strcmp(name, "dirty") == 0) fields |= MEMORY_FIELD_DIRTY;
+        else if (strcmp(name, "swap") == 0) fields |= MEMORY_FIELD_SWAP;
+        else if (strcmp(name, "hugepages") == 0) fields |= MEMORY_FIELD_HUGEPAGES;
+        else if (strcmp(name, "all") == 0) fields |= MEMORY_FIELD_ALL;
+    }
+    return fields;
+}
+
 /* Parse a boolean value */
 static bool parse_bool(const char *value) {
     return (strcmp(value, "true") == 0 ||
@@ -81,6 +136,25 @@ static bool parse_bool(const char *value) {
             strcmp(value, "1") == 0);
 }
 
+/* The [exec.<name>] entry for name, added on its first key */
+static exec_command_config_t *exec_section(config_t *cfg, const char *name) {
+    for (int i = 0; i < cfg->exec_command_count; i++) {
+        if (strcmp(cfg->exec_commands[i].name, name) == 0) {
+            return &cfg->exec_commands[i];
+        }
+    }
+    if (cfg->exec_command_count >= MAX_EXEC_COMMANDS) {
+        return NULL;
+    }
+
+    exec_command_config_t *cmd = &cfg->exec_commands[cfg->exec_command_count++];
+    snprintf(cmd->name, sizeof(cmd->name), "%.*s", MAX_EXEC_NAME_LEN - 1, name);
+    cmd->command[0] = '\0';
+    cmd->interval_ms = 10000;
+    cmd->timeout_ms = 5000;
+    return cmd;
+}
+
 bool config_load(const char *filename, config_t *cfg) {
     FILE *fp = fopen(filename, "r");
     if (!fp) {
@@ -133,18 +207,64 @@ bool config_load(const char *filename, config_t *cfg) {
             } else if (strcmp(key, "title") == 0) {
                 strncpy(cfg->title, value, MAX_TITLE_LEN - 1);
                 cfg->title[MAX_TITLE_LEN - 1] = '\0';
+            } else if (strcmp(key, "sysfs_root") == 0) {
+                strncpy(cfg->sysfs_root, value, MAX_PATH_LEN - 1);
+                cfg->sysfs_root[MAX_PATH_LEN - 1] = '\0';
+            } else if (strcmp(key, "container") == 0) {
+                if (strcmp(value, "auto") == 0) {
+                    cfg->container_mode = CONTAINER_MODE_AUTO;
+                } else if (parse_bool(value) || strcmp(value, "on") == 0) {
+                    cfg->container_mode = CONTAINER_MODE_ON;
+                } else {
+                    cfg->container_mode = CONTAINER_MODE_OFF;
+                }
+            } else if (strcmp(key, "io_engine") == 0) {
+                if (strcmp(value, "uring") == 0) {
+                    cfg->io_engine = IO_ENGINE_URING;
+                } else if (strcmp(value, "off") == 0) {
+                    cfg->io_engine = IO_ENGINE_OFF;
+                } else {
+                    cfg->io_engine = IO_ENGINE_PREAD;
+                }
+            } else if (strcmp(key, "collector_deadline_ms") == 0) {
+                cfg->collector_deadline_ms = atoi(value);
+                if (cfg->collector_deadline_ms < 10) cfg->collector_deadline_ms = 10;
             }
         } else if (strcmp(current_section, "display") == 0) {
             if (strcmp(key, "show_cpu") == 0) {
                 cfg->show_cpu = parse_bool(value);
+            } else if (strcmp(key, "show_cpu_cores") == 0) {
+                cfg->show_cpu_cores = parse_bool(value);
+            } else if (strcmp(key, "show_cpu_freq") == 0) {
+                cfg->show_cpu_freq = parse_bool(value);
             } else if (strcmp(key, "show_memory") == 0) {
                 cfg->show_memory = parse_bool(value);
+            } else if (strcmp(key, "show_numa") == 0) {
+                cfg->show_numa = parse_bool(value);
             } else if (strcmp(key, "show_disk") == 0) {
                 cfg->show_disk = parse_bool(value);
+            } else if (strcmp(key, "show_disk_io") == 0) {
+                cfg->show_disk_io = parse_bool(value);
             } else if (strcmp(key, "show_gpu") == 0) {
                 cfg->show_gpu = parse_bool(value);
+            } else if (strcmp(key, "show_network") == 0) {
+                cfg->show_network = parse_bool(value);
+            } else if (strcmp(key, "show_tcp") == 0) {
+                cfg->show_tcp = parse_bool(value);
             } else if (strcmp(key, "show_temperature") == 0) {
                 cfg->show_temperature = parse_bool(value);
+            } else if (strcmp(key, "show_processes") == 0) {
+                cfg->show_processes = parse_bool(value);
+            } else if (strcmp(key, "show_interrupts") == 0) {
+                cfg->show_interrupts = parse_bool(value);
+            } else if (strcmp(key, "show_perf") == 0) {
+                cfg->show_perf = parse_bool(value);
+            } else if (strcmp(key, "show_pressure") == 0) {
+                cfg->show_pressure = parse_bool(value);
+            } else if (strcmp(key, "process_count") == 0) {
+                cfg->process_count = atoi(value);
+                if (cfg->process_count < 1) cfg->process_count = 1;
+                if (cfg->process_count > 16) cfg->process_count = 16;
             }
         } else if (strcmp(current_section, "colors") == 0) {
             if (strcmp(key, "bar") == 0) {
@@ -171,6 +291,69 @@ bool config_load(const char *filename, config_t *cfg) {
                 strncpy(cfg->disk_paths[cfg->disk_path_count], value, MAX_PATH_LEN - 1);
                 cfg->disk_paths[cfg->disk_path_count][MAX_PATH_LEN - 1] = '\0';
                 cfg->disk_path_count++;
+            } else if (strcmp(key, "auto") == 0) {
+                cfg->disk_auto = parse_bool(value);
+            } else if (strcmp(key, "deadline_ms") == 0) {
+                cfg->disk_deadline_ms = atoi(value);
+                if (cfg->disk_deadline_ms < 0) cfg->disk_deadline_ms = 0;
+            } else if (strcmp(key, "fstype") == 0 && cfg->disk_fstype_count < MAX_DISK_FILTERS) {
+                strncpy(cfg->disk_fstypes[cfg->disk_fstype_count], value, MAX_FSTYPE_LEN - 1);
+                cfg->disk_fstypes[cfg->disk_fstype_count][MAX_FSTYPE_LEN - 1] = '\0';
+                cfg->disk_fstype_count++;
+            } else if (strcmp(key, "mount") == 0 && cfg->disk_pattern_count < MAX_DISK_FILTERS) {
+                strncpy(cfg->disk_patterns[cfg->disk_pattern_count], value, MAX_PATH_LEN - 1);
+                cfg->disk_patterns[cfg->disk_pattern_count][MAX_PATH_LEN - 1] = '\0';
+                cfg->disk_pattern_count++;
+            }
+        } else if (strcmp(current_section, "network") == 0) {
+            if (strcmp(key, "interface") == 0 && cfg->net_interface_count < MAX_NET_FILTERS) {
+                strncpy(cfg->net_interfaces[cfg->net_interface_count], value, MAX_IFACE_NAME_LEN - 1);
+                cfg->net_interfaces[cfg->net_interface_count][MAX_IFACE_NAME_LEN - 1] = '\0';
+                cfg->net_interface_count++;
+            }
+        } else if (strcmp(current_section, "intervals") == 0) {
+            for (int i = 0; i < COLLECTOR_COUNT; i++) {
+                if (strcmp(key, collector_names[i]) == 0) {
+                    cfg->interval_ms[i] = atoi(value);
+                    if (cfg->interval_ms[i] < 0) cfg->interval_ms[i] = 0;
+                    if (cfg->interval_ms[i] > 0 && cfg->interval_ms[i] < 100) cfg->interval_ms[i] = 100;
+                }
+            }
+        } else if (strcmp(current_section, "plugins") == 0) {
+            if (strcmp(key, "load") == 0 && cfg->plugin_count < MAX_PLUGINS) {
+                strncpy(cfg->plugin_paths[cfg->plugin_count], value, MAX_PATH_LEN - 1);
+                cfg->plugin_paths[cfg->plugin_count][MAX_PATH_LEN - 1] = '\0';
+                cfg->plugin_count++;
+            }
+        } else if (strncmp(current_section, "exec.", 5) == 0) {
+            exec_command_config_t *cmd = exec_section(cfg, current_section + 5);
+            if (!cmd) {
+                continue;
+            }
+            if (strcmp(key, "command") == 0) {
+                strncpy(cmd->command, value, MAX_EXEC_COMMAND_LEN - 1);
+                cmd->command[MAX_EXEC_COMMAND_LEN - 1] = '\0';
+            } else if (strcmp(key, "interval_ms") == 0) {
+                cmd->interval_ms = atoi(value);
+                if (cmd->interval_ms < 100) cmd->interval_ms = 100;
+            } else if (strcmp(key, "timeout_ms") == 0) {
+                cmd->timeout_ms = atoi(value);
+                if (cmd->timeout_ms < 10) cmd->timeout_ms = 10;
+            }
+        } else if (strcmp(current_section, "pressure") == 0) {
+            if (strcmp(key, "trigger_stall_ms") == 0) {
+                cfg->psi_stall_ms = atoi(value);
+                if (cfg->psi_stall_ms < 1) cfg->psi_stall_ms = 1;
+            } else if (strcmp(key, "trigger_window_ms") == 0) {
+                /* Unprivileged triggers need whole multiples of 2 s */
+                int window = atoi(value);
+                if (window < 0) window = 0;
+                if (window > 10000) window = 10000;
+                cfg->psi_window_ms = (window + 1999) / 2000 * 2000;
+            }
+        } else if (strcmp(current_section, "memory") == 0) {
+            if (strcmp(key, "breakdown") == 0) {
+                cfg->memory_fields = parse_memory_fields(value);
             }
         } else if (strcmp(current_section, "style") == 0) {
             if (strcmp(key, "graph") == 0) {
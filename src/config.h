@@ -6,6 +6,14 @@
 #define MAX_DISK_PATHS 16
 #define MAX_PATH_LEN 256
 #define MAX_TITLE_LEN 64
+#define MAX_NET_FILTERS 16
+#define MAX_IFACE_NAME_LEN 16
+#define MAX_DISK_FILTERS 16
+#define MAX_FSTYPE_LEN 32
+#define MAX_PLUGINS 8
+#define MAX_EXEC_COMMANDS 16
+#define MAX_EXEC_NAME_LEN 32
+#define MAX_EXEC_COMMAND_LEN 384
 
 typedef enum {
     COLOR_DEFAULT = 0,
@@ -24,17 +32,71 @@ typedef enum {
     GRAPH_STYLE_LINE = 1    /* Sparkline history graph [▁▂▃▅▇▅▃▂] */
 } graph_style_t;
 
+typedef enum {
+    CONTAINER_MODE_AUTO = 0,    /* Use cgroup limits when the group has any */
+    CONTAINER_MODE_ON = 1,      /* Always report the cgroup's usage */
+    CONTAINER_MODE_OFF = 2      /* Always report host totals */
+} container_mode_t;
+
+typedef enum {
+    IO_ENGINE_URING = 0,    /* One io_uring batch per tick, pread if unavailable */
+    IO_ENGINE_PREAD = 1,    /* One pread per file per tick, batched up front */
+    IO_ENGINE_OFF = 2       /* Each collector reads its own files */
+} io_engine_t;
+
+/* Collectors with their own sampling interval ([intervals] keys) */
+typedef enum {
+    COLLECTOR_CPU = 0,
+    COLLECTOR_MEMORY,
+    COLLECTOR_DISK,
+    COLLECTOR_DISK_IO,
+    COLLECTOR_GPU,
+    COLLECTOR_NETWORK,
+    COLLECTOR_TCP,
+    COLLECTOR_PROCESSES,
+    COLLECTOR_PRESSURE,
+    COLLECTOR_INTERRUPTS,
+    COLLECTOR_PERF,
+    COLLECTOR_COUNT
+} collector_id_t;
+
+/* One [exec.<name>] section: a shell command printing "key value" lines */
+typedef struct {
+    char name[MAX_EXEC_NAME_LEN];
+    char command[MAX_EXEC_COMMAND_LEN];
+    int interval_ms;                    /* Time between runs */
+    int timeout_ms;                     /* Killed if still running after this */
+} exec_command_config_t;
+
 typedef struct {
     /* General settings */
     int refresh_ms;                     /* Refresh rate in milliseconds */
     char title[MAX_TITLE_LEN];          /* Dashboard title */
+    container_mode_t container_mode;    /* cgroup v2 limits vs host totals */
+    char sysfs_root[MAX_PATH_LEN];      /* Where sensors are discovered (Linux) */
+    io_engine_t io_engine;              /* How /proc and /sys reads are issued (Linux) */
+    int collector_deadline_ms;          /* How long a frame waits for pooled collectors */
+
+    /* Sampling interval per collector_id_t; 0 = every refresh_ms */
+    int interval_ms[COLLECTOR_COUNT];
 
     /* Display toggles */
     bool show_cpu;
+    bool show_cpu_cores;    /* Per-core grid under the CPU line */
+    bool show_cpu_freq;     /* Effective clock and per-core frequency row */
     bool show_memory;
+    bool show_numa;         /* Per-node rows under memory on multi-node hosts */
     bool show_disk;
+    bool show_disk_io;      /* Throughput/latency row under each disk */
     bool show_gpu;
+    bool show_network;
+    bool show_tcp;          /* TCP socket states under the network rows (Linux) */
     bool show_temperature;  /* Show temp values inline with CPU/GPU */
+    bool show_processes;
+    bool show_pressure;     /* PSI stall averages (Linux) */
+    bool show_interrupts;   /* Per-CPU IRQ/softirq rates (Linux) */
+    bool show_perf;         /* perf_event IPC and event rates (Linux) */
+    int process_count;      /* Rows in each top-N process list */
 
     /* Colors */
     color_t bar_color;
@@ -51,6 +113,35 @@ typedef struct {
     /* Disk paths to monitor */
     char disk_paths[MAX_DISK_PATHS][MAX_PATH_LEN];
     int disk_path_count;
+    int disk_deadline_ms;               /* 0 = collector_deadline_ms */
+
+    /* Mount auto-discovery (Linux): replaces disk_paths with every mount
+       matching the filters, tracked as mounts come and go */
+    bool disk_auto;
+    char disk_fstypes[MAX_DISK_FILTERS][MAX_FSTYPE_LEN];
+    int disk_fstype_count;
+    char disk_patterns[MAX_DISK_FILTERS][MAX_PATH_LEN];
+    int disk_pattern_count;
+
+    /* Network interfaces to show (empty = all except loopback) */
+    char net_interfaces[MAX_NET_FILTERS][MAX_IFACE_NAME_LEN];
+    int net_interface_count;
+
+    /* Pressure stall triggers: wake early when tasks stall for at least
+       stall_ms within window_ms (0 disables the triggers) */
+    int psi_stall_ms;
+    int psi_window_ms;
+
+    /* Collector plugins (shared objects) to load at startup */
+    char plugin_paths[MAX_PLUGINS][MAX_PATH_LEN];
+    int plugin_count;
+
+    /* Script collectors, run in the background (POSIX) */
+    exec_command_config_t exec_commands[MAX_EXEC_COMMANDS];
+    int exec_command_count;
+
+    /* Memory breakdown groups shown under the memory line (MEMORY_FIELD_*) */
+    unsigned memory_fields;
 
     /* Graph style */
     graph_style_t graph_style;          /* bar or line */
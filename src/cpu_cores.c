@@ -0,0 +1,43 @@
+#include "cpu_cores.h"
+
+void cpu_cores_compute(const cpu_core_ticks_t *prev,
+                       const cpu_core_ticks_t *cur,
+                       int count,
+                       cpu_core_metrics_t *out) {
+    if (count > MAX_CPU_CORES) count = MAX_CPU_CORES;
+    if (count < 0) count = 0;
+
+    const uint64_t *restrict pu = prev->user;
+    const uint64_t *restrict ps = prev->system;
+    const uint64_t *restrict pt = prev->total;
+    const uint64_t *restrict cu = cur->user;
+    const uint64_t *restrict cs = cur->system;
+    const uint64_t *restrict ct = cur->total;
+    float *restrict ou = out->user_percent;
+    float *restrict os = out->system_percent;
+    float *restrict ot = out->total_percent;
+
+    /* Deltas between refreshes are at most a few thousand ticks per core,
+       so they are narrowed to int32 before the float math. That keeps the
+       whole loop in 32-bit lanes, which compilers vectorize with plain
+       SSE2/NEON instead of needing 64-bit integer conversions. */
+    for (int i = 0; i < count; i++) {
+        int32_t du = (int32_t)(cu[i] - pu[i]);
+        int32_t ds = (int32_t)(cs[i] - ps[i]);
+        int32_t dt = (int32_t)(ct[i] - pt[i]);
+
+        /* Non-advancing cores divide by 1 and are masked to zero, written
+           arithmetically so the loop body stays branch-free */
+        int32_t valid = dt > 0;
+        int32_t denom = dt + (1 - valid) * (1 - dt);
+        float scale = (float)valid * 100.0f / (float)denom;
+        float u = (float)du * scale;
+        float s = (float)ds * scale;
+
+        ou[i] = u;
+        os[i] = s;
+        ot[i] = u + s;
+    }
+
+    out->count = count;
+}
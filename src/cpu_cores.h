@@ -0,0 +1,23 @@
+#ifndef CPU_CORES_H
+#define CPU_CORES_H
+
+#include "metrics.h"
+
+/* Raw per-core tick counters as read from the OS, one array per state.
+   Backends fill this directly; the layout lets cpu_cores_compute walk
+   every core with straight-line loads and no per-core branching. */
+typedef struct {
+    uint64_t user[MAX_CPU_CORES];     /* user + nice */
+    uint64_t system[MAX_CPU_CORES];   /* system (+ irq/softirq where reported) */
+    uint64_t total[MAX_CPU_CORES];    /* all states, including steal */
+} cpu_core_ticks_t;
+
+/* Compute per-core percentages from two tick snapshots in a single pass.
+   Cores whose total did not advance (or went backwards, e.g. offlined)
+   report 0%. */
+void cpu_cores_compute(const cpu_core_ticks_t *prev,
+                       const cpu_core_ticks_t *cur,
+                       int count,
+                       cpu_core_metrics_t *out);
+
+#endif /* CPU_CORES_H */
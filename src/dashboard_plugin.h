@@ -0,0 +1,57 @@
+#ifndef DASHBOARD_PLUGIN_H
+#define DASHBOARD_PLUGIN_H
+
+/* Collector plugin ABI. A plugin is a shared object exporting
+   DASHBOARD_PLUGIN_ENTRY, which returns a static description of the
+   collector. The dashboard owns the value slots: sample() fills
+   values[0..series_count-1] in place, so a plugin never allocates per
+   sample. This header has no other dependencies on the dashboard. */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Bumped whenever dashboard_plugin_t changes incompatibly */
+#define DASHBOARD_PLUGIN_ABI_VERSION 1
+
+/* Symbol the dashboard looks up after loading the shared object */
+#define DASHBOARD_PLUGIN_ENTRY "dashboard_plugin_v1"
+
+#ifdef _WIN32
+#define DASHBOARD_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define DASHBOARD_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+/* How a series is drawn */
+typedef enum {
+    DASHBOARD_SERIES_PERCENT = 0,       /* 0-100, threshold colors */
+    DASHBOARD_SERIES_GAUGE,             /* Absolute value, scaled to max */
+    DASHBOARD_SERIES_RATE               /* Per second, scaled to max */
+} dashboard_series_kind_t;
+
+typedef struct {
+    const char *name;                   /* Row label, up to 9 columns shown */
+    const char *unit;                   /* Printed after the value, may be "" */
+    dashboard_series_kind_t kind;
+    double max;                         /* Full scale; 0 = recent peak */
+} dashboard_series_t;
+
+typedef struct {
+    uint32_t abi_version;               /* DASHBOARD_PLUGIN_ABI_VERSION */
+    uint32_t struct_size;               /* sizeof(dashboard_plugin_t) */
+    const char *name;
+    const dashboard_series_t *series;
+    int series_count;
+    uint32_t sample_cost_us;            /* Expected cost of one sample() */
+    uint32_t min_interval_ms;           /* Sample no more often than this; 0 = every tick */
+
+    /* Set *state for the other calls; false disables the plugin */
+    bool (*init)(void **state);
+    /* Write one value per series; false keeps the previous values, marked stale */
+    bool (*sample)(void *state, double *values);
+    void (*cleanup)(void *state);
+} dashboard_plugin_t;
+
+typedef const dashboard_plugin_t *(*dashboard_plugin_entry_t)(void);
+
+#endif /* DASHBOARD_PLUGIN_H */
@@ -0,0 +1,57 @@
+#include "disk_job.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Make room for count paths; false leaves the old capacity */
+static bool reserve_paths(disk_job_t *job, int count) {
+    if (count <= job->capacity) {
+        return true;
+    }
+
+    int new_cap = job->capacity > 0 ? job->capacity : 8;
+    while (new_cap < count) new_cap *= 2;
+
+    char (*paths)[MAX_PATH_LEN] = realloc(job->paths, (size_t)new_cap * MAX_PATH_LEN);
+    if (!paths) {
+        return false;
+    }
+    job->paths = paths;
+
+    const char **ptrs = realloc(job->path_ptrs, (size_t)new_cap * sizeof(*ptrs));
+    if (!ptrs) {
+        return false;
+    }
+    job->path_ptrs = ptrs;
+    job->capacity = new_cap;
+    return true;
+}
+
+void disk_job_prepare(void *arg) {
+    disk_job_t *job = arg;
+    reserve_paths(job, job->source_count);
+
+    /* Out of memory: check the mounts that fit */
+    job->count = job->source_count < job->capacity ? job->source_count : job->capacity;
+    for (int i = 0; i < job->count; i++) {
+        snprintf(job->paths[i], MAX_PATH_LEN, "%s", job->source[i]);
+        job->path_ptrs[i] = job->paths[i];
+    }
+}
+
+bool disk_job_collect(void *arg, void *out) {
+    disk_job_t *job = arg;
+    return metrics_get_disks(job->path_ptrs, job->count, out);
+}
+
+void disk_job_release(void *buffer) {
+    metrics_free_disks(buffer);
+}
+
+void disk_job_free(disk_job_t *job) {
+    free(job->paths);
+    free(job->path_ptrs);
+    job->paths = NULL;
+    job->path_ptrs = NULL;
+    job->count = 0;
+    job->capacity = 0;
+}
@@ -0,0 +1,33 @@
+#ifndef DISK_JOB_H
+#define DISK_JOB_H
+
+/* Disk capacity as a collector pool job. mounts_refresh may replace the
+   mount list while a worker runs, so each run works on its own copy, grown
+   to fit however many mounts the host has. */
+
+#include <stdbool.h>
+#include "config.h"
+#include "metrics.h"
+
+typedef struct {
+    const char **source;                /* Current mount list, set before each submit */
+    int source_count;
+    char (*paths)[MAX_PATH_LEN];        /* Copy taken by disk_job_prepare */
+    const char **path_ptrs;
+    int count;
+    int capacity;
+} disk_job_t;
+
+/* collector_job_t.prepare: copy the source list (caller's thread) */
+void disk_job_prepare(void *arg);
+
+/* collector_job_t.collect: out is a disk_metrics_list_t */
+bool disk_job_collect(void *arg, void *out);
+
+/* collector_job_t.release: frees a disk_metrics_list_t snapshot */
+void disk_job_release(void *buffer);
+
+/* Free the copied paths */
+void disk_job_free(disk_job_t *job);
+
+#endif /* DISK_JOB_H */
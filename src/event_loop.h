@@ -0,0 +1,66 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+/* Main loop wakeups (Linux): one epoll set holding a timerfd that ticks on
+   an absolute schedule, a signalfd for SIGINT/SIGTERM/SIGWINCH and any fds
+   collectors ask to have watched. Ticks follow the clock rather than the
+   end of the previous frame, so collection and render time do not stretch
+   the period. */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define LOOP_MAX_WATCHES 16
+#define LOOP_JITTER_WINDOW 64   /* Ticks the mean and max cover */
+
+/* Conditions to watch an fd for, and reported in loop_event_t.events */
+#define LOOP_WATCH_IN (1u << 0)     /* Readable */
+#define LOOP_WATCH_PRI (1u << 1)    /* Priority data (PSI triggers) */
+#define LOOP_WATCH_ERR (1u << 2)    /* Error or hangup; always reported */
+
+typedef enum {
+    LOOP_EVENT_TICK = 0,    /* The next tick is due */
+    LOOP_EVENT_QUIT,        /* SIGINT or SIGTERM */
+    LOOP_EVENT_RESIZE,      /* SIGWINCH */
+    LOOP_EVENT_FD           /* A watched fd is ready */
+} loop_event_kind_t;
+
+typedef struct {
+    loop_event_kind_t kind;
+    int ticks;              /* TICK: periods since the last tick, >1 after an overrun */
+    int fd;                 /* FD: which one */
+    unsigned events;        /* FD: LOOP_WATCH_* bits */
+} loop_event_t;
+
+/* How late ticks were handled, against their scheduled time */
+typedef struct {
+    double last_ms;
+    double mean_ms;         /* Over the last LOOP_JITTER_WINDOW ticks */
+    double max_ms;
+    uint64_t ticks;         /* Handled since event_loop_start */
+    uint64_t missed;        /* Periods that passed without a wakeup of their own */
+} loop_jitter_t;
+
+/* Create the epoll set, timer and signalfd, and block the quit and resize
+   signals so they are only delivered there. Call before any thread is
+   started, or that thread may still take the signals. */
+bool event_loop_init(void);
+
+/* Tick every period_ms, the first tick one period from now */
+bool event_loop_start(int period_ms);
+
+/* Watch fd for LOOP_WATCH_IN and/or LOOP_WATCH_PRI */
+bool event_loop_watch(int fd, unsigned events);
+
+/* Stop watching fd (before closing it) */
+void event_loop_unwatch(int fd);
+
+/* Block until the next event. Returns false if waiting failed. */
+bool event_loop_next(loop_event_t *ev);
+
+void event_loop_get_jitter(loop_jitter_t *jitter);
+
+/* Close everything and restore the signal mask */
+void event_loop_cleanup(void);
+
+#endif /* EVENT_LOOP_H */
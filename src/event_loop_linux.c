@@ -0,0 +1,207 @@
+#include "event_loop.h"
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+
+static int epoll_fd = -1;
+static int timer_fd = -1;
+static int signal_fd = -1;
+static sigset_t loop_signals;
+static sigset_t saved_mask;
+static bool mask_saved = false;
+
+/* Ready fds from the last epoll_wait, handed out one per call */
+static struct epoll_event ready[LOOP_MAX_WATCHES + 2];
+static int ready_count = 0;
+static int ready_next = 0;
+static int watch_count = 0;
+
+/* Tick schedule: tick n is due at start_ns + n * period_ns */
+static uint64_t start_ns = 0;
+static uint64_t period_ns = 0;
+static uint64_t expirations = 0;
+
+static double lateness_ms[LOOP_JITTER_WINDOW];
+static loop_jitter_t jitter;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static bool add_fd(int fd, uint32_t events) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.fd = fd;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+bool event_loop_init(void) {
+    sigemptyset(&loop_signals);
+    sigaddset(&loop_signals, SIGINT);
+    sigaddset(&loop_signals, SIGTERM);
+    sigaddset(&loop_signals, SIGWINCH);
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    signal_fd = signalfd(-1, &loop_signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (epoll_fd < 0 || timer_fd < 0 || signal_fd < 0 ||
+        !add_fd(timer_fd, EPOLLIN) || !add_fd(signal_fd, EPOLLIN)) {
+        event_loop_cleanup();
+        return false;
+    }
+
+    /* Blocked signals stay pending for the signalfd */
+    sigprocmask(SIG_BLOCK, &loop_signals, &saved_mask);
+    mask_saved = true;
+    memset(&jitter, 0, sizeof(jitter));
+    ready_count = ready_next = 0;
+    return true;
+}
+
+bool event_loop_start(int period_ms) {
+    if (timer_fd < 0 || period_ms <= 0) {
+        return false;
+    }
+
+    period_ns = (uint64_t)period_ms * 1000000ull;
+    start_ns = now_ns();
+    expirations = 0;
+
+    /* Absolute expiries with a fixed interval never accumulate drift */
+    uint64_t first = start_ns + period_ns;
+    struct itimerspec spec;
+    spec.it_value.tv_sec = (time_t)(first / 1000000000ull);
+    spec.it_value.tv_nsec = (long)(first % 1000000000ull);
+    spec.it_interval.tv_sec = (time_t)(period_ns / 1000000000ull);
+    spec.it_interval.tv_nsec = (long)(period_ns % 1000000000ull);
+    return timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) == 0;
+}
+
+bool event_loop_watch(int fd, unsigned events) {
+    if (epoll_fd < 0 || fd < 0 || watch_count >= LOOP_MAX_WATCHES) {
+        return false;
+    }
+    uint32_t ep = 0;
+    if (events & LOOP_WATCH_IN) ep |= EPOLLIN;
+    if (events & LOOP_WATCH_PRI) ep |= EPOLLPRI;
+    if (!add_fd(fd, ep)) {
+        return false;
+    }
+    watch_count++;
+    return true;
+}
+
+void event_loop_unwatch(int fd) {
+    if (epoll_fd >= 0 && fd >= 0 && epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL) == 0) {
+        watch_count--;
+    }
+    /* Drop a buffered readiness report for it */
+    for (int i = ready_next; i < ready_count; i++) {
+        if (ready[i].data.fd == fd) ready[i].events = 0;
+    }
+}
+
+/* Record how late the timer was handled; false if it had not expired */
+static bool read_timer(loop_event_t *ev) {
+    uint64_t count;
+    if (read(timer_fd, &count, sizeof(count)) != (ssize_t)sizeof(count) || count == 0) {
+        return false;
+    }
+    expirations += count;
+
+    uint64_t due = start_ns + expirations * period_ns;
+    uint64_t now = now_ns();
+    double late = now > due ? (double)(now - due) / 1e6 : 0.0;
+
+    lateness_ms[jitter.ticks % LOOP_JITTER_WINDOW] = late;
+    jitter.ticks++;
+    jitter.missed += count - 1;
+    jitter.last_ms = late;
+
+    int window = jitter.ticks < LOOP_JITTER_WINDOW ? (int)jitter.ticks : LOOP_JITTER_WINDOW;
+    double sum = 0.0;
+    jitter.max_ms = 0.0;
+    for (int i = 0; i < window; i++) {
+        sum += lateness_ms[i];
+        if (lateness_ms[i] > jitter.max_ms) jitter.max_ms = lateness_ms[i];
+    }
+    jitter.mean_ms = sum / window;
+
+    ev->kind = LOOP_EVENT_TICK;
+    ev->ticks = (int)count;
+    return true;
+}
+
+static bool read_signal(loop_event_t *ev) {
+    struct signalfd_siginfo info;
+    if (read(signal_fd, &info, sizeof(info)) != (ssize_t)sizeof(info)) {
+        return false;
+    }
+    ev->kind = info.ssi_signo == SIGWINCH ? LOOP_EVENT_RESIZE : LOOP_EVENT_QUIT;
+    return true;
+}
+
+bool event_loop_next(loop_event_t *ev) {
+    memset(ev, 0, sizeof(*ev));
+
+    for (;;) {
+        while (ready_next < ready_count) {
+            const struct epoll_event *r = &ready[ready_next++];
+            if (r->events == 0) {
+                continue;
+            }
+            if (r->data.fd == timer_fd) {
+                if (read_timer(ev)) return true;
+            } else if (r->data.fd == signal_fd) {
+                if (read_signal(ev)) return true;
+            } else {
+                ev->kind = LOOP_EVENT_FD;
+                ev->fd = r->data.fd;
+                if (r->events & EPOLLIN) ev->events |= LOOP_WATCH_IN;
+                if (r->events & EPOLLPRI) ev->events |= LOOP_WATCH_PRI;
+                if (r->events & (EPOLLERR | EPOLLHUP)) ev->events |= LOOP_WATCH_ERR;
+                return true;
+            }
+        }
+
+        int n = epoll_wait(epoll_fd, ready, (int)(sizeof(ready) / sizeof(ready[0])), -1);
+        if (n < 0 && errno != EINTR) {
+            return false;
+        }
+        ready_count = n > 0 ? n : 0;
+        ready_next = 0;
+    }
+}
+
+void event_loop_get_jitter(loop_jitter_t *out) {
+    *out = jitter;
+}
+
+void event_loop_cleanup(void) {
+    if (mask_saved) {
+        sigprocmask(SIG_SETMASK, &saved_mask, NULL);
+        mask_saved = false;
+    }
+    if (signal_fd >= 0) {
+        close(signal_fd);
+        signal_fd = -1;
+    }
+    if (timer_fd >= 0) {
+        close(timer_fd);
+        timer_fd = -1;
+    }
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+        epoll_fd = -1;
+    }
+    ready_count = ready_next = 0;
+    watch_count = 0;
+}
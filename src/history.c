@@ -0,0 +1,45 @@
+#include "history.h"
+
+void history_add(history_t *h, double value) {
+    h->data[h->index] = value;
+    h->index = (h->index + 1) % MAX_HISTORY;
+    if (h->count < MAX_HISTORY) {
+        h->count++;
+    }
+}
+
+double history_get(const history_t *h, int samples_ago) {
+    if (samples_ago < 0 || samples_ago >= h->count) {
+        return 0.0;
+    }
+    int idx = (h->index - 1 - samples_ago + MAX_HISTORY) % MAX_HISTORY;
+    return h->data[idx];
+}
+
+double history_max(const history_t *h, int n) {
+    if (n > h->count) n = h->count;
+
+    double max = 0.0;
+    for (int i = 0; i < n; i++) {
+        double v = history_get(h, i);
+        if (v > max) max = v;
+    }
+    return max;
+}
+
+double history_min(const history_t *h, int n) {
+    if (n > h->count) n = h->count;
+    if (n <= 0) return 0.0;
+
+    double min = history_get(h, 0);
+    for (int i = 1; i < n; i++) {
+        double v = history_get(h, i);
+        if (v < min) min = v;
+    }
+    return min;
+}
+
+void history_clear(history_t *h) {
+    h->count = 0;
+    h->index = 0;
+}
@@ -0,0 +1,29 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+/* Samples kept per series for line graphs */
+#define MAX_HISTORY 128
+
+/* Fixed-size ring of recent samples, newest last */
+typedef struct {
+    double data[MAX_HISTORY];
+    int count;
+    int index;      /* Slot the next sample is written to */
+} history_t;
+
+/* Append a sample, overwriting the oldest once full */
+void history_add(history_t *h, double value);
+
+/* Sample from samples_ago steps back (0 = newest), 0.0 if out of range */
+double history_get(const history_t *h, int samples_ago);
+
+/* Largest of the newest n samples, 0.0 if empty */
+double history_max(const history_t *h, int n);
+
+/* Smallest of the newest n samples, 0.0 if empty */
+double history_min(const history_t *h, int n);
+
+/* Drop all samples */
+void history_clear(history_t *h);
+
+#endif /* HISTORY_H */
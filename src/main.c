@@ -1,6 +1,8 @@
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -10,10 +12,31 @@
 #include <getopt.h>
 #endif
 
+#include "collector_pool.h"
 #include "config.h"
+#include "disk_job.h"
 #include "metrics.h"
+#include "metrics_cgroup.h"
+#include "metrics_cpufreq.h"
+#include "metrics_diskio.h"
+#include "metrics_exec.h"
 #include "metrics_gpu.h"
+#include "metrics_irq.h"
+#include "metrics_net.h"
+#include "metrics_numa.h"
+#include "metrics_perf.h"
+#include "metrics_proc.h"
+#include "metrics_psi.h"
+#include "metrics_tcp.h"
+#include "metrics_thermal.h"
+#include "mounts.h"
+#include "plugins.h"
+#ifdef __linux__
+#include "event_loop.h"
+#include "procfs.h"
+#endif
 #include "render.h"
+#include "scheduler.h"
 
 static volatile int running = 1;
 
@@ -32,6 +55,29 @@ static void signal_handler(int sig) {
 }
 #endif
 
+static uint64_t monotonic_ms(void) {
+#ifdef _WIN32
+    return (uint64_t)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+#endif
+}
+
+/* Collectors that can block run on the collector pool; these are their
+   inputs and snapshot buffers */
+static disk_job_t disk_job;
+static disk_metrics_list_t disk_snapshots[3];
+
+#ifdef __linux__
+static process_list_t proc_snapshots[3];
+
+static bool collect_processes(void *arg, void *out) {
+    return process_metrics_get(*(const int *)arg, out);
+}
+#endif
+
 static void print_usage(const char *program_name) {
     printf("Usage: %s [OPTIONS]\n\n", program_name);
     printf("Options:\n");
@@ -121,60 +167,456 @@ int main(int argc, char *argv[]) {
     /* Set up signal handlers */
 #ifdef _WIN32
     SetConsoleCtrlHandler(console_handler, TRUE);
+#elif defined(__linux__)
+    /* Signals arrive through the event loop's signalfd; set up before any
+       collector starts a thread, so every thread has them blocked */
+    bool loop_available = event_loop_init();
+    if (!loop_available) {
+        signal(SIGINT, signal_handler);
+        signal(SIGTERM, signal_handler);
+    }
 #else
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
 #endif
 
     /* Initialize subsystems */
+#ifdef __linux__
+    /* Before any collector opens files, so they can register for batching */
+    if (cfg.io_engine != IO_ENGINE_OFF) {
+        procfs_batch_init(cfg.io_engine == IO_ENGINE_URING);
+    }
+    /* Each collector's files are tagged with its id, so only the files of
+       collectors due on a tick are fetched; /proc/stat and /proc/meminfo
+       belong to both CPU and memory */
+    procfs_batch_set_group((1u << COLLECTOR_CPU) | (1u << COLLECTOR_MEMORY));
+#endif
     if (!metrics_init()) {
         fprintf(stderr, "Error: Failed to initialize metrics subsystem\n");
         return 1;
     }
+    metrics_set_memory_fields(cfg.memory_fields);
 
     /* Initialize GPU metrics (optional, continues if unavailable) */
     bool gpu_available = gpu_metrics_init();
 
+    /* Collector plugins (optional, a plugin that fails to load is skipped) */
+    bool plugin_failed = false;
+    for (int i = 0; i < cfg.plugin_count; i++) {
+        char err[256];
+        if (!plugins_load(cfg.plugin_paths[i], err, sizeof(err))) {
+            fprintf(stderr, "Warning: Could not load plugin %s: %s\n",
+                    cfg.plugin_paths[i], err);
+            plugin_failed = true;
+        }
+    }
+    if (plugin_failed) {
+#ifdef _WIN32
+        Sleep(2000);
+#else
+        sleep(2);
+#endif
+    }
+
+#ifndef _WIN32
+    /* Script collectors run in the background; the loop only polls them */
+    bool exec_available = exec_metrics_init(cfg.exec_commands, cfg.exec_command_count);
+#endif
+
+#ifdef __linux__
+    /* Linux-only collectors (optional, continue if unavailable) */
+    bool procs_available = cfg.show_processes && process_metrics_init();
+    procfs_batch_set_group(1u << COLLECTOR_DISK_IO);
+    bool diskio_available = cfg.show_disk && cfg.show_disk_io && diskio_metrics_init();
+
+    const char *net_names[MAX_NET_FILTERS];
+    for (int i = 0; i < cfg.net_interface_count; i++) {
+        net_names[i] = cfg.net_interfaces[i];
+    }
+    procfs_batch_set_group(1u << COLLECTOR_NETWORK);
+    bool net_available = cfg.show_network &&
+                         net_metrics_init(net_names, cfg.net_interface_count);
+    procfs_batch_set_group(1u << COLLECTOR_TCP);
+    bool tcp_available = cfg.show_network && cfg.show_tcp && tcp_metrics_init(NULL);
+
+    const char *fstypes[MAX_DISK_FILTERS], *patterns[MAX_DISK_FILTERS];
+    for (int i = 0; i < cfg.disk_fstype_count; i++) {
+        fstypes[i] = cfg.disk_fstypes[i];
+    }
+    for (int i = 0; i < cfg.disk_pattern_count; i++) {
+        patterns[i] = cfg.disk_patterns[i];
+    }
+    mount_filter_t mount_filter = {
+        fstypes, cfg.disk_fstype_count, patterns, cfg.disk_pattern_count
+    };
+    bool mounts_available = cfg.show_disk && cfg.disk_auto &&
+                            mounts_init(NULL, &mount_filter);
+
+    procfs_batch_set_group(1u << COLLECTOR_CPU);
+    bool thermal_available = cfg.show_cpu && cfg.show_temperature &&
+                             thermal_metrics_init(cfg.sysfs_root);
+
+    bool cpufreq_available = cfg.show_cpu && cfg.show_cpu_freq &&
+                             cpufreq_metrics_init(cfg.sysfs_root, NULL);
+
+    procfs_batch_set_group(1u << COLLECTOR_MEMORY);
+    bool numa_available = cfg.show_memory && cfg.show_numa &&
+                          numa_metrics_init(cfg.sysfs_root);
+
+    procfs_batch_set_group((1u << COLLECTOR_CPU) | (1u << COLLECTOR_MEMORY));
+    bool cgroup_available = cfg.container_mode != CONTAINER_MODE_OFF &&
+                            cgroup_metrics_init(NULL);
+
+    procfs_batch_set_group(1u << COLLECTOR_PRESSURE);
+    bool psi_available = cfg.show_pressure &&
+                         psi_metrics_init((uint32_t)cfg.psi_stall_ms * 1000,
+                                          (uint32_t)cfg.psi_window_ms * 1000);
+
+    procfs_batch_set_group(1u << COLLECTOR_INTERRUPTS);
+    bool irq_available = cfg.show_interrupts && irq_metrics_init(NULL);
+
+    bool perf_available = cfg.show_perf && perf_metrics_init(true);
+    procfs_batch_set_group(PROCFS_BATCH_ALL);
+#endif
+
+    /* Collectors that can block (statfs on a hung NFS mount, /proc scans)
+       run on worker threads; a frame waits for them up to their deadline */
+    collector_pool_init();
+    int disk_job_id = -1;
+    int proc_job_id = -1;
+    if (cfg.show_disk) {
+        collector_job_t job = {
+            .name = "disks",
+            .collect = disk_job_collect,
+            .prepare = disk_job_prepare,
+            .release = disk_job_release,
+            .arg = &disk_job,
+            .buffers = { &disk_snapshots[0], &disk_snapshots[1], &disk_snapshots[2] },
+            .deadline_ms = cfg.disk_deadline_ms > 0 ? cfg.disk_deadline_ms
+                                                    : cfg.collector_deadline_ms,
+        };
+        disk_job_id = collector_pool_add(&job);
+    }
+#ifdef __linux__
+    if (procs_available) {
+        collector_job_t job = {
+            .name = "processes",
+            .collect = collect_processes,
+            .arg = &cfg.process_count,
+            .buffers = { &proc_snapshots[0], &proc_snapshots[1], &proc_snapshots[2] },
+            .deadline_ms = cfg.collector_deadline_ms,
+        };
+        proc_job_id = collector_pool_add(&job);
+    }
+#endif
+
     render_init();
 
     /* Prepare disk mount points array */
-    const char *mount_points[MAX_DISK_PATHS];
+    const char *config_mount_points[MAX_DISK_PATHS];
     for (int i = 0; i < cfg.disk_path_count; i++) {
-        mount_points[i] = cfg.disk_paths[i];
+        config_mount_points[i] = cfg.disk_paths[i];
+    }
+    const char **mount_points = config_mount_points;
+    int mount_count = cfg.disk_path_count;
+
+    /* Each collector is a scheduler task, in collector_id_t order so a
+       task id is its collector's id; plugins and script collectors share
+       one more task at refresh_ms and keep their own intervals inside it */
+    int intervals[COLLECTOR_COUNT + 1];
+    for (int i = 0; i < COLLECTOR_COUNT; i++) {
+        intervals[i] = cfg.interval_ms[i] > 0 ? cfg.interval_ms[i] : cfg.refresh_ms;
+    }
+    intervals[COLLECTOR_COUNT] = cfg.refresh_ms;
+    int tick_ms = sched_pick_tick(intervals, COLLECTOR_COUNT + 1);
+    sched_init(tick_ms);
+    for (int i = 0; i <= COLLECTOR_COUNT; i++) {
+        sched_add(intervals[i]);
+    }
+    const uint32_t custom_task = 1u << COLLECTOR_COUNT;
+
+#ifdef __linux__
+    /* Ticks come from a timerfd on a fixed schedule; pressure triggers
+       wake the loop through the same epoll set */
+    if (loop_available && !event_loop_start(tick_ms)) {
+        event_loop_cleanup();
+        loop_available = false;
+        signal(SIGINT, signal_handler);
+        signal(SIGTERM, signal_handler);
+    }
+    if (loop_available && psi_available) {
+        int trigger_fds[PSI_RESOURCE_COUNT];
+        int trigger_count = psi_metrics_trigger_fds(trigger_fds, PSI_RESOURCE_COUNT);
+        for (int i = 0; i < trigger_count; i++) {
+            event_loop_watch(trigger_fds[i], LOOP_WATCH_PRI);
+        }
     }
+    loop_jitter_t jitter;
+#endif
 
     /* Main loop */
     cpu_metrics_t cpu;
+    static cpu_core_metrics_t cores;   /* ~6 KB, keep off the stack */
     memory_metrics_t mem;
-    disk_metrics_list_t disks;
-    gpu_metrics_t gpu;
+    static gpu_metrics_list_t gpus;
+    diskio_metrics_list_t diskio = { NULL, 0, 0 };
+    net_metrics_list_t net;
+    tcp_metrics_t tcp;
+    const process_list_t *procs = NULL;
+    const disk_metrics_list_t *disks = NULL;
+    psi_metrics_t psi;
+    static irq_metrics_t irq;           /* ~6 KB of per-CPU rates */
+    static perf_metrics_t perf;         /* ~4 KB of per-CPU ratios */
+    static numa_metrics_t numa;
+    cgroup_metrics_t cgroup;
+    static thermal_metrics_t thermal;   /* ~7 KB of per-core sensors */
+    static cpufreq_metrics_t freq;      /* ~8 KB of per-CPU clocks */
+    plugin_metrics_t plugins;
+    static exec_metrics_t exec;         /* ~5 KB of script values */
+
+    /* Rows keep their last sample until their collector is due again */
+    bool have_cpu = false, have_cores = false, have_mem = false;
+    bool have_gpu = false, have_plugins = false, have_exec = false;
+    bool have_disks = false, have_diskio = false, have_net = false;
+    bool have_tcp = false, have_procs = false, have_psi = false;
+    bool have_irq = false, have_perf = false, have_numa = false;
+    bool have_cgroup = false, have_freq = false, have_thermal = false;
+    collector_status_t disk_status = { false, 0.0 };
+    collector_status_t proc_status = { false, 0.0 };
+
+    /* Without the event loop, ticks are counted from a fixed origin, so a
+       slow frame delays the next one without shifting the schedule */
+    uint64_t origin_ms = monotonic_ms();
+    uint64_t ticks_done = 0;
+    uint32_t due = sched_advance(0);
+    bool resized = false;
 
     while (running) {
-        /* Collect metrics */
-        bool have_cpu = cfg.show_cpu && metrics_get_cpu(&cpu);
-        bool have_mem = cfg.show_memory && metrics_get_memory(&mem);
-        bool have_disks = cfg.show_disk &&
-                          metrics_get_disks(mount_points, cfg.disk_path_count, &disks);
-        bool have_gpu = cfg.show_gpu && gpu_available && gpu_metrics_get(&gpu);
-
-        /* Render dashboard */
-        render_dashboard(&cfg,
-                         have_cpu ? &cpu : NULL,
-                         have_mem ? &mem : NULL,
-                         have_disks ? &disks : NULL,
-                         have_gpu ? &gpu : NULL);
-
-        /* Sleep for refresh interval */
+
+#ifdef __linux__
+        /* Fetch the files of every collector due now; they then parse */
+        procfs_batch_submit_groups(due);
+
+        /* Only re-parses mountinfo after the kernel flags a change */
+        if (mounts_available && (due & ((1u << COLLECTOR_DISK) | (1u << COLLECTOR_DISK_IO)))) {
+            mounts_refresh();
+            mount_points = mounts_get(&mount_count);
+        }
+#endif
+
+        /* Pooled collectors run while this thread does the rest */
+        uint32_t pool_jobs = 0;
+        if (disk_job_id >= 0 && (due & (1u << COLLECTOR_DISK))) {
+            disk_job.source = mount_points;
+            disk_job.source_count = mount_count;
+            pool_jobs |= 1u << disk_job_id;
+        }
+        if (proc_job_id >= 0 && (due & (1u << COLLECTOR_PROCESSES))) {
+            pool_jobs |= 1u << proc_job_id;
+        }
+        collector_pool_submit(pool_jobs);
+
+        /* Collect metrics; fresh marks the graphs that get a new point */
+        unsigned fresh = 0;
+        bool cpu_due = cfg.show_cpu && (due & (1u << COLLECTOR_CPU));
+        bool mem_due = cfg.show_memory && (due & (1u << COLLECTOR_MEMORY));
+        if (cpu_due) {
+            have_cpu = metrics_get_cpu(&cpu);
+            have_cores = have_cpu && cfg.show_cpu_cores && metrics_get_cpu_cores(&cores);
+            fresh |= have_cpu ? DASHBOARD_FRESH_CPU : 0;
+        }
+        if (mem_due) {
+            have_mem = metrics_get_memory(&mem);
+            fresh |= have_mem ? DASHBOARD_FRESH_MEMORY : 0;
+        }
+        if (cfg.show_gpu && gpu_available && (due & (1u << COLLECTOR_GPU))) {
+            have_gpu = gpu_metrics_get(&gpus);
+            fresh |= have_gpu ? DASHBOARD_FRESH_GPU : 0;
+        }
+        if (due & custom_task) {
+            have_plugins = plugins_get(&plugins);
+            fresh |= DASHBOARD_FRESH_PLUGINS;
+#ifndef _WIN32
+            have_exec = exec_available && exec_metrics_get(&exec);
+#endif
+        }
+
+#ifdef __linux__
+        /* The batched /proc and /sys files are parsed before waiting on the
+           pool, so each rate is timed right after its counters were read */
+        if (diskio_available && (due & (1u << COLLECTOR_DISK_IO))) {
+            have_diskio = diskio_metrics_get(mount_points, mount_count, &diskio);
+        }
+        if (net_available && (due & (1u << COLLECTOR_NETWORK))) {
+            have_net = net_metrics_get(&net);
+        }
+        if (tcp_available && (due & (1u << COLLECTOR_TCP))) {
+            have_tcp = tcp_metrics_get(&tcp);
+        }
+        if (psi_available && (due & (1u << COLLECTOR_PRESSURE))) {
+            have_psi = psi_metrics_get(&psi);
+        }
+        if (irq_available && (due & (1u << COLLECTOR_INTERRUPTS))) {
+            have_irq = irq_metrics_get(&irq);
+        }
+        if (perf_available && (due & (1u << COLLECTOR_PERF))) {
+            have_perf = perf_metrics_get(&perf);
+        }
+        if (mem_due) {
+            have_numa = have_mem && numa_available && numa_metrics_get(&numa);
+        }
+
+        if (cpu_due) {
+            have_freq = have_cpu && cpufreq_available && cpufreq_metrics_get(&freq);
+            have_thermal = have_cpu && thermal_available && thermal_metrics_get(&thermal);
+            if (have_thermal) {
+                cpu.temperature_celsius = thermal.cpu_celsius;
+            }
+        }
+
+        /* Report against the container's quota instead of the host; only
+           fresh samples are scaled, the others already were */
+        if (cgroup_available && (cpu_due || mem_due)) {
+            have_cgroup = cgroup_metrics_get(&cgroup) &&
+                          (cfg.container_mode == CONTAINER_MODE_ON ||
+                           cgroup_metrics_limited(&cgroup));
+            if (have_cgroup) {
+                cgroup_metrics_apply(&cgroup, cpu_due && have_cpu ? &cpu : NULL,
+                                     mem_due && have_mem ? &mem : NULL);
+            }
+        }
+#endif
+
+        /* The newest pooled snapshots; overdue ones are drawn as stale */
+        collector_pool_wait();
+        disks = collector_pool_latest(disk_job_id, &disk_status);
+        have_disks = disks && disks->count > 0;
+#ifdef __linux__
+        procs = collector_pool_latest(proc_job_id, &proc_status);
+        have_procs = procs != NULL;
+#endif
+
+        /* Render dashboard when anything was sampled */
+        if (due || resized) {
+            if (resized) {
+                render_resize();
+            }
+#ifdef __linux__
+            if (loop_available) {
+                event_loop_get_jitter(&jitter);
+            }
+#endif
+            dashboard_data_t data = {
+                .cpu = have_cpu ? &cpu : NULL,
+                .cores = have_cores ? &cores : NULL,
+                .freq = have_freq ? &freq : NULL,
+                .thermal = have_thermal ? &thermal : NULL,
+                .mem = have_mem ? &mem : NULL,
+                .numa = have_numa ? &numa : NULL,
+                .cgroup = have_cgroup ? &cgroup : NULL,
+                .disks = have_disks ? disks : NULL,
+                .diskio = have_disks && have_diskio ? &diskio : NULL,
+                .gpus = have_gpu ? &gpus : NULL,
+                .net = have_net ? &net : NULL,
+                .tcp = have_tcp ? &tcp : NULL,
+                .procs = have_procs ? procs : NULL,
+                .psi = have_psi ? &psi : NULL,
+                .irq = have_irq ? &irq : NULL,
+                .perf = have_perf ? &perf : NULL,
+                .plugins = have_plugins ? &plugins : NULL,
+                .exec = have_exec ? &exec : NULL,
+#ifdef __linux__
+                .jitter = loop_available ? &jitter : NULL,
+#endif
+                .stale = (disk_status.stale ? DASHBOARD_STALE_DISKS : 0) |
+                         (proc_status.stale ? DASHBOARD_STALE_PROCS : 0),
+                .fresh = fresh,
+            };
+            render_dashboard(&cfg, &data);
+        }
+
+        due = 0;
+        resized = false;
+
+#ifdef __linux__
+        /* Wait for the next tick, signal or collector fd */
+        if (loop_available) {
+            loop_event_t ev;
+            if (!event_loop_next(&ev)) {
+                break;
+            }
+            if (ev.kind == LOOP_EVENT_TICK) {
+                due = sched_advance(ev.ticks);
+            } else if (ev.kind == LOOP_EVENT_QUIT) {
+                running = 0;
+            } else if (ev.kind == LOOP_EVENT_RESIZE) {
+                resized = true;
+            } else if (ev.kind == LOOP_EVENT_FD) {
+                if (ev.events & LOOP_WATCH_ERR) {
+                    event_loop_unwatch(ev.fd);
+                }
+                /* Samples pressure straight away if a stall trigger fires */
+                if (psi_metrics_trigger_ready(ev.fd, ev.events & LOOP_WATCH_ERR)) {
+                    due = 1u << COLLECTOR_PRESSURE;
+                }
+            }
+            continue;
+        }
+#endif
+
+        /* Sleep until the next task is due */
+        uint64_t wake_ms = origin_ms + (ticks_done + (uint64_t)sched_ticks_until_due()) * (uint64_t)tick_ms;
+        uint64_t now_ms = monotonic_ms();
+        int sleep_ms = wake_ms > now_ms ? (int)(wake_ms - now_ms) : 0;
 #ifdef _WIN32
-        Sleep(cfg.refresh_ms);
+        Sleep(sleep_ms);
+#elif defined(__linux__)
+        if (psi_metrics_wait(sleep_ms)) {
+            due |= 1u << COLLECTOR_PRESSURE;
+        }
 #else
-        usleep(cfg.refresh_ms * 1000);
+        usleep(sleep_ms * 1000);
 #endif
+        uint64_t tick_now = (monotonic_ms() - origin_ms) / (uint64_t)tick_ms;
+        due |= sched_advance((int)(tick_now - ticks_done));
+        ticks_done = tick_now;
     }
 
     /* Cleanup */
     render_cleanup();
+    /* A job left running on a stuck worker keeps what its collector uses */
+    uint32_t still_running = collector_pool_cleanup();
+    bool disks_running = disk_job_id >= 0 && (still_running & (1u << disk_job_id));
+    if (!disks_running) {
+        disk_job_free(&disk_job);
+    }
+#ifdef __linux__
+    bool procs_running = proc_job_id >= 0 && (still_running & (1u << proc_job_id));
+    diskio_metrics_cleanup();
+    net_metrics_cleanup();
+    tcp_metrics_cleanup();
+    if (!procs_running) {
+        process_metrics_cleanup();
+    }
+    psi_metrics_cleanup();
+    irq_metrics_cleanup();
+    perf_metrics_cleanup();
+    numa_metrics_cleanup();
+    cgroup_metrics_cleanup();
+    if (!disks_running) {
+        mounts_cleanup();
+    }
+    thermal_metrics_cleanup();
+    cpufreq_metrics_cleanup();
+    diskio_metrics_free_list(&diskio);
+    procfs_batch_cleanup();
+    event_loop_cleanup();
+#endif
     gpu_metrics_cleanup();
+    plugins_cleanup();
+#ifndef _WIN32
+    exec_metrics_cleanup();
+#endif
     metrics_cleanup();
 
     printf("\nDashboard stopped.\n");
@@ -0,0 +1,139 @@
+#include "meminfo.h"
+#include "procfs.h"
+#include <string.h>
+
+enum {
+    MI_MEM_TOTAL,
+    MI_MEM_FREE,
+    MI_MEM_AVAILABLE,
+    MI_BUFFERS,
+    MI_CACHED,
+    MI_SWAP_TOTAL,
+    MI_SWAP_FREE,
+    MI_DIRTY,
+    MI_WRITEBACK,
+    MI_SHMEM,
+    MI_SRECLAIMABLE,
+    MI_ANON_HUGE,
+    MI_HUGE_TOTAL,
+    MI_HUGE_FREE,
+    MI_HUGE_SIZE,
+    MI_COUNT
+};
+
+typedef struct {
+    const char *key;        /* Including the colon */
+    unsigned char key_len;
+    unsigned char slot;
+    bool is_count;          /* A page count rather than kB */
+    unsigned fields;        /* MEMORY_FIELD_* that need it, 0 = always */
+} meminfo_key_t;
+
+/* sizeof counts the NUL, which stands in for the colon */
+#define KEY(name, slot, is_count, fields) { name ":", sizeof(name), slot, is_count, fields }
+
+/* In the order the kernel prints them, so the scan below mostly finds
+   each line's key at the front of the remaining set */
+static const meminfo_key_t keys[] = {
+    KEY("MemTotal",        MI_MEM_TOTAL,     false, 0),
+    KEY("MemFree",         MI_MEM_FREE,      false, 0),
+    KEY("MemAvailable",    MI_MEM_AVAILABLE, false, 0),
+    KEY("Buffers",         MI_BUFFERS,       false, 0),
+    KEY("Cached",          MI_CACHED,        false, 0),
+    KEY("SwapTotal",       MI_SWAP_TOTAL,    false, MEMORY_FIELD_SWAP),
+    KEY("SwapFree",        MI_SWAP_FREE,     false, MEMORY_FIELD_SWAP),
+    KEY("Dirty",           MI_DIRTY,         false, MEMORY_FIELD_DIRTY),
+    KEY("Writeback",       MI_WRITEBACK,     false, MEMORY_FIELD_DIRTY),
+    KEY("Shmem",           MI_SHMEM,         false, MEMORY_FIELD_CACHE),
+    KEY("SReclaimable",    MI_SRECLAIMABLE,  false, MEMORY_FIELD_CACHE),
+    KEY("AnonHugePages",   MI_ANON_HUGE,     false, MEMORY_FIELD_HUGEPAGES),
+    KEY("HugePages_Total", MI_HUGE_TOTAL,    true,  MEMORY_FIELD_HUGEPAGES),
+    KEY("HugePages_Free",  MI_HUGE_FREE,     true,  MEMORY_FIELD_HUGEPAGES),
+    KEY("Hugepagesize",    MI_HUGE_SIZE,     false, MEMORY_FIELD_HUGEPAGES),
+};
+
+#define KEY_COUNT ((int)(sizeof(keys) / sizeof(keys[0])))
+
+bool meminfo_parse(const char *buf, size_t len, unsigned fields, memory_metrics_t *mem) {
+    const meminfo_key_t *wanted[KEY_COUNT];
+    int wanted_count = 0;
+    for (int i = 0; i < KEY_COUNT; i++) {
+        if (keys[i].fields == 0 || (keys[i].fields & fields)) {
+            wanted[wanted_count++] = &keys[i];
+        }
+    }
+
+    /* Values in bytes (counts for HugePages_*) */
+    uint64_t v[MI_COUNT] = {0};
+    bool found[MI_COUNT] = {false};
+    int remaining = wanted_count;
+    int first = 0;      /* wanted[0..first) have all been found */
+
+    const char *p = buf;
+    const char *end = buf + len;
+
+    while (p < end && remaining > 0) {
+        for (int i = first; i < wanted_count; i++) {
+            const meminfo_key_t *k = wanted[i];
+            if (found[k->slot] || !procfs_has_prefix(p, end, k->key)) {
+                continue;
+            }
+            uint64_t value;
+            if (procfs_parse_u64(p + k->key_len, end, &value)) {
+                v[k->slot] = k->is_count ? value : value * 1024;
+                found[k->slot] = true;
+                remaining--;
+            }
+            break;
+        }
+        while (first < wanted_count && found[wanted[first]->slot]) first++;
+        p = procfs_next_line(p, end);
+    }
+
+    uint64_t total = v[MI_MEM_TOTAL];
+    if (total == 0) {
+        return false;
+    }
+
+    /* MemAvailable is the kernel's own estimate; older kernels lack it */
+    uint64_t available = found[MI_MEM_AVAILABLE]
+                             ? v[MI_MEM_AVAILABLE]
+                             : v[MI_MEM_FREE] + v[MI_BUFFERS] + v[MI_CACHED];
+    if (available > total) {
+        available = total;
+    }
+
+    memset(mem, 0, sizeof(*mem));
+    mem->total_bytes = total;
+    mem->free_bytes = available;
+    mem->used_bytes = total - available;
+    mem->used_percent = (double)mem->used_bytes / total * 100.0;
+    mem->breakdown_fields = fields & MEMORY_FIELD_ALL;
+
+    if (fields & MEMORY_FIELD_CACHE) {
+        /* Like free(1) and htop: shmem sits in Cached but cannot be dropped */
+        uint64_t cache = v[MI_CACHED] + v[MI_SRECLAIMABLE];
+        mem->unused_bytes = v[MI_MEM_FREE];
+        mem->buffers_bytes = v[MI_BUFFERS];
+        mem->cached_bytes = cache > v[MI_SHMEM] ? cache - v[MI_SHMEM] : 0;
+    }
+    if (fields & MEMORY_FIELD_DIRTY) {
+        mem->dirty_bytes = v[MI_DIRTY];
+        mem->writeback_bytes = v[MI_WRITEBACK];
+    }
+    if (fields & MEMORY_FIELD_SWAP) {
+        mem->swap_total_bytes = v[MI_SWAP_TOTAL];
+        mem->swap_used_bytes = v[MI_SWAP_TOTAL] > v[MI_SWAP_FREE]
+                                   ? v[MI_SWAP_TOTAL] - v[MI_SWAP_FREE] : 0;
+    }
+    if (fields & MEMORY_FIELD_HUGEPAGES) {
+        uint64_t page = v[MI_HUGE_SIZE];
+        uint64_t pool = v[MI_HUGE_TOTAL];
+        uint64_t idle = v[MI_HUGE_FREE] < pool ? v[MI_HUGE_FREE] : pool;
+        mem->hugetlb_total_bytes = pool * page;
+        mem->hugetlb_used_bytes = (pool - idle) * page;
+        mem->thp_bytes = v[MI_ANON_HUGE];
+    }
+
+    return true;
+}
@@ -0,0 +1,11 @@
+#ifndef MEMINFO_H
+#define MEMINFO_H
+
+#include "metrics.h"
+
+/* Parse /proc/meminfo contents in a single pass. The base fields (total,
+   available) are always extracted, plus the breakdown fields selected by
+   the MEMORY_FIELD_* bits in fields. Returns false if MemTotal is missing. */
+bool meminfo_parse(const char *buf, size_t len, unsigned fields, memory_metrics_t *mem);
+
+#endif /* MEMINFO_H */
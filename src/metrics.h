@@ -5,8 +5,8 @@
 #include <stdbool.h>
 #include <stddef.h>
 
-#define MAX_DISKS 16
 #define MAX_PATH_LEN 256
+#define MAX_CPU_CORES 512
 
 typedef struct {
     double user_percent;
@@ -16,11 +16,40 @@ typedef struct {
     int temperature_celsius;  /* -1 if unavailable */
 } cpu_metrics_t;
 
+/* Per-core usage, stored as parallel arrays indexed by CPU number */
+typedef struct {
+    int count;
+    float user_percent[MAX_CPU_CORES];
+    float system_percent[MAX_CPU_CORES];
+    float total_percent[MAX_CPU_CORES];   /* user + system */
+} cpu_core_metrics_t;
+
+/* Optional memory breakdown, selected with metrics_set_memory_fields */
+#define MEMORY_FIELD_CACHE      0x1u    /* Buffers and page cache */
+#define MEMORY_FIELD_DIRTY      0x2u    /* Dirty and writeback pages */
+#define MEMORY_FIELD_SWAP       0x4u
+#define MEMORY_FIELD_HUGEPAGES  0x8u    /* HugeTLB pool and THP */
+#define MEMORY_FIELD_ALL        0xFu
+
 typedef struct {
     uint64_t total_bytes;
     uint64_t used_bytes;
-    uint64_t free_bytes;
+    uint64_t free_bytes;          /* Available, including reclaimable cache */
     double used_percent;
+
+    /* Breakdown; only the MEMORY_FIELD_* groups in breakdown_fields are
+       filled, and none on platforms without one */
+    unsigned breakdown_fields;
+    uint64_t unused_bytes;        /* Not even holding cache */
+    uint64_t buffers_bytes;
+    uint64_t cached_bytes;        /* Page cache and reclaimable slab, less shmem */
+    uint64_t dirty_bytes;
+    uint64_t writeback_bytes;
+    uint64_t swap_total_bytes;
+    uint64_t swap_used_bytes;
+    uint64_t hugetlb_total_bytes; /* Reserved HugeTLB pool */
+    uint64_t hugetlb_used_bytes;
+    uint64_t thp_bytes;           /* Anonymous transparent huge pages */
 } memory_metrics_t;
 
 typedef struct {
@@ -31,9 +60,12 @@ typedef struct {
     double used_percent;
 } disk_metrics_t;
 
+/* Grows to fit the mount points asked for. Start zeroed, reuse across
+   calls, and release with metrics_free_disks. */
 typedef struct {
-    disk_metrics_t disks[MAX_DISKS];
+    disk_metrics_t *disks;
     int count;
+    int capacity;
 } disk_metrics_list_t;
 
 /* Initialize metrics subsystem (call once at startup) */
@@ -45,15 +77,28 @@ void metrics_cleanup(void);
 /* Get current CPU usage (requires two calls with delay for delta) */
 bool metrics_get_cpu(cpu_metrics_t *cpu);
 
+/* Get per-core usage over the same interval as the last metrics_get_cpu call */
+bool metrics_get_cpu_cores(cpu_core_metrics_t *cores);
+
 /* Get current memory usage */
 bool metrics_get_memory(memory_metrics_t *mem);
 
+/* Choose the breakdown groups metrics_get_memory fills (MEMORY_FIELD_*,
+   default all) */
+void metrics_set_memory_fields(unsigned fields);
+
 /* Get disk usage for a specific mount point */
 bool metrics_get_disk(const char *mount_point, disk_metrics_t *disk);
 
 /* Get disk usage for multiple mount points */
 bool metrics_get_disks(const char **mount_points, int count, disk_metrics_list_t *disks);
 
+/* Make room for at least count entries (keeps existing contents) */
+bool metrics_reserve_disks(disk_metrics_list_t *disks, int count);
+
+/* Release a list filled by metrics_get_disks */
+void metrics_free_disks(disk_metrics_list_t *disks);
+
 /* Helper to format bytes as human-readable string */
 void metrics_format_bytes(uint64_t bytes, char *buf, size_t buf_size);
 
@@ -0,0 +1,48 @@
+#ifndef METRICS_CGROUP_H
+#define METRICS_CGROUP_H
+
+#include "metrics.h"
+
+/* Usage of one cgroup v2 group measured against its own limits */
+typedef struct {
+    char path[MAX_PATH_LEN];        /* Directory under the cgroup2 mount */
+
+    bool has_cpu;                   /* cpu.stat was readable */
+    double cpu_limit_cores;         /* cpu.max quota / period, 0 if "max" */
+    double cpu_user_percent;        /* Of the quota (or of all CPUs) */
+    double cpu_system_percent;
+    double cpu_total_percent;
+    uint64_t nr_periods;            /* Cumulative enforcement periods */
+    uint64_t nr_throttled;          /* Cumulative throttled periods */
+    uint64_t throttled_usec;
+    uint64_t periods_delta;         /* Since the previous call */
+    uint64_t throttled_delta;
+    double throttled_ms;            /* Time throttled since the previous call */
+
+    bool has_memory;                /* memory.current was readable */
+    uint64_t mem_current;           /* Charged bytes, page cache included */
+    uint64_t mem_working_set;       /* mem_current minus inactive file pages */
+    uint64_t mem_limit;             /* memory.max, 0 if "max" */
+} cgroup_metrics_t;
+
+/* Initialize cgroup tracking (call once at startup). dir names the group
+   directory; NULL detects the cgroup v2 group this process belongs to.
+   Returns false if neither the cpu nor the memory files can be opened. */
+bool cgroup_metrics_init(const char *dir);
+
+/* Cleanup cgroup tracking (call once at shutdown) */
+void cgroup_metrics_cleanup(void);
+
+/* Re-read the group's counters and limits */
+bool cgroup_metrics_get(cgroup_metrics_t *cg);
+
+/* True if the group has a CPU quota or a memory limit */
+bool cgroup_metrics_limited(const cgroup_metrics_t *cg);
+
+/* Replace host-wide CPU and memory figures with the group's usage against
+   its limits. Without a CPU quota usage is relative to all online CPUs;
+   without a memory limit the host total is kept as the ceiling. */
+void cgroup_metrics_apply(const cgroup_metrics_t *cg, cpu_metrics_t *cpu,
+                          memory_metrics_t *mem);
+
+#endif /* METRICS_CGROUP_H */
@@ -0,0 +1,339 @@
+#include "metrics_cgroup.h"
+#include "procfs.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CGROUP_SMALL_BUF 64
+#define CGROUP_STAT_BUF 4096
+#define MOUNTINFO_BUF 16384
+
+enum {
+    CG_CPU_STAT = 0,
+    CG_CPU_MAX,
+    CG_MEM_CURRENT,
+    CG_MEM_MAX,
+    CG_MEM_STAT,
+    CG_FILE_COUNT
+};
+
+static const char *const cg_file_names[CG_FILE_COUNT] = {
+    "cpu.stat",
+    "cpu.max",
+    "memory.current",
+    "memory.max",
+    "memory.stat",
+};
+
+static const size_t cg_file_caps[CG_FILE_COUNT] = {
+    CGROUP_SMALL_BUF * 4,
+    CGROUP_SMALL_BUF,
+    CGROUP_SMALL_BUF,
+    CGROUP_SMALL_BUF,
+    CGROUP_STAT_BUF,
+};
+
+static procfs_file_t cg_files[CG_FILE_COUNT] = {
+    PROCFS_FILE_INIT,
+    PROCFS_FILE_INIT,
+    PROCFS_FILE_INIT,
+    PROCFS_FILE_INIT,
+    PROCFS_FILE_INIT,
+};
+
+static char cg_dir[MAX_PATH_LEN];
+static long online_cpus = 1;
+
+/* Previous cpu.stat sample for deltas */
+static bool has_prev = false;
+static uint64_t prev_user_usec, prev_system_usec;
+static uint64_t prev_periods, prev_throttled, prev_throttled_usec;
+static struct timespec prev_time;
+
+/* Copy the line starting at p into buf as a C string */
+static void copy_field(const char *p, const char *end, char *buf, size_t size) {
+    size_t n = (size_t)(end - p);
+    if (n >= size) n = size - 1;
+    memcpy(buf, p, n);
+    buf[n] = '\0';
+}
+
+/* Find the cgroup2 mount point and its root from /proc/self/mountinfo */
+static bool find_cgroup2_mount(char *mount_point, size_t mp_size,
+                               char *mount_root, size_t root_size) {
+    procfs_file_t f;
+    if (!procfs_open(&f, "/proc/self/mountinfo", MOUNTINFO_BUF) || !procfs_read(&f)) {
+        procfs_close(&f);
+        return false;
+    }
+
+    bool found = false;
+    const char *p = f.buf;
+    const char *end = p + f.len;
+
+    while (p < end && !found) {
+        const char *next = procfs_next_line(p, end);
+        const char *sep = NULL;
+
+        /* "id parent maj:min root mount_point opts [tags...] - fstype ..." */
+        for (const char *q = p; q + 3 <= next; q++) {
+            if (q[0] == ' ' && q[1] == '-' && q[2] == ' ') { sep = q + 3; break; }
+        }
+        if (sep && procfs_has_prefix(sep, next, "cgroup2 ")) {
+            const char *field = p;
+            for (int i = 0; i < 3; i++) {
+                field = memchr(field, ' ', (size_t)(next - field));
+                if (!field) break;
+                field++;
+            }
+            const char *root_end = field ? memchr(field, ' ', (size_t)(next - field)) : NULL;
+            const char *mp_end = root_end ? memchr(root_end + 1, ' ', (size_t)(next - root_end - 1)) : NULL;
+            if (mp_end) {
+                copy_field(field, root_end, mount_root, root_size);
+                copy_field(root_end + 1, mp_end, mount_point, mp_size);
+                found = true;
+            }
+        }
+        p = next;
+    }
+
+    procfs_close(&f);
+    return found;
+}
+
+/* Find this process's group from the "0::<path>" line of /proc/self/cgroup */
+static bool find_own_cgroup(char *path, size_t size) {
+    procfs_file_t f;
+    if (!procfs_open(&f, "/proc/self/cgroup", CGROUP_STAT_BUF) || !procfs_read(&f)) {
+        procfs_close(&f);
+        return false;
+    }
+
+    bool found = false;
+    const char *p = f.buf;
+    const char *end = p + f.len;
+
+    while (p < end) {
+        const char *next = procfs_next_line(p, end);
+        if (procfs_has_prefix(p, next, "0::")) {
+            const char *line_end = next;
+            if (line_end > p && line_end[-1] == '\n') line_end--;
+            copy_field(p + 3, line_end, path, size);
+            found = true;
+            break;
+        }
+        p = next;
+    }
+
+    procfs_close(&f);
+    return found;
+}
+
+/* Resolve the directory of our own cgroup v2 group */
+static bool detect_cgroup_dir(char *dir, size_t size) {
+    char mount_point[MAX_PATH_LEN], mount_root[MAX_PATH_LEN], group[MAX_PATH_LEN];
+
+    if (!find_own_cgroup(group, sizeof(group))) {
+        return false;
+    }
+    if (!find_cgroup2_mount(mount_point, sizeof(mount_point),
+                            mount_root, sizeof(mount_root))) {
+        return false;
+    }
+
+    /* Inside a cgroup namespace the group is relative to the mount root
+       already; on the host strip the mount root from the front */
+    const char *rel = group;
+    size_t root_len = strlen(mount_root);
+    if (root_len > 1 && strncmp(group, mount_root, root_len) == 0) {
+        rel = group + root_len;
+    }
+
+    int n = snprintf(dir, size, "%s%s", mount_point, strcmp(rel, "/") == 0 ? "" : rel);
+    return n > 0 && (size_t)n < size;
+}
+
+/* Parse a single number, or "max" as 0 */
+static bool parse_limit(const procfs_file_t *f, uint64_t *out) {
+    const char *p = f->buf;
+    const char *end = p + f->len;
+    if (procfs_has_prefix(p, end, "max")) {
+        *out = 0;
+        return true;
+    }
+    return procfs_parse_u64(p, end, out) != NULL;
+}
+
+/* Look up "key value" in a flat-keyed file such as cpu.stat */
+static bool stat_value(const procfs_file_t *f, const char *key, uint64_t *out) {
+    const char *p = f->buf;
+    const char *end = p + f->len;
+    size_t key_len = strlen(key);
+
+    while (p < end) {
+        const char *next = procfs_next_line(p, end);
+        if (procfs_has_prefix(p, next, key) && p + key_len < next && p[key_len] == ' ') {
+            return procfs_parse_u64(p + key_len, next, out) != NULL;
+        }
+        p = next;
+    }
+    return false;
+}
+
+static void read_cpu(cgroup_metrics_t *cg) {
+    const procfs_file_t *stat = &cg_files[CG_CPU_STAT];
+    uint64_t user_usec = 0, system_usec = 0;
+
+    if (!procfs_read(&cg_files[CG_CPU_STAT]) ||
+        !stat_value(stat, "user_usec", &user_usec) ||
+        !stat_value(stat, "system_usec", &system_usec)) {
+        return;
+    }
+    cg->has_cpu = true;
+
+    /* Only present when the cpu controller is enabled for the group */
+    stat_value(stat, "nr_periods", &cg->nr_periods);
+    stat_value(stat, "nr_throttled", &cg->nr_throttled);
+    stat_value(stat, "throttled_usec", &cg->throttled_usec);
+
+    /* "quota period", quota may be "max"; re-read as limits can change */
+    if (procfs_read(&cg_files[CG_CPU_MAX])) {
+        const procfs_file_t *max = &cg_files[CG_CPU_MAX];
+        const char *end = max->buf + max->len;
+        uint64_t quota, period;
+        if (parse_limit(max, &quota) && quota > 0) {
+            const char *p = memchr(max->buf, ' ', max->len);
+            if (p && procfs_parse_u64(p, end, &period) && period > 0) {
+                cg->cpu_limit_cores = (double)quota / (double)period;
+            }
+        }
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double elapsed_usec = (double)(now.tv_sec - prev_time.tv_sec) * 1e6 +
+                          (double)(now.tv_nsec - prev_time.tv_nsec) / 1e3;
+
+    if (has_prev && elapsed_usec > 0.0) {
+        double cores = cg->cpu_limit_cores > 0.0 ? cg->cpu_limit_cores : (double)online_cpus;
+        double capacity = elapsed_usec * cores;
+        double du = user_usec >= prev_user_usec ? (double)(user_usec - prev_user_usec) : 0.0;
+        double ds = system_usec >= prev_system_usec ? (double)(system_usec - prev_system_usec) : 0.0;
+
+        cg->cpu_user_percent = du / capacity * 100.0;
+        cg->cpu_system_percent = ds / capacity * 100.0;
+        cg->cpu_total_percent = cg->cpu_user_percent + cg->cpu_system_percent;
+
+        cg->periods_delta = cg->nr_periods >= prev_periods ? cg->nr_periods - prev_periods : 0;
+        cg->throttled_delta = cg->nr_throttled >= prev_throttled ? cg->nr_throttled - prev_throttled : 0;
+        cg->throttled_ms = cg->throttled_usec >= prev_throttled_usec
+                               ? (double)(cg->throttled_usec - prev_throttled_usec) / 1000.0
+                               : 0.0;
+    }
+
+    prev_user_usec = user_usec;
+    prev_system_usec = system_usec;
+    prev_periods = cg->nr_periods;
+    prev_throttled = cg->nr_throttled;
+    prev_throttled_usec = cg->throttled_usec;
+    prev_time = now;
+    has_prev = true;
+}
+
+static void read_memory(cgroup_metrics_t *cg) {
+    if (!procfs_read(&cg_files[CG_MEM_CURRENT]) ||
+        !procfs_parse_u64(cg_files[CG_MEM_CURRENT].buf,
+                          cg_files[CG_MEM_CURRENT].buf + cg_files[CG_MEM_CURRENT].len,
+                          &cg->mem_current)) {
+        return;
+    }
+    cg->has_memory = true;
+
+    if (procfs_read(&cg_files[CG_MEM_MAX])) {
+        parse_limit(&cg_files[CG_MEM_MAX], &cg->mem_limit);
+    }
+
+    /* Working set as the OOM killer sees it: reclaimable cache excluded */
+    uint64_t inactive_file = 0;
+    if (procfs_read(&cg_files[CG_MEM_STAT])) {
+        stat_value(&cg_files[CG_MEM_STAT], "inactive_file", &inactive_file);
+    }
+    cg->mem_working_set = cg->mem_current > inactive_file ? cg->mem_current - inactive_file : 0;
+}
+
+bool cgroup_metrics_init(const char *dir) {
+    cgroup_metrics_cleanup();
+
+    if (dir) {
+        snprintf(cg_dir, sizeof(cg_dir), "%s", dir);
+    } else if (!detect_cgroup_dir(cg_dir, sizeof(cg_dir))) {
+        return false;
+    }
+
+    online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online_cpus < 1) online_cpus = 1;
+
+    bool any = false;
+    for (int i = 0; i < CG_FILE_COUNT; i++) {
+        char path[MAX_PATH_LEN + 32];
+        snprintf(path, sizeof(path), "%s/%s", cg_dir, cg_file_names[i]);
+        if (procfs_open(&cg_files[i], path, cg_file_caps[i])) {
+            procfs_batch_add(&cg_files[i]);
+            any = true;
+        }
+    }
+    if (!any) {
+        return false;
+    }
+
+    /* Baseline read so the first real call has deltas */
+    cgroup_metrics_t dummy;
+    cgroup_metrics_get(&dummy);
+    return true;
+}
+
+void cgroup_metrics_cleanup(void) {
+    for (int i = 0; i < CG_FILE_COUNT; i++) {
+        procfs_close(&cg_files[i]);
+    }
+    cg_dir[0] = '\0';
+    has_prev = false;
+}
+
+bool cgroup_metrics_get(cgroup_metrics_t *cg) {
+    memset(cg, 0, sizeof(*cg));
+    memcpy(cg->path, cg_dir, sizeof(cg->path));
+
+    read_cpu(cg);
+    read_memory(cg);
+    return cg->has_cpu || cg->has_memory;
+}
+
+bool cgroup_metrics_limited(const cgroup_metrics_t *cg) {
+    return (cg->has_cpu && cg->cpu_limit_cores > 0.0) ||
+           (cg->has_memory && cg->mem_limit > 0);
+}
+
+void cgroup_metrics_apply(const cgroup_metrics_t *cg, cpu_metrics_t *cpu,
+                          memory_metrics_t *mem) {
+    if (cpu && cg->has_cpu) {
+        cpu->user_percent = cg->cpu_user_percent;
+        cpu->system_percent = cg->cpu_system_percent;
+        cpu->total_percent = cg->cpu_total_percent;
+        cpu->idle_percent = cpu->total_percent < 100.0 ? 100.0 - cpu->total_percent : 0.0;
+    }
+
+    if (mem && cg->has_memory) {
+        uint64_t total = mem->total_bytes;
+        if (cg->mem_limit > 0 && (total == 0 || cg->mem_limit < total)) {
+            total = cg->mem_limit;
+        }
+        mem->total_bytes = total;
+        mem->used_bytes = cg->mem_working_set;
+        mem->free_bytes = total > cg->mem_working_set ? total - cg->mem_working_set : 0;
+        mem->used_percent = total > 0 ? (double)cg->mem_working_set / (double)total * 100.0 : 0.0;
+        /* The meminfo breakdown is host-wide and would not add up */
+        mem->breakdown_fields = 0;
+    }
+}
@@ -0,0 +1,29 @@
+#include "metrics.h"
+#include <stdlib.h>
+
+/* Platform-independent helpers shared by the metrics backends */
+
+bool metrics_reserve_disks(disk_metrics_list_t *disks, int count) {
+    if (count <= disks->capacity) {
+        return true;
+    }
+
+    /* Grow geometrically so a slowly rising mount count reallocates rarely */
+    int new_cap = disks->capacity > 0 ? disks->capacity : 8;
+    while (new_cap < count) new_cap *= 2;
+
+    disk_metrics_t *grown = realloc(disks->disks, (size_t)new_cap * sizeof(disk_metrics_t));
+    if (!grown) {
+        return false;
+    }
+    disks->disks = grown;
+    disks->capacity = new_cap;
+    return true;
+}
+
+void metrics_free_disks(disk_metrics_list_t *disks) {
+    free(disks->disks);
+    disks->disks = NULL;
+    disks->count = 0;
+    disks->capacity = 0;
+}
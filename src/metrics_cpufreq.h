@@ -0,0 +1,32 @@
+#ifndef METRICS_CPUFREQ_H
+#define METRICS_CPUFREQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "metrics.h"
+
+/* Per-CPU vectors are indexed by CPU number */
+typedef struct {
+    int count;                      /* Highest CPU number + 1 */
+    float cur_mhz[MAX_CPU_CORES];   /* 0 where unknown (offline, no reading) */
+    float max_mhz[MAX_CPU_CORES];   /* Hardware maximum, 0 if unknown */
+    float avg_mhz;                  /* Mean over CPUs with a reading */
+    float avg_max_mhz;              /* Mean hardware maximum, 0 if unknown */
+    bool has_throttle_counts;       /* thermal_throttle counters exist (Intel) */
+    uint64_t throttle_events;       /* Core throttle events since the previous get */
+} cpufreq_metrics_t;
+
+/* Open scaling_cur_freq (and thermal_throttle/core_throttle_count where
+   present) for every CPU under sysfs_root (NULL for "/sys"); the files stay
+   open until cleanup. Without cpufreq (e.g. most VMs), falls back to the
+   "cpu MHz" lines of cpuinfo_path (NULL for "/proc/cpuinfo"). Returns
+   false if neither source exists. */
+bool cpufreq_metrics_init(const char *sysfs_root, const char *cpuinfo_path);
+
+/* Close all files (call once at shutdown) */
+void cpufreq_metrics_cleanup(void);
+
+/* Re-read every CPU's current frequency */
+bool cpufreq_metrics_get(cpufreq_metrics_t *freq);
+
+#endif /* METRICS_CPUFREQ_H */
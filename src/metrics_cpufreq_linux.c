@@ -0,0 +1,221 @@
+#include "metrics_cpufreq.h"
+#include "procfs.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define FREQ_BUF_SIZE 32
+#define CPUINFO_BUF_SIZE 65536
+/* Nested so each level always fits in the next one's buffer */
+#define SYSFS_DIR_LEN 320
+#define SYSFS_CPU_LEN 352
+#define SYSFS_PATH_LEN 400
+
+/* One CPU's open sysfs attributes */
+typedef struct {
+    int cpu;
+    procfs_file_t cur;          /* scaling_cur_freq, kHz */
+    procfs_file_t throttle;     /* thermal_throttle/core_throttle_count */
+    uint64_t prev_throttle;
+    float max_mhz;
+} freq_slot_t;
+
+static freq_slot_t slots[MAX_CPU_CORES];
+static int slot_count = 0;
+static int cpu_count = 0;
+static bool have_throttle = false;
+
+/* Fallback when there is no cpufreq driver */
+static procfs_file_t cpuinfo_file = PROCFS_FILE_INIT;
+
+/* Read a small numeric sysfs attribute once */
+static bool read_u64_attr(const char *path, uint64_t *out) {
+    char buf[FREQ_BUF_SIZE];
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t n = read(fd, buf, sizeof(buf));
+    close(fd);
+    return n > 0 && procfs_parse_u64(buf, buf + n, out) != NULL;
+}
+
+static bool read_file_u64(procfs_file_t *file, uint64_t *out) {
+    return procfs_read(file) &&
+           procfs_parse_u64(file->buf, file->buf + file->len, out) != NULL;
+}
+
+static void open_cpu(const char *cpu_dir, int cpu) {
+    char path[SYSFS_PATH_LEN];
+    freq_slot_t *s = &slots[slot_count];
+    procfs_file_t closed = PROCFS_FILE_INIT;
+
+    s->cur = closed;
+    s->throttle = closed;
+    snprintf(path, sizeof(path), "%s/cpufreq/scaling_cur_freq", cpu_dir);
+    if (!procfs_open(&s->cur, path, FREQ_BUF_SIZE)) {
+        return;
+    }
+    procfs_batch_add(&s->cur);
+
+    s->cpu = cpu;
+    uint64_t khz = 0;
+    snprintf(path, sizeof(path), "%s/cpufreq/cpuinfo_max_freq", cpu_dir);
+    if (!read_u64_attr(path, &khz)) {
+        snprintf(path, sizeof(path), "%s/cpufreq/scaling_max_freq", cpu_dir);
+        read_u64_attr(path, &khz);
+    }
+    s->max_mhz = (float)khz / 1000.0f;
+
+    snprintf(path, sizeof(path), "%s/thermal_throttle/core_throttle_count", cpu_dir);
+    s->prev_throttle = 0;
+    if (procfs_open(&s->throttle, path, FREQ_BUF_SIZE)) {
+        read_file_u64(&s->throttle, &s->prev_throttle);
+        procfs_batch_add(&s->throttle);
+        have_throttle = true;
+    }
+
+    slot_count++;
+    if (cpu + 1 > cpu_count) cpu_count = cpu + 1;
+}
+
+static void scan_cpus(const char *root) {
+    char dir[SYSFS_DIR_LEN];
+    snprintf(dir, sizeof(dir), "%s/devices/system/cpu", root);
+
+    DIR *d = opendir(dir);
+    if (!d) {
+        return;
+    }
+
+    struct dirent *ent;
+    while ((ent = readdir(d)) != NULL && slot_count < MAX_CPU_CORES) {
+        const char *p = ent->d_name;
+        if (strncmp(p, "cpu", 3) != 0 || p[3] < '0' || p[3] > '9') continue;
+
+        int cpu = 0;
+        for (p += 3; *p >= '0' && *p <= '9'; p++) cpu = cpu * 10 + (*p - '0');
+        if (*p != '\0' || cpu >= MAX_CPU_CORES) continue;
+
+        char cpu_dir[SYSFS_CPU_LEN];
+        snprintf(cpu_dir, sizeof(cpu_dir), "%s/cpu%d", dir, cpu);
+        open_cpu(cpu_dir, cpu);
+    }
+    closedir(d);
+}
+
+bool cpufreq_metrics_init(const char *sysfs_root, const char *cpuinfo_path) {
+    cpufreq_metrics_cleanup();
+
+    scan_cpus(sysfs_root ? sysfs_root : "/sys");
+    if (slot_count > 0) {
+        return true;
+    }
+
+    if (!procfs_open(&cpuinfo_file, cpuinfo_path ? cpuinfo_path : "/proc/cpuinfo",
+                     CPUINFO_BUF_SIZE)) {
+        return false;
+    }
+    procfs_batch_add(&cpuinfo_file);
+    return true;
+}
+
+void cpufreq_metrics_cleanup(void) {
+    for (int i = 0; i < slot_count; i++) {
+        procfs_close(&slots[i].cur);
+        procfs_close(&slots[i].throttle);
+    }
+    procfs_close(&cpuinfo_file);
+    slot_count = 0;
+    cpu_count = 0;
+    have_throttle = false;
+}
+
+/* "processor : N" starts each block; "cpu MHz : 2100.000" follows it */
+static bool read_cpuinfo(cpufreq_metrics_t *freq) {
+    if (!procfs_read(&cpuinfo_file)) {
+        return false;
+    }
+
+    const char *p = cpuinfo_file.buf;
+    const char *end = p + cpuinfo_file.len;
+    int cpu = -1;
+
+    while (p < end) {
+        uint64_t id;
+        double mhz;
+        if (procfs_has_prefix(p, end, "processor")) {
+            const char *colon = memchr(p, ':', (size_t)(end - p));
+            cpu = colon && procfs_parse_u64(colon + 1, end, &id) && id < MAX_CPU_CORES
+                      ? (int)id : -1;
+        } else if (cpu >= 0 && procfs_has_prefix(p, end, "cpu MHz")) {
+            const char *colon = memchr(p, ':', (size_t)(end - p));
+            if (colon && procfs_parse_decimal(colon + 1, end, &mhz)) {
+                freq->cur_mhz[cpu] = (float)mhz;
+                if (cpu + 1 > freq->count) freq->count = cpu + 1;
+            }
+        }
+        p = procfs_next_line(p, end);
+    }
+    return freq->count > 0;
+}
+
+bool cpufreq_metrics_get(cpufreq_metrics_t *freq) {
+    freq->count = 0;
+    freq->avg_mhz = 0.0f;
+    freq->avg_max_mhz = 0.0f;
+    freq->has_throttle_counts = have_throttle;
+    freq->throttle_events = 0;
+
+    if (slot_count == 0) {
+        if (cpuinfo_file.fd < 0) {
+            return false;
+        }
+        memset(freq->cur_mhz, 0, sizeof(freq->cur_mhz));
+        memset(freq->max_mhz, 0, sizeof(freq->max_mhz));
+        if (!read_cpuinfo(freq)) {
+            return false;
+        }
+    } else {
+        freq->count = cpu_count;
+        memset(freq->cur_mhz, 0, (size_t)cpu_count * sizeof(float));
+        memset(freq->max_mhz, 0, (size_t)cpu_count * sizeof(float));
+
+        /* One pread per open fd, no path lookups */
+        for (int i = 0; i < slot_count; i++) {
+            freq_slot_t *s = &slots[i];
+            uint64_t khz;
+            if (read_file_u64(&s->cur, &khz)) {
+                freq->cur_mhz[s->cpu] = (float)khz / 1000.0f;
+            }
+            freq->max_mhz[s->cpu] = s->max_mhz;
+
+            uint64_t events;
+            if (s->throttle.fd >= 0 && read_file_u64(&s->throttle, &events)) {
+                if (events > s->prev_throttle) {
+                    freq->throttle_events += events - s->prev_throttle;
+                }
+                s->prev_throttle = events;
+            }
+        }
+    }
+
+    int with_cur = 0, with_max = 0;
+    double sum_cur = 0.0, sum_max = 0.0;
+    for (int i = 0; i < freq->count; i++) {
+        if (freq->cur_mhz[i] > 0.0f) {
+            sum_cur += freq->cur_mhz[i];
+            with_cur++;
+        }
+        if (freq->max_mhz[i] > 0.0f) {
+            sum_max += freq->max_mhz[i];
+            with_max++;
+        }
+    }
+    if (with_cur > 0) freq->avg_mhz = (float)(sum_cur / with_cur);
+    if (with_max > 0) freq->avg_max_mhz = (float)(sum_max / with_max);
+
+    return with_cur > 0;
+}
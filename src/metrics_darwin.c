@@ -1,4 +1,5 @@
 #include "metrics.h"
+#include "cpu_cores.h"
 #include <stdio.h>
 #include <string.h>
 #include <mach/mach.h>
@@ -15,6 +16,11 @@ static uint64_t prev_idle_ticks = 0;
 static uint64_t prev_nice_ticks = 0;
 static bool first_cpu_read = true;
 
+/* Per-core ticks, double-buffered: core_ticks[core_cur] is the latest read */
+static cpu_core_ticks_t core_ticks[2];
+static int core_cur = 0;
+static int core_count = 0;
+
 bool metrics_init(void) {
     /* Perform an initial CPU read to establish baseline */
     cpu_metrics_t dummy;
@@ -40,15 +46,30 @@ bool metrics_get_cpu(cpu_metrics_t *cpu) {
         return false;
     }
 
-    /* Aggregate ticks across all CPUs */
+    /* Keep each core's ticks for metrics_get_cpu_cores, and aggregate */
     uint64_t total_user = 0, total_system = 0, total_idle = 0, total_nice = 0;
 
+    core_cur ^= 1;
+    cpu_core_ticks_t *ticks = &core_ticks[core_cur];
+    core_count = num_cpus < MAX_CPU_CORES ? (int)num_cpus : MAX_CPU_CORES;
+
     for (natural_t i = 0; i < num_cpus; i++) {
         processor_cpu_load_info_t info = (processor_cpu_load_info_t)cpu_info;
-        total_user += info[i].cpu_ticks[CPU_STATE_USER];
-        total_system += info[i].cpu_ticks[CPU_STATE_SYSTEM];
-        total_idle += info[i].cpu_ticks[CPU_STATE_IDLE];
-        total_nice += info[i].cpu_ticks[CPU_STATE_NICE];
+        uint64_t user = info[i].cpu_ticks[CPU_STATE_USER];
+        uint64_t system = info[i].cpu_ticks[CPU_STATE_SYSTEM];
+        uint64_t idle = info[i].cpu_ticks[CPU_STATE_IDLE];
+        uint64_t nice = info[i].cpu_ticks[CPU_STATE_NICE];
+
+        if ((int)i < core_count) {
+            ticks->user[i] = user + nice;
+            ticks->system[i] = system;
+            ticks->total[i] = user + nice + system + idle;
+        }
+
+        total_user += user;
+        total_system += system;
+        total_idle += idle;
+        total_nice += nice;
     }
 
     /* Deallocate the cpu_info array */
@@ -60,6 +81,7 @@ bool metrics_get_cpu(cpu_metrics_t *cpu) {
         prev_system_ticks = total_system;
         prev_idle_ticks = total_idle;
         prev_nice_ticks = total_nice;
+        core_ticks[core_cur ^ 1] = core_ticks[core_cur];
         first_cpu_read = false;
 
         /* Return zeros for first read */
@@ -99,6 +121,16 @@ bool metrics_get_cpu(cpu_metrics_t *cpu) {
     return true;
 }
 
+bool metrics_get_cpu_cores(cpu_core_metrics_t *cores) {
+    if (core_count == 0) {
+        return false;
+    }
+
+    cpu_cores_compute(&core_ticks[core_cur ^ 1], &core_ticks[core_cur],
+                      core_count, cores);
+    return true;
+}
+
 bool metrics_get_memory(memory_metrics_t *mem) {
     mach_port_t host = mach_host_self();
     vm_size_t page_size;
@@ -128,6 +160,7 @@ bool metrics_get_memory(memory_metrics_t *mem) {
                      (uint64_t)vm_stats.wire_count +
                      (uint64_t)vm_stats.compressor_page_count) * page_size;
 
+    memset(mem, 0, sizeof(*mem));
     mem->total_bytes = total_mem;
     mem->used_bytes = used;
     mem->free_bytes = total_mem - used;
@@ -136,6 +169,11 @@ bool metrics_get_memory(memory_metrics_t *mem) {
     return true;
 }
 
+/* No breakdown sources wired up on this platform yet */
+void metrics_set_memory_fields(unsigned fields) {
+    (void)fields;
+}
+
 bool metrics_get_disk(const char *mount_point, disk_metrics_t *disk) {
     struct statfs fs;
 
@@ -161,8 +199,11 @@ bool metrics_get_disk(const char *mount_point, disk_metrics_t *disk) {
 
 bool metrics_get_disks(const char **mount_points, int count, disk_metrics_list_t *disks) {
     disks->count = 0;
+    if (!metrics_reserve_disks(disks, count)) {
+        return false;
+    }
 
-    for (int i = 0; i < count && i < MAX_DISKS; i++) {
+    for (int i = 0; i < count; i++) {
         if (metrics_get_disk(mount_points[i], &disks->disks[disks->count])) {
             disks->count++;
         }
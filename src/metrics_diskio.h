@@ -0,0 +1,44 @@
+#ifndef METRICS_DISKIO_H
+#define METRICS_DISKIO_H
+
+#include "metrics.h"
+
+#define MAX_BLOCK_DEVICES 256
+#define BLOCK_DEVICE_NAME_LEN 32
+
+/* I/O rates for the block device backing one mount point */
+typedef struct {
+    char mount_point[MAX_PATH_LEN];
+    char device[BLOCK_DEVICE_NAME_LEN];   /* e.g. "nvme0n1p2" */
+    bool found;                           /* false if no block device matched */
+    double read_iops;
+    double write_iops;
+    double read_bytes_per_sec;
+    double write_bytes_per_sec;
+    double queue_depth;                   /* Average requests in flight */
+    double await_ms;                      /* Average time per completed request */
+    double util_percent;                  /* Time the device was busy */
+} diskio_metrics_t;
+
+/* Grows like disk_metrics_list_t: start zeroed, reuse across calls, and
+   release with diskio_metrics_free_list */
+typedef struct {
+    diskio_metrics_t *disks;
+    int count;
+    int capacity;
+} diskio_metrics_list_t;
+
+/* Initialize disk I/O tracking (call once at startup) */
+bool diskio_metrics_init(void);
+
+/* Cleanup disk I/O tracking (call once at shutdown) */
+void diskio_metrics_cleanup(void);
+
+/* Get I/O rates since the previous call for the device behind each mount
+   point. Entries are in mount_points order, one per path. */
+bool diskio_metrics_get(const char **mount_points, int count, diskio_metrics_list_t *list);
+
+/* Release a list filled by diskio_metrics_get */
+void diskio_metrics_free_list(diskio_metrics_list_t *list);
+
+#endif /* METRICS_DISKIO_H */
@@ -0,0 +1,240 @@
+#include "metrics_diskio.h"
+#include "procfs.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <time.h>
+
+#define DISKSTATS_BUF_SIZE 32768
+
+/* Counter columns of /proc/diskstats after major, minor and name */
+enum {
+    DS_READS = 0,
+    DS_READS_MERGED,
+    DS_SECTORS_READ,
+    DS_MS_READING,
+    DS_WRITES,
+    DS_WRITES_MERGED,
+    DS_SECTORS_WRITTEN,
+    DS_MS_WRITING,
+    DS_IN_FLIGHT,
+    DS_MS_IO,
+    DS_MS_WEIGHTED,
+    DS_FIELD_COUNT
+};
+
+/* diskstats sectors are always 512 bytes, regardless of the device */
+#define SECTOR_SIZE 512
+
+typedef struct {
+    unsigned int major;
+    unsigned int minor;
+    char name[BLOCK_DEVICE_NAME_LEN];
+    uint64_t cur[DS_FIELD_COUNT];
+    uint64_t prev[DS_FIELD_COUNT];
+    bool has_prev;
+} block_device_t;
+
+static procfs_file_t diskstats_file = PROCFS_FILE_INIT;
+
+/* Kept in the same order as the lines of /proc/diskstats */
+static block_device_t devices[MAX_BLOCK_DEVICES];
+static int device_count = 0;
+
+static struct timespec prev_read_time;
+static double elapsed_ms = 0.0;
+
+bool diskio_metrics_init(void) {
+    diskio_metrics_cleanup();
+
+    if (!procfs_open(&diskstats_file, "/proc/diskstats", DISKSTATS_BUF_SIZE)) {
+        return false;
+    }
+    procfs_batch_add(&diskstats_file);
+
+    /* Baseline read so the first real call has deltas */
+    diskio_metrics_list_t dummy = { NULL, 0, 0 };
+    diskio_metrics_get(NULL, 0, &dummy);
+    return true;
+}
+
+void diskio_metrics_cleanup(void) {
+    procfs_close(&diskstats_file);
+    device_count = 0;
+}
+
+/* Find the slot for major:minor, expecting it at slot hint (its line
+   number) so a stable device list costs one comparison per line */
+static block_device_t *claim_slot(int hint, unsigned int major, unsigned int minor) {
+    block_device_t *slot = &devices[hint];
+    if (hint < device_count && slot->major == major && slot->minor == minor) {
+        return slot;
+    }
+
+    /* Device list changed: move a matching later entry into place */
+    for (int j = hint + 1; j < device_count; j++) {
+        if (devices[j].major == major && devices[j].minor == minor) {
+            block_device_t tmp = devices[hint];
+            devices[hint] = devices[j];
+            devices[j] = tmp;
+            return slot;
+        }
+    }
+
+    /* New device. The displaced entry (if any) is shifted to the end so it
+       can still be matched by a later line. */
+    if (hint < device_count && device_count < MAX_BLOCK_DEVICES) {
+        devices[device_count++] = *slot;
+    }
+    if (hint >= device_count) {
+        device_count = hint + 1;
+    }
+    slot->major = major;
+    slot->minor = minor;
+    slot->has_prev = false;
+    return slot;
+}
+
+static bool read_diskstats(void) {
+    if (!procfs_read(&diskstats_file)) {
+        return false;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    elapsed_ms = (double)(now.tv_sec - prev_read_time.tv_sec) * 1000.0 +
+                 (double)(now.tv_nsec - prev_read_time.tv_nsec) / 1e6;
+    prev_read_time = now;
+
+    const char *p = diskstats_file.buf;
+    const char *end = p + diskstats_file.len;
+    int line = 0;
+
+    while (p < end && line < MAX_BLOCK_DEVICES) {
+        const char *next = procfs_next_line(p, end);
+        uint64_t major, minor;
+
+        p = procfs_parse_u64(p, next, &major);
+        if (p) p = procfs_parse_u64(p, next, &minor);
+        if (!p) {
+            p = next;
+            continue;
+        }
+
+        block_device_t *dev = claim_slot(line, (unsigned int)major, (unsigned int)minor);
+
+        /* Device name */
+        p = procfs_skip_blanks(p, next);
+        const char *name = p;
+        while (p < next && *p != ' ') p++;
+        size_t name_len = (size_t)(p - name);
+        if (name_len >= BLOCK_DEVICE_NAME_LEN) name_len = BLOCK_DEVICE_NAME_LEN - 1;
+        memcpy(dev->name, name, name_len);
+        dev->name[name_len] = '\0';
+
+        memcpy(dev->prev, dev->cur, sizeof(dev->cur));
+        bool complete = true;
+        for (int f = 0; f < DS_FIELD_COUNT; f++) {
+            p = procfs_parse_u64(p, next, &dev->cur[f]);
+            if (!p) { complete = false; break; }
+        }
+
+        if (!complete) {
+            dev->has_prev = false;
+        } else if (!dev->has_prev) {
+            memcpy(dev->prev, dev->cur, sizeof(dev->cur));
+            dev->has_prev = true;
+        }
+
+        line++;
+        p = next;
+    }
+
+    device_count = line;
+    return true;
+}
+
+static const block_device_t *find_device(unsigned int major, unsigned int minor) {
+    for (int i = 0; i < device_count; i++) {
+        if (devices[i].major == major && devices[i].minor == minor) {
+            return &devices[i];
+        }
+    }
+    return NULL;
+}
+
+static void compute_rates(const block_device_t *dev, diskio_metrics_t *out) {
+    uint64_t d[DS_FIELD_COUNT];
+    for (int f = 0; f < DS_FIELD_COUNT; f++) {
+        d[f] = dev->cur[f] >= dev->prev[f] ? dev->cur[f] - dev->prev[f] : 0;
+    }
+
+    double seconds = elapsed_ms / 1000.0;
+    if (seconds <= 0.0) {
+        return;
+    }
+
+    out->read_iops = (double)d[DS_READS] / seconds;
+    out->write_iops = (double)d[DS_WRITES] / seconds;
+    out->read_bytes_per_sec = (double)d[DS_SECTORS_READ] * SECTOR_SIZE / seconds;
+    out->write_bytes_per_sec = (double)d[DS_SECTORS_WRITTEN] * SECTOR_SIZE / seconds;
+    out->queue_depth = (double)d[DS_MS_WEIGHTED] / elapsed_ms;
+    out->util_percent = (double)d[DS_MS_IO] / elapsed_ms * 100.0;
+    if (out->util_percent > 100.0) out->util_percent = 100.0;
+
+    uint64_t ios = d[DS_READS] + d[DS_WRITES];
+    if (ios > 0) {
+        out->await_ms = (double)(d[DS_MS_READING] + d[DS_MS_WRITING]) / (double)ios;
+    }
+}
+
+bool diskio_metrics_get(const char **mount_points, int count, diskio_metrics_list_t *list) {
+    list->count = 0;
+
+    if (!read_diskstats()) {
+        return false;
+    }
+
+    if (count > list->capacity) {
+        int new_cap = list->capacity > 0 ? list->capacity : 8;
+        while (new_cap < count) new_cap *= 2;
+        diskio_metrics_t *grown = realloc(list->disks, (size_t)new_cap * sizeof(diskio_metrics_t));
+        if (!grown) {
+            return false;
+        }
+        list->disks = grown;
+        list->capacity = new_cap;
+    }
+
+    for (int i = 0; i < count; i++) {
+        diskio_metrics_t *out = &list->disks[list->count++];
+        memset(out, 0, sizeof(*out));
+        strncpy(out->mount_point, mount_points[i], MAX_PATH_LEN - 1);
+
+        /* The mount point's st_dev is the major:minor of the block device
+           (or partition) it lives on, matching the diskstats key */
+        struct stat st;
+        if (stat(mount_points[i], &st) != 0) {
+            continue;
+        }
+
+        const block_device_t *dev = find_device(major(st.st_dev), minor(st.st_dev));
+        if (!dev) {
+            continue;   /* e.g. tmpfs, overlay or NFS: no block device */
+        }
+
+        out->found = true;
+        strncpy(out->device, dev->name, BLOCK_DEVICE_NAME_LEN - 1);
+        compute_rates(dev, out);
+    }
+
+    return true;
+}
+
+void diskio_metrics_free_list(diskio_metrics_list_t *list) {
+    free(list->disks);
+    list->disks = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
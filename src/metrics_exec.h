@@ -0,0 +1,57 @@
+#ifndef METRICS_EXEC_H
+#define METRICS_EXEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "config.h"
+
+/* "key value" pairs kept from one command's output */
+#define MAX_EXEC_VALUES 8
+#define EXEC_KEY_LEN 24
+
+typedef enum {
+    EXEC_STATUS_PENDING = 0,            /* Not finished a run yet */
+    EXEC_STATUS_OK,
+    EXEC_STATUS_FAILED,                 /* Non-zero exit, killed, or no values */
+    EXEC_STATUS_TIMEOUT,                /* Killed at its timeout */
+    EXEC_STATUS_SPAWN_ERROR
+} exec_status_t;
+
+typedef struct {
+    char key[EXEC_KEY_LEN];
+    double value;
+} exec_value_t;
+
+typedef struct {
+    const char *name;
+    exec_value_t values[MAX_EXEC_VALUES];   /* From the last good run */
+    int value_count;
+    bool stale;                         /* Last run failed, or the values are overdue */
+    exec_status_t status;               /* Outcome of the latest finished run */
+    int exit_code;                      /* Exit status, or -signal, when FAILED */
+    double age_sec;                     /* Since the last good run */
+} exec_command_metrics_t;
+
+typedef struct {
+    int count;
+    exec_command_metrics_t commands[MAX_EXEC_COMMANDS];
+} exec_metrics_t;
+
+/* Run each command with "/bin/sh -c" every interval_ms, in its own
+   process group with stdin and stderr on /dev/null. Commands with an
+   empty command line are skipped. Returns false if none are left. */
+bool exec_metrics_init(const exec_command_config_t *commands, int count);
+
+/* Kill any running commands and reap them (call once at shutdown) */
+void exec_metrics_cleanup(void);
+
+/* Start commands that are due, drain their stdout without blocking, kill
+   those past their timeout and reap the ones that exited. Never waits on
+   a child, so a hung script cannot delay the caller. */
+bool exec_metrics_get(exec_metrics_t *exec);
+
+/* Parse "key value" lines from a command's output; blank lines, '#'
+   comments and lines without a number are skipped (exposed for testing) */
+int exec_parse_output(const char *buf, size_t len, exec_value_t *values, int max);
+
+#endif /* METRICS_EXEC_H */
@@ -0,0 +1,275 @@
+#include "metrics_exec.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+extern char **environ;
+
+/* Output past this is read and dropped */
+#define EXEC_OUTPUT_LEN 4096
+
+typedef struct {
+    const exec_command_config_t *cfg;
+    pid_t pid;                          /* Running child, 0 when idle */
+    int out_fd;                         /* Read end of its stdout, -1 once closed */
+    char output[EXEC_OUTPUT_LEN];
+    size_t output_len;
+    bool timed_out;
+    uint64_t started_ms;
+    uint64_t next_run_ms;
+    uint64_t last_good_ms;
+    exec_command_metrics_t metrics;
+} exec_slot_t;
+
+static exec_command_config_t commands[MAX_EXEC_COMMANDS];
+static exec_slot_t slots[MAX_EXEC_COMMANDS];
+static int slot_count = 0;
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+int exec_parse_output(const char *buf, size_t len, exec_value_t *values, int max) {
+    const char *p = buf, *end = buf + len;
+    int count = 0;
+
+    while (p < end && count < max) {
+        const char *eol = memchr(p, '\n', (size_t)(end - p));
+        if (!eol) eol = end;
+
+        while (p < eol && (*p == ' ' || *p == '\t')) p++;
+        const char *key = p;
+        while (p < eol && *p != ' ' && *p != '\t') p++;
+        size_t key_len = (size_t)(p - key);
+
+        if (key_len > 0 && key[0] != '#') {
+            char num[32];
+            while (p < eol && (*p == ' ' || *p == '\t')) p++;
+            size_t num_len = (size_t)(eol - p);
+            if (num_len >= sizeof(num)) num_len = sizeof(num) - 1;
+            memcpy(num, p, num_len);
+            num[num_len] = '\0';
+
+            char *num_end;
+            double value = strtod(num, &num_end);
+            if (num_end != num) {
+                if (key_len >= EXEC_KEY_LEN) key_len = EXEC_KEY_LEN - 1;
+                memcpy(values[count].key, key, key_len);
+                values[count].key[key_len] = '\0';
+                values[count].value = value;
+                count++;
+            }
+        }
+        p = eol + 1;
+    }
+
+    return count;
+}
+
+/* Start the command with its stdout on a non-blocking pipe */
+static bool spawn_command(exec_slot_t *slot) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+    /* Own process group, so a timeout also kills whatever the script
+       started; default signal state, whatever the dashboard blocks */
+    posix_spawnattr_t attr;
+    sigset_t none, defaults;
+    sigemptyset(&none);
+    sigemptyset(&defaults);
+    sigaddset(&defaults, SIGINT);
+    sigaddset(&defaults, SIGTERM);
+    sigaddset(&defaults, SIGPIPE);
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK |
+                                    POSIX_SPAWN_SETSIGDEF);
+    posix_spawnattr_setpgroup(&attr, 0);
+    posix_spawnattr_setsigmask(&attr, &none);
+    posix_spawnattr_setsigdefault(&attr, &defaults);
+
+    char *argv[] = { "sh", "-c", (char *)slot->cfg->command, NULL };
+    pid_t pid;
+    int rc = posix_spawn(&pid, "/bin/sh", &actions, &attr, argv, environ);
+
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+
+    if (rc != 0) {
+        close(fds[0]);
+        return false;
+    }
+
+    slot->pid = pid;
+    slot->out_fd = fds[0];
+    slot->output_len = 0;
+    slot->timed_out = false;
+    return true;
+}
+
+/* Read whatever is in the pipe; closes it at EOF */
+static void drain_output(exec_slot_t *slot) {
+    for (;;) {
+        char discard[512];
+        char *dst = discard;
+        size_t room = sizeof(discard);
+        if (slot->output_len < EXEC_OUTPUT_LEN) {
+            dst = slot->output + slot->output_len;
+            room = EXEC_OUTPUT_LEN - slot->output_len;
+        }
+
+        ssize_t n = read(slot->out_fd, dst, room);
+        if (n > 0) {
+            if (dst != discard) slot->output_len += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n == 0) {
+            close(slot->out_fd);
+            slot->out_fd = -1;
+        }
+        return;     /* EAGAIN: nothing more for now */
+    }
+}
+
+/* Record how the run that just got reaped went */
+static void finish_run(exec_slot_t *slot, int wstatus, uint64_t now) {
+    exec_command_metrics_t *m = &slot->metrics;
+
+    if (slot->timed_out) {
+        m->status = EXEC_STATUS_TIMEOUT;
+    } else if (WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0) {
+        exec_value_t values[MAX_EXEC_VALUES];
+        int count = exec_parse_output(slot->output, slot->output_len, values, MAX_EXEC_VALUES);
+        if (count > 0) {
+            memcpy(m->values, values, (size_t)count * sizeof(exec_value_t));
+            m->value_count = count;
+            m->status = EXEC_STATUS_OK;
+            m->exit_code = 0;
+            slot->last_good_ms = now;
+        } else {
+            m->status = EXEC_STATUS_FAILED;
+            m->exit_code = 0;
+        }
+    } else {
+        m->status = EXEC_STATUS_FAILED;
+        m->exit_code = WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : -WTERMSIG(wstatus);
+    }
+
+    /* A run that overshoots its interval starts the next one straight away */
+    slot->next_run_ms = slot->started_ms + (uint64_t)slot->cfg->interval_ms;
+}
+
+static void poll_slot(exec_slot_t *slot, uint64_t now) {
+    if (slot->pid == 0) {
+        if (now < slot->next_run_ms) {
+            return;
+        }
+        slot->started_ms = now;
+        if (!spawn_command(slot)) {
+            slot->metrics.status = EXEC_STATUS_SPAWN_ERROR;
+            slot->next_run_ms = now + (uint64_t)slot->cfg->interval_ms;
+            return;
+        }
+    }
+
+    if (slot->out_fd >= 0) {
+        drain_output(slot);
+    }
+
+    if (!slot->timed_out && now - slot->started_ms >= (uint64_t)slot->cfg->timeout_ms) {
+        kill(-slot->pid, SIGKILL);
+        slot->timed_out = true;
+        /* Children that escaped the group may still hold the pipe open */
+        if (slot->out_fd >= 0) {
+            close(slot->out_fd);
+            slot->out_fd = -1;
+        }
+    }
+
+    int wstatus;
+    if (slot->out_fd < 0 && waitpid(slot->pid, &wstatus, WNOHANG) == slot->pid) {
+        slot->pid = 0;
+        finish_run(slot, wstatus, now);
+    }
+}
+
+bool exec_metrics_init(const exec_command_config_t *cmds, int count) {
+    exec_metrics_cleanup();
+
+    uint64_t now = now_ms();
+    for (int i = 0; i < count && slot_count < MAX_EXEC_COMMANDS; i++) {
+        if (cmds[i].command[0] == '\0') continue;
+
+        commands[slot_count] = cmds[i];
+        exec_slot_t *slot = &slots[slot_count];
+        memset(slot, 0, sizeof(*slot));
+        slot->cfg = &commands[slot_count];
+        slot->out_fd = -1;
+        slot->next_run_ms = now;
+        slot->metrics.name = slot->cfg->name;
+        slot->metrics.status = EXEC_STATUS_PENDING;
+        slot_count++;
+    }
+
+    return slot_count > 0;
+}
+
+void exec_metrics_cleanup(void) {
+    for (int i = 0; i < slot_count; i++) {
+        exec_slot_t *slot = &slots[i];
+        if (slot->out_fd >= 0) {
+            close(slot->out_fd);
+        }
+        if (slot->pid > 0) {
+            kill(-slot->pid, SIGKILL);
+            waitpid(slot->pid, NULL, 0);
+        }
+    }
+    slot_count = 0;
+}
+
+bool exec_metrics_get(exec_metrics_t *exec) {
+    uint64_t now = now_ms();
+
+    exec->count = slot_count;
+    for (int i = 0; i < slot_count; i++) {
+        exec_slot_t *slot = &slots[i];
+        poll_slot(slot, now);
+
+        /* Overdue once a run has had its full interval and timeout */
+        exec_command_metrics_t *m = &slot->metrics;
+        uint64_t age = now - slot->last_good_ms;
+        uint64_t overdue = (uint64_t)slot->cfg->interval_ms + (uint64_t)slot->cfg->timeout_ms;
+        m->age_sec = m->value_count > 0 ? (double)age / 1000.0 : 0.0;
+        m->stale = m->value_count > 0 &&
+                   ((m->status != EXEC_STATUS_OK && m->status != EXEC_STATUS_PENDING) ||
+                    age > overdue);
+        exec->commands[i] = *m;
+    }
+
+    return slot_count > 0;
+}
@@ -4,24 +4,51 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#define MAX_GPUS 16
+#define MAX_GPU_PROCESSES 8
+#define GPU_PROCESS_NAME_LEN 16
+
+/* A compute process running on a GPU */
+typedef struct {
+    int pid;
+    char name[GPU_PROCESS_NAME_LEN];    /* "?" if the PID cannot be resolved */
+    uint64_t memory_used;
+    int sm_percent;                     /* -1 if unsupported or never sampled */
+} gpu_process_t;
+
 typedef struct {
+    int index;                    /* NVML device index */
     char name[128];
-    int utilization_percent;      /* GPU core usage */
+    int utilization_percent;      /* GPU core usage, averaged since the last get */
+    int utilization_min;          /* Range of the samples since the last get */
+    int utilization_max;
+    int utilization_samples;      /* Samples behind min/avg/max, 0 if held over */
     uint64_t memory_total;
     uint64_t memory_used;
     double memory_percent;
     int temperature_celsius;      /* GPU temp */
     int power_watts;              /* Current power draw */
+    int power_limit_watts;        /* Enforced limit, -1 if unknown */
     bool available;               /* Whether GPU was detected */
+    gpu_process_t processes[MAX_GPU_PROCESSES];   /* Largest VRAM users first */
+    int process_count;
 } gpu_metrics_t;
 
-/* Initialize GPU metrics subsystem (call once at startup) */
+typedef struct {
+    gpu_metrics_t gpus[MAX_GPUS];
+    int count;
+} gpu_metrics_list_t;
+
+/* Initialize GPU metrics subsystem (call once at startup). Enumerates every
+   device, caches its name and power limit, and starts the sampler thread
+   that makes all further NVML calls. */
 bool gpu_metrics_init(void);
 
-/* Cleanup GPU metrics subsystem (call once at shutdown) */
+/* Stop the sampler thread and shut NVML down (call once at shutdown) */
 void gpu_metrics_cleanup(void);
 
-/* Get current GPU metrics, returns true if GPU available */
-bool gpu_metrics_get(gpu_metrics_t *gpu);
+/* Get current metrics for every GPU from the sampler's buffers, without
+   calling NVML. Returns true if any GPU is available. */
+bool gpu_metrics_get(gpu_metrics_list_t *list);
 
 #endif /* METRICS_GPU_H */
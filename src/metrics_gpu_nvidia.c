@@ -1,5 +1,7 @@
 #include "metrics_gpu.h"
+#include "thread_compat.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #ifdef _WIN32
@@ -11,6 +13,8 @@ typedef HMODULE lib_handle_t;
 #define FREE_LIBRARY(lib) FreeLibrary(lib)
 #else
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
 #define NVML_LIB_NAME "libnvidia-ml.so.1"
 typedef void* lib_handle_t;
 #define LOAD_LIBRARY(name) dlopen(name, RTLD_LAZY)
@@ -20,6 +24,20 @@ typedef void* lib_handle_t;
 
 /* NVML return codes */
 #define NVML_SUCCESS 0
+#define NVML_ERROR_NOT_SUPPORTED 3
+#define NVML_ERROR_NOT_FOUND 6
+#define NVML_ERROR_INSUFFICIENT_SIZE 7
+
+/* usedGpuMemory when the driver cannot attribute memory (e.g. under WDDM) */
+#define NVML_VALUE_NOT_AVAILABLE 0xFFFFFFFFFFFFFFFFULL
+
+/* NVML sample types and sample value types */
+#define NVML_GPU_UTILIZATION_SAMPLES 1
+#define NVML_VALUE_TYPE_DOUBLE 0
+#define NVML_VALUE_TYPE_UNSIGNED_INT 1
+#define NVML_VALUE_TYPE_UNSIGNED_LONG 2
+#define NVML_VALUE_TYPE_UNSIGNED_LONG_LONG 3
+#define NVML_VALUE_TYPE_SIGNED_LONG_LONG 4
 
 /* NVML temperature sensor type */
 #define NVML_TEMPERATURE_GPU 0
@@ -38,6 +56,40 @@ typedef struct {
     unsigned long long used;
 } nvmlMemory_t;
 
+typedef union {
+    double dVal;
+    unsigned int uiVal;
+    unsigned long ulVal;
+    unsigned long long ullVal;
+    signed long long sllVal;
+} nvmlValue_t;
+
+typedef struct {
+    unsigned long long timeStamp;   /* CPU timestamp in microseconds */
+    nvmlValue_t sampleValue;
+} nvmlSample_t;
+
+typedef struct {
+    unsigned int pid;
+    unsigned long long usedGpuMemory;
+    unsigned int gpuInstanceId;
+    unsigned int computeInstanceId;
+} nvmlProcessInfo_t;
+
+typedef struct {
+    unsigned int pid;
+    unsigned long long usedGpuMemory;
+} nvmlProcessInfo_v1_t;
+
+typedef struct {
+    unsigned int pid;
+    unsigned long long timeStamp;
+    unsigned int smUtil;
+    unsigned int memUtil;
+    unsigned int encUtil;
+    unsigned int decUtil;
+} nvmlProcessUtilizationSample_t;
+
 /* NVML function pointer types */
 typedef int (*nvmlInit_t)(void);
 typedef int (*nvmlShutdown_t)(void);
@@ -48,6 +100,16 @@ typedef int (*nvmlDeviceGetUtilizationRates_t)(nvmlDevice_t device, nvmlUtilizat
 typedef int (*nvmlDeviceGetMemoryInfo_t)(nvmlDevice_t device, nvmlMemory_t *memory);
 typedef int (*nvmlDeviceGetTemperature_t)(nvmlDevice_t device, int sensorType, unsigned int *temp);
 typedef int (*nvmlDeviceGetPowerUsage_t)(nvmlDevice_t device, unsigned int *power);
+typedef int (*nvmlDeviceGetEnforcedPowerLimit_t)(nvmlDevice_t device, unsigned int *limit);
+typedef int (*nvmlDeviceGetSamples_t)(nvmlDevice_t device, int type,
+                                      unsigned long long lastSeenTimeStamp, int *sampleValType,
+                                      unsigned int *sampleCount, nvmlSample_t *samples);
+typedef int (*nvmlDeviceGetComputeRunningProcesses_t)(nvmlDevice_t device, unsigned int *infoCount,
+                                                      void *infos);
+typedef int (*nvmlDeviceGetProcessUtilization_t)(nvmlDevice_t device,
+                                                 nvmlProcessUtilizationSample_t *utilization,
+                                                 unsigned int *processSamplesCount,
+                                                 unsigned long long lastSeenTimeStamp);
 
 /* NVML function pointers */
 static nvmlInit_t fn_nvmlInit = NULL;
@@ -59,34 +121,108 @@ static nvmlDeviceGetUtilizationRates_t fn_nvmlDeviceGetUtilizationRates = NULL;
 static nvmlDeviceGetMemoryInfo_t fn_nvmlDeviceGetMemoryInfo = NULL;
 static nvmlDeviceGetTemperature_t fn_nvmlDeviceGetTemperature = NULL;
 static nvmlDeviceGetPowerUsage_t fn_nvmlDeviceGetPowerUsage = NULL;
+static nvmlDeviceGetEnforcedPowerLimit_t fn_nvmlDeviceGetEnforcedPowerLimit = NULL;
+static nvmlDeviceGetSamples_t fn_nvmlDeviceGetSamples = NULL;
+static nvmlDeviceGetComputeRunningProcesses_t fn_nvmlDeviceGetComputeRunningProcesses = NULL;
+static bool compute_processes_v1 = false;   /* Older driver: nvmlProcessInfo_v1_t layout */
+static nvmlDeviceGetProcessUtilization_t fn_nvmlDeviceGetProcessUtilization = NULL;
 
 /* Library state */
 static lib_handle_t nvml_lib = NULL;
 static bool nvml_initialized = false;
-static nvmlDevice_t gpu_device = NULL;
+
+/* Sampler tuning: NVML buffers utilization samples internally, so the
+   thread drains them a few times per frame; memory, temperature and power
+   change slowly and are only read every GPU_SLOW_EVERY passes. */
+#define GPU_SAMPLE_RING 256
+#define GPU_SAMPLER_INTERVAL_MS 100
+#define GPU_SLOW_EVERY 5
+#define GPU_SAMPLE_BATCH 64
+#define GPU_PROCESS_QUERY 256   /* Processes/utilization samples fetched per pass */
+#define GPU_COMM_CACHE 64
+
+/* Per-device handle plus attributes that never change, queried once */
+typedef struct {
+    nvmlDevice_t handle;
+    int nvml_index;
+    char name[128];
+    int power_limit_watts;
+
+    /* Written by the sampler thread, read by gpu_metrics_get, under sampler_lock */
+    uint8_t ring[GPU_SAMPLE_RING];      /* Utilization percent per sample */
+    uint64_t ring_head;                 /* Samples ever pushed */
+    uint64_t memory_total;
+    uint64_t memory_used;
+    int temperature_celsius;
+    int power_watts;
+    gpu_process_t processes[MAX_GPU_PROCESSES];
+    int process_count;
+
+    /* Sampler thread only */
+    unsigned long long last_seen;       /* Newest NVML sample timestamp */
+    bool use_samples;                   /* false: poll utilization rates instead */
+    unsigned long long proc_last_seen;  /* Newest per-process utilization timestamp */
+    bool proc_util_supported;
+
+    /* gpu_metrics_get only */
+    uint64_t ring_read;
+    int last_min, last_avg, last_max;
+} gpu_device_t;
+
+static gpu_device_t devices[MAX_GPUS];
+static int device_count = 0;
+
+/* Sampler thread state */
+static thread_t sampler_thread;
+static mutex_t sampler_lock;
+static cond_t sampler_wake;
+static bool sampler_running = false;
+static bool sampler_stop = false;
+static nvmlSample_t *scratch = NULL;    /* Sampler thread only */
+static unsigned int scratch_cap = 0;
+
+/* PID to command name, so a process that stays on the GPU is resolved once.
+   An entry not seen on the previous slow pass may be a recycled PID and is
+   resolved again. Sampler thread only. */
+typedef struct {
+    int pid;
+    int last_pass;
+    char name[GPU_PROCESS_NAME_LEN];
+} comm_entry_t;
+
+static comm_entry_t comm_cache[GPU_COMM_CACHE];
 
 static bool load_nvml_functions(void) {
-    fn_nvmlInit = (nvmlInit_t)GET_PROC(nvml_lib, "nvmlInit_v2");
+    *(void **)&fn_nvmlInit = (void *)GET_PROC(nvml_lib, "nvmlInit_v2");
     if (!fn_nvmlInit) {
-        fn_nvmlInit = (nvmlInit_t)GET_PROC(nvml_lib, "nvmlInit");
+        *(void **)&fn_nvmlInit = (void *)GET_PROC(nvml_lib, "nvmlInit");
     }
 
-    fn_nvmlShutdown = (nvmlShutdown_t)GET_PROC(nvml_lib, "nvmlShutdown");
-    fn_nvmlDeviceGetCount = (nvmlDeviceGetCount_t)GET_PROC(nvml_lib, "nvmlDeviceGetCount_v2");
+    *(void **)&fn_nvmlShutdown = (void *)GET_PROC(nvml_lib, "nvmlShutdown");
+    *(void **)&fn_nvmlDeviceGetCount = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetCount_v2");
     if (!fn_nvmlDeviceGetCount) {
-        fn_nvmlDeviceGetCount = (nvmlDeviceGetCount_t)GET_PROC(nvml_lib, "nvmlDeviceGetCount");
+        *(void **)&fn_nvmlDeviceGetCount = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetCount");
     }
 
-    fn_nvmlDeviceGetHandleByIndex = (nvmlDeviceGetHandleByIndex_t)GET_PROC(nvml_lib, "nvmlDeviceGetHandleByIndex_v2");
+    *(void **)&fn_nvmlDeviceGetHandleByIndex = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetHandleByIndex_v2");
     if (!fn_nvmlDeviceGetHandleByIndex) {
-        fn_nvmlDeviceGetHandleByIndex = (nvmlDeviceGetHandleByIndex_t)GET_PROC(nvml_lib, "nvmlDeviceGetHandleByIndex");
+        *(void **)&fn_nvmlDeviceGetHandleByIndex = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetHandleByIndex");
     }
 
-    fn_nvmlDeviceGetName = (nvmlDeviceGetName_t)GET_PROC(nvml_lib, "nvmlDeviceGetName");
-    fn_nvmlDeviceGetUtilizationRates = (nvmlDeviceGetUtilizationRates_t)GET_PROC(nvml_lib, "nvmlDeviceGetUtilizationRates");
-    fn_nvmlDeviceGetMemoryInfo = (nvmlDeviceGetMemoryInfo_t)GET_PROC(nvml_lib, "nvmlDeviceGetMemoryInfo");
-    fn_nvmlDeviceGetTemperature = (nvmlDeviceGetTemperature_t)GET_PROC(nvml_lib, "nvmlDeviceGetTemperature");
-    fn_nvmlDeviceGetPowerUsage = (nvmlDeviceGetPowerUsage_t)GET_PROC(nvml_lib, "nvmlDeviceGetPowerUsage");
+    *(void **)&fn_nvmlDeviceGetName = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetName");
+    *(void **)&fn_nvmlDeviceGetUtilizationRates = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetUtilizationRates");
+    *(void **)&fn_nvmlDeviceGetMemoryInfo = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetMemoryInfo");
+    *(void **)&fn_nvmlDeviceGetTemperature = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetTemperature");
+    *(void **)&fn_nvmlDeviceGetPowerUsage = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetPowerUsage");
+    *(void **)&fn_nvmlDeviceGetEnforcedPowerLimit = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetEnforcedPowerLimit");
+    *(void **)&fn_nvmlDeviceGetSamples = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetSamples");
+    *(void **)&fn_nvmlDeviceGetComputeRunningProcesses = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetComputeRunningProcesses_v2");
+    compute_processes_v1 = false;
+    if (!fn_nvmlDeviceGetComputeRunningProcesses) {
+        *(void **)&fn_nvmlDeviceGetComputeRunningProcesses = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetComputeRunningProcesses");
+        compute_processes_v1 = fn_nvmlDeviceGetComputeRunningProcesses != NULL;
+    }
+    *(void **)&fn_nvmlDeviceGetProcessUtilization = (void *)GET_PROC(nvml_lib, "nvmlDeviceGetProcessUtilization");
 
     /* Check required functions are loaded */
     return (fn_nvmlInit != NULL &&
@@ -95,6 +231,336 @@ static bool load_nvml_functions(void) {
             fn_nvmlDeviceGetHandleByIndex != NULL);
 }
 
+static int sample_percent(int type, nvmlValue_t v) {
+    switch (type) {
+        case NVML_VALUE_TYPE_DOUBLE:             return (int)(v.dVal + 0.5);
+        case NVML_VALUE_TYPE_UNSIGNED_LONG:      return (int)v.ulVal;
+        case NVML_VALUE_TYPE_UNSIGNED_LONG_LONG: return (int)v.ullVal;
+        case NVML_VALUE_TYPE_SIGNED_LONG_LONG:   return (int)v.sllVal;
+        default:                                 return (int)v.uiVal;
+    }
+}
+
+static void push_sample(gpu_device_t *dev, int percent) {
+    if (percent < 0) percent = 0;
+    if (percent > 100) percent = 100;
+    dev->ring[dev->ring_head % GPU_SAMPLE_RING] = (uint8_t)percent;
+    dev->ring_head++;
+}
+
+/* Fetch utilization samples newer than last_seen into scratch, growing it
+   when NVML has more buffered than fits. Returns the number fetched, or -1
+   if the device does not support sample queries. */
+static int fetch_samples(gpu_device_t *dev, int *type) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        unsigned int count = scratch_cap;
+        int ret = fn_nvmlDeviceGetSamples(dev->handle, NVML_GPU_UTILIZATION_SAMPLES,
+                                          dev->last_seen, type, &count, scratch);
+        if (ret == NVML_SUCCESS) {
+            return (int)count;
+        }
+        if (ret == NVML_ERROR_NOT_SUPPORTED) {
+            return -1;
+        }
+        if (ret != NVML_ERROR_INSUFFICIENT_SIZE) {
+            return 0;   /* NOT_FOUND: nothing new; anything else: retry next pass */
+        }
+
+        /* A NULL buffer asks for the number of samples available */
+        count = 0;
+        if (fn_nvmlDeviceGetSamples(dev->handle, NVML_GPU_UTILIZATION_SAMPLES,
+                                    dev->last_seen, type, &count, NULL) != NVML_SUCCESS ||
+            count <= scratch_cap) {
+            return 0;
+        }
+        nvmlSample_t *grown = realloc(scratch, count * sizeof(nvmlSample_t));
+        if (!grown) {
+            return 0;
+        }
+        scratch = grown;
+        scratch_cap = count;
+    }
+    return 0;
+}
+
+static void read_comm(int pid, char *name, size_t size) {
+    snprintf(name, size, "?");
+#ifdef _WIN32
+    HANDLE proc = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, (DWORD)pid);
+    if (!proc) {
+        return;
+    }
+    char path[MAX_PATH];
+    DWORD len = sizeof(path);
+    if (QueryFullProcessImageNameA(proc, 0, path, &len)) {
+        const char *base = strrchr(path, '\\');
+        snprintf(name, size, "%s", base ? base + 1 : path);
+    }
+    CloseHandle(proc);
+#else
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%d/comm", pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;     /* Gone, or in another PID namespace */
+    }
+    char buf[GPU_PROCESS_NAME_LEN];
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n > 0 && buf[n - 1] == '\n') n--;
+    if (n > 0) {
+        buf[n] = '\0';
+        snprintf(name, size, "%s", buf);
+    }
+#endif
+}
+
+static void lookup_comm(int pid, int pass, char *name, size_t size) {
+    comm_entry_t *victim = &comm_cache[0];
+
+    for (int i = 0; i < GPU_COMM_CACHE; i++) {
+        comm_entry_t *e = &comm_cache[i];
+        if (e->pid == pid && e->last_pass >= pass - GPU_SLOW_EVERY) {
+            e->last_pass = pass;
+            snprintf(name, size, "%s", e->name);
+            return;
+        }
+        if (e->pid == 0 || e->last_pass < victim->last_pass) {
+            victim = e;
+            if (e->pid == 0) break;
+        }
+    }
+
+    read_comm(pid, name, size);
+    victim->pid = pid;
+    victim->last_pass = pass;
+    snprintf(victim->name, sizeof(victim->name), "%s", name);
+}
+
+static int compare_process_memory(const void *a, const void *b) {
+    const gpu_process_t *x = a, *y = b;
+    return (x->memory_used < y->memory_used) - (x->memory_used > y->memory_used);
+}
+
+/* SM usage last published for pid, -1 if it never had a sample. Only the
+   sampler thread writes dev->processes, so it reads them without the lock. */
+static int last_sm_percent(const gpu_device_t *dev, int pid) {
+    for (int i = 0; i < dev->process_count; i++) {
+        if (dev->processes[i].pid == pid) {
+            return dev->processes[i].sm_percent;
+        }
+    }
+    return -1;
+}
+
+/* Collect the device's compute processes with their VRAM and SM usage,
+   largest VRAM users first. Returns the number stored in out. */
+static int query_processes(gpu_device_t *dev, int pass, gpu_process_t *out) {
+    static nvmlProcessInfo_t infos[GPU_PROCESS_QUERY];
+    static nvmlProcessUtilizationSample_t util[GPU_PROCESS_QUERY];
+    static gpu_process_t found[GPU_PROCESS_QUERY];
+
+    if (!fn_nvmlDeviceGetComputeRunningProcesses) {
+        return 0;
+    }
+
+    unsigned int count = GPU_PROCESS_QUERY;
+    if (fn_nvmlDeviceGetComputeRunningProcesses(dev->handle, &count, infos) != NVML_SUCCESS) {
+        return 0;   /* INSUFFICIENT_SIZE too: more processes than we track */
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+        unsigned long long used;
+        if (compute_processes_v1) {
+            const nvmlProcessInfo_v1_t *v1 = (const nvmlProcessInfo_v1_t *)infos + i;
+            found[i].pid = (int)v1->pid;
+            used = v1->usedGpuMemory;
+        } else {
+            found[i].pid = (int)infos[i].pid;
+            used = infos[i].usedGpuMemory;
+        }
+        found[i].memory_used = used == NVML_VALUE_NOT_AVAILABLE ? 0 : used;
+        found[i].sm_percent = dev->proc_util_supported ? last_sm_percent(dev, found[i].pid) : -1;
+    }
+
+    /* Utilization samples since the previous pass; keep each PID's newest.
+       A PID without one keeps the value it last had. */
+    unsigned int samples = GPU_PROCESS_QUERY;
+    if (dev->proc_util_supported && count > 0) {
+        int ret = fn_nvmlDeviceGetProcessUtilization(dev->handle, util, &samples,
+                                                     dev->proc_last_seen);
+        if (ret == NVML_ERROR_NOT_SUPPORTED) {
+            dev->proc_util_supported = false;
+        }
+        if (ret != NVML_SUCCESS) {
+            samples = 0;
+        }
+        unsigned long long newest = dev->proc_last_seen;
+        for (unsigned int s = 0; s < samples; s++) {
+            for (unsigned int i = 0; i < count; i++) {
+                if ((unsigned int)found[i].pid == util[s].pid) {
+                    found[i].sm_percent = (int)util[s].smUtil;
+                }
+            }
+            if (util[s].timeStamp > newest) newest = util[s].timeStamp;
+        }
+        dev->proc_last_seen = newest;
+    }
+
+    qsort(found, count, sizeof(gpu_process_t), compare_process_memory);
+
+    int n = count < MAX_GPU_PROCESSES ? (int)count : MAX_GPU_PROCESSES;
+    for (int i = 0; i < n; i++) {
+        out[i] = found[i];
+        lookup_comm(out[i].pid, pass, out[i].name, sizeof(out[i].name));
+    }
+    return n;
+}
+
+/* One sampler pass over a device. NVML is called without the lock held so
+   a slow driver call never blocks the render thread. */
+static void sample_device(gpu_device_t *dev, int pass) {
+    bool slow = pass % GPU_SLOW_EVERY == 0;
+    int type = NVML_VALUE_TYPE_UNSIGNED_INT;
+    int fetched = 0;
+    int rate = -1;
+
+    if (dev->use_samples) {
+        fetched = fetch_samples(dev, &type);
+        if (fetched < 0) {
+            dev->use_samples = false;
+            fetched = 0;
+        }
+    }
+    if (!dev->use_samples && fn_nvmlDeviceGetUtilizationRates) {
+        nvmlUtilization_t util;
+        if (fn_nvmlDeviceGetUtilizationRates(dev->handle, &util) == NVML_SUCCESS) {
+            rate = (int)util.gpu;
+        }
+    }
+
+    nvmlMemory_t mem = {0, 0, 0};
+    bool have_mem = false;
+    unsigned int temp = 0, power_mw = 0;
+    bool have_temp = false, have_power = false;
+    gpu_process_t procs[MAX_GPU_PROCESSES];
+    int proc_count = 0;
+
+    if (slow) {
+        have_mem = fn_nvmlDeviceGetMemoryInfo &&
+                   fn_nvmlDeviceGetMemoryInfo(dev->handle, &mem) == NVML_SUCCESS;
+        have_temp = fn_nvmlDeviceGetTemperature &&
+                    fn_nvmlDeviceGetTemperature(dev->handle, NVML_TEMPERATURE_GPU,
+                                                &temp) == NVML_SUCCESS;
+        have_power = fn_nvmlDeviceGetPowerUsage &&
+                     fn_nvmlDeviceGetPowerUsage(dev->handle, &power_mw) == NVML_SUCCESS;
+        proc_count = query_processes(dev, pass, procs);
+    }
+
+    mutex_lock(&sampler_lock);
+    for (int i = 0; i < fetched; i++) {
+        push_sample(dev, sample_percent(type, scratch[i].sampleValue));
+        if (scratch[i].timeStamp > dev->last_seen) {
+            dev->last_seen = scratch[i].timeStamp;
+        }
+    }
+    if (rate >= 0) {
+        push_sample(dev, rate);
+    }
+    if (slow) {
+        if (have_mem) {
+            dev->memory_total = mem.total;
+            dev->memory_used = mem.used;
+        }
+        dev->temperature_celsius = have_temp ? (int)temp : -1;
+        /* Power is returned in milliwatts */
+        dev->power_watts = have_power ? (int)(power_mw / 1000) : -1;
+        memcpy(dev->processes, procs, (size_t)proc_count * sizeof(gpu_process_t));
+        dev->process_count = proc_count;
+    }
+    mutex_unlock(&sampler_lock);
+}
+
+static THREAD_FUNC(sampler_main, arg) {
+    (void)arg;
+    int pass = 0;
+
+    mutex_lock(&sampler_lock);
+    while (!sampler_stop) {
+        mutex_unlock(&sampler_lock);
+        for (int i = 0; i < device_count; i++) {
+            sample_device(&devices[i], pass);
+        }
+        pass++;
+        mutex_lock(&sampler_lock);
+        if (!sampler_stop) {
+            cond_wait_ms(&sampler_wake, &sampler_lock, GPU_SAMPLER_INTERVAL_MS);
+        }
+    }
+    mutex_unlock(&sampler_lock);
+
+    THREAD_RETURN;
+}
+
+static bool start_sampler(void) {
+    for (int i = 0; i < device_count; i++) {
+        gpu_device_t *dev = &devices[i];
+        dev->ring_head = 0;
+        dev->ring_read = 0;
+        dev->memory_total = 0;
+        dev->memory_used = 0;
+        dev->temperature_celsius = -1;
+        dev->power_watts = -1;
+        dev->last_seen = 0;
+        dev->use_samples = fn_nvmlDeviceGetSamples != NULL;
+        dev->process_count = 0;
+        dev->proc_last_seen = 0;
+        dev->proc_util_supported = fn_nvmlDeviceGetProcessUtilization != NULL;
+        dev->last_min = dev->last_avg = dev->last_max = 0;
+    }
+
+    memset(comm_cache, 0, sizeof(comm_cache));
+
+    scratch = malloc(GPU_SAMPLE_BATCH * sizeof(nvmlSample_t));
+    if (!scratch) {
+        return false;
+    }
+    scratch_cap = GPU_SAMPLE_BATCH;
+
+    mutex_init(&sampler_lock);
+    cond_init(&sampler_wake);
+    sampler_stop = false;
+    if (!thread_start(&sampler_thread, sampler_main, NULL)) {
+        cond_destroy(&sampler_wake);
+        mutex_destroy(&sampler_lock);
+        free(scratch);
+        scratch = NULL;
+        return false;
+    }
+
+    sampler_running = true;
+    return true;
+}
+
+static void stop_sampler(void) {
+    if (!sampler_running) {
+        return;
+    }
+
+    mutex_lock(&sampler_lock);
+    sampler_stop = true;
+    cond_signal(&sampler_wake);
+    mutex_unlock(&sampler_lock);
+    thread_join(sampler_thread);
+
+    cond_destroy(&sampler_wake);
+    mutex_destroy(&sampler_lock);
+    free(scratch);
+    scratch = NULL;
+    scratch_cap = 0;
+    sampler_running = false;
+}
+
 bool gpu_metrics_init(void) {
     /* Try to load NVML library */
     nvml_lib = LOAD_LIBRARY(NVML_LIB_NAME);
@@ -136,16 +602,41 @@ bool gpu_metrics_init(void) {
     }
 
     /* Get device count */
-    unsigned int device_count = 0;
-    if (fn_nvmlDeviceGetCount(&device_count) != NVML_SUCCESS || device_count == 0) {
+    unsigned int nvml_count = 0;
+    if (fn_nvmlDeviceGetCount(&nvml_count) != NVML_SUCCESS || nvml_count == 0) {
         fn_nvmlShutdown();
         FREE_LIBRARY(nvml_lib);
         nvml_lib = NULL;
         return false;
     }
 
-    /* Get handle to first GPU */
-    if (fn_nvmlDeviceGetHandleByIndex(0, &gpu_device) != NVML_SUCCESS) {
+    /* Get a handle to every GPU and cache what never changes */
+    device_count = 0;
+    for (unsigned int i = 0; i < nvml_count && device_count < MAX_GPUS; i++) {
+        gpu_device_t *dev = &devices[device_count];
+        if (fn_nvmlDeviceGetHandleByIndex(i, &dev->handle) != NVML_SUCCESS) {
+            continue;   /* e.g. a device without permission; skip it */
+        }
+        dev->nvml_index = (int)i;
+
+        if (!fn_nvmlDeviceGetName ||
+            fn_nvmlDeviceGetName(dev->handle, dev->name, sizeof(dev->name)) != NVML_SUCCESS) {
+            strncpy(dev->name, "NVIDIA GPU", sizeof(dev->name) - 1);
+        }
+        dev->name[sizeof(dev->name) - 1] = '\0';
+
+        unsigned int limit_mw;
+        dev->power_limit_watts = -1;
+        if (fn_nvmlDeviceGetEnforcedPowerLimit &&
+            fn_nvmlDeviceGetEnforcedPowerLimit(dev->handle, &limit_mw) == NVML_SUCCESS) {
+            dev->power_limit_watts = (int)(limit_mw / 1000);
+        }
+
+        device_count++;
+    }
+
+    if (device_count == 0 || !start_sampler()) {
+        device_count = 0;
         fn_nvmlShutdown();
         FREE_LIBRARY(nvml_lib);
         nvml_lib = NULL;
@@ -157,6 +648,9 @@ bool gpu_metrics_init(void) {
 }
 
 void gpu_metrics_cleanup(void) {
+    /* The sampler must be gone before NVML is */
+    stop_sampler();
+
     if (nvml_initialized && fn_nvmlShutdown) {
         fn_nvmlShutdown();
     }
@@ -167,66 +661,64 @@ void gpu_metrics_cleanup(void) {
     }
 
     nvml_initialized = false;
-    gpu_device = NULL;
+    device_count = 0;
 }
 
-bool gpu_metrics_get(gpu_metrics_t *gpu) {
+/* Fill one device's metrics from the sampler's buffers. Utilization is
+   summarised over the samples pushed since the previous call; when none
+   arrived the previous summary is held. Called with sampler_lock held. */
+static void read_device(gpu_device_t *dev, gpu_metrics_t *gpu) {
     memset(gpu, 0, sizeof(gpu_metrics_t));
-    gpu->temperature_celsius = -1;
-    gpu->power_watts = -1;
-
-    if (!nvml_initialized || !gpu_device) {
-        gpu->available = false;
-        return false;
-    }
-
+    gpu->index = dev->nvml_index;
+    gpu->power_limit_watts = dev->power_limit_watts;
     gpu->available = true;
+    memcpy(gpu->name, dev->name, sizeof(gpu->name));
 
-    /* Get GPU name */
-    if (fn_nvmlDeviceGetName) {
-        if (fn_nvmlDeviceGetName(gpu_device, gpu->name, sizeof(gpu->name)) != NVML_SUCCESS) {
-            strncpy(gpu->name, "NVIDIA GPU", sizeof(gpu->name) - 1);
-        }
-    } else {
-        strncpy(gpu->name, "NVIDIA GPU", sizeof(gpu->name) - 1);
+    uint64_t fresh = dev->ring_head - dev->ring_read;
+    if (fresh > GPU_SAMPLE_RING) {
+        fresh = GPU_SAMPLE_RING;    /* The oldest were overwritten */
     }
-    gpu->name[sizeof(gpu->name) - 1] = '\0';
-
-    /* Get utilization */
-    if (fn_nvmlDeviceGetUtilizationRates) {
-        nvmlUtilization_t util;
-        if (fn_nvmlDeviceGetUtilizationRates(gpu_device, &util) == NVML_SUCCESS) {
-            gpu->utilization_percent = (int)util.gpu;
+    if (fresh > 0) {
+        int lo = 100, hi = 0, sum = 0;
+        for (uint64_t seq = dev->ring_head - fresh; seq < dev->ring_head; seq++) {
+            int v = dev->ring[seq % GPU_SAMPLE_RING];
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+            sum += v;
         }
+        dev->last_min = lo;
+        dev->last_max = hi;
+        dev->last_avg = (sum + (int)fresh / 2) / (int)fresh;
+        dev->ring_read = dev->ring_head;
     }
-
-    /* Get memory info */
-    if (fn_nvmlDeviceGetMemoryInfo) {
-        nvmlMemory_t mem;
-        if (fn_nvmlDeviceGetMemoryInfo(gpu_device, &mem) == NVML_SUCCESS) {
-            gpu->memory_total = mem.total;
-            gpu->memory_used = mem.used;
-            if (mem.total > 0) {
-                gpu->memory_percent = (double)mem.used / mem.total * 100.0;
-            }
-        }
+    gpu->utilization_percent = dev->last_avg;
+    gpu->utilization_min = dev->last_min;
+    gpu->utilization_max = dev->last_max;
+    gpu->utilization_samples = (int)fresh;
+
+    gpu->memory_total = dev->memory_total;
+    gpu->memory_used = dev->memory_used;
+    if (dev->memory_total > 0) {
+        gpu->memory_percent = (double)dev->memory_used / dev->memory_total * 100.0;
     }
+    gpu->temperature_celsius = dev->temperature_celsius;
+    gpu->power_watts = dev->power_watts;
+    memcpy(gpu->processes, dev->processes, (size_t)dev->process_count * sizeof(gpu_process_t));
+    gpu->process_count = dev->process_count;
+}
 
-    /* Get temperature */
-    if (fn_nvmlDeviceGetTemperature) {
-        unsigned int temp;
-        if (fn_nvmlDeviceGetTemperature(gpu_device, NVML_TEMPERATURE_GPU, &temp) == NVML_SUCCESS) {
-            gpu->temperature_celsius = (int)temp;
-        }
+bool gpu_metrics_get(gpu_metrics_list_t *list) {
+    list->count = 0;
+
+    if (!nvml_initialized) {
+        return false;
     }
 
-    /* Get power usage (returned in milliwatts, convert to watts) */
-    if (fn_nvmlDeviceGetPowerUsage) {
-        unsigned int power_mw;
-        if (fn_nvmlDeviceGetPowerUsage(gpu_device, &power_mw) == NVML_SUCCESS) {
-            gpu->power_watts = (int)(power_mw / 1000);
-        }
+    mutex_lock(&sampler_lock);
+    for (int i = 0; i < device_count; i++) {
+        read_device(&devices[i], &list->gpus[list->count++]);
     }
+    mutex_unlock(&sampler_lock);
 
-    return true;
+    return list->count > 0;
 }
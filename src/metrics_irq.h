@@ -0,0 +1,55 @@
+#ifndef METRICS_IRQ_H
+#define METRICS_IRQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "metrics.h"
+
+#define IRQ_SOURCE_LEN 32
+
+/* A CPU is flagged when its rate exceeds IRQ_HOT_FACTOR times the mean
+   across CPUs and the per-vector floor below */
+#define IRQ_HOT_FACTOR 2.0f
+#define IRQ_HOT_FLOOR_HARD 500.0f
+#define IRQ_HOT_FLOOR_SOFT 2000.0f
+
+/* Bits in irq_metrics_t.hot */
+#define IRQ_HOT_HARD 0x1
+#define IRQ_HOT_SOFT 0x2
+
+/* Per-CPU vectors are indexed by CPU number */
+typedef struct {
+    int cpu_count;                        /* Highest CPU number seen + 1 */
+    float hardirq_rate[MAX_CPU_CORES];    /* Device interrupts per second */
+    float softirq_rate[MAX_CPU_CORES];    /* All softirqs per second */
+    float net_rx_rate[MAX_CPU_CORES];     /* NET_RX part of softirq_rate */
+    uint8_t hot[MAX_CPU_CORES];           /* IRQ_HOT_* */
+    int hot_count;                        /* CPUs with any hot bit */
+    double hardirq_total;                 /* Per second, all CPUs */
+    double softirq_total;
+    double net_rx_total;
+    double ctxt_rate;                     /* Context switches per second */
+    double intr_rate;                     /* All interrupts per second (/proc/stat) */
+    char top_source[IRQ_SOURCE_LEN];      /* Busiest device IRQ, "" if none */
+    double top_source_rate;
+} irq_metrics_t;
+
+/* Open interrupts, softirqs and stat under proc_root (NULL for "/proc")
+   and take the baseline sample */
+bool irq_metrics_init(const char *proc_root);
+
+/* Close the files (call once at shutdown) */
+void irq_metrics_cleanup(void);
+
+/* Rates since the previous call */
+bool irq_metrics_get(irq_metrics_t *irq);
+
+/* Per-second rates from two counter rows (exposed for testing) */
+void irq_rates_compute(const uint64_t *prev, const uint64_t *cur, int count,
+                       float per_second, float *out);
+
+/* Set flag in hot[] for CPUs over IRQ_HOT_FACTOR x mean and floor;
+   returns how many were flagged (exposed for testing) */
+int irq_find_hot(const float *rates, int count, float floor, uint8_t flag, uint8_t *hot);
+
+#endif /* METRICS_IRQ_H */
@@ -0,0 +1,374 @@
+#include "metrics_irq.h"
+#include "procfs.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Initial buffer sizes; procfs_read grows them on large machines */
+#define INTERRUPTS_BUF_SIZE 65536
+#define SOFTIRQS_BUF_SIZE 16384
+#define STAT_BUF_SIZE 16384
+#define MAX_IRQ_SOURCES 1024
+#define IRQ_KEY_LEN 12
+
+static procfs_file_t interrupts_file = PROCFS_FILE_INIT;
+static procfs_file_t softirqs_file = PROCFS_FILE_INIT;
+static procfs_file_t stat_file = PROCFS_FILE_INIT;
+
+/* Cumulative per-CPU counters as wide rows, one per vector */
+typedef struct {
+    uint64_t hard[MAX_CPU_CORES];
+    uint64_t soft[MAX_CPU_CORES];
+    uint64_t net_rx[MAX_CPU_CORES];
+    uint64_t ctxt;
+    uint64_t intr;
+    double when;        /* CLOCK_MONOTONIC seconds */
+    int cpu_count;
+} irq_sample_t;
+
+/* Per-line totals, to find the busiest device IRQ */
+typedef struct {
+    char key[IRQ_KEY_LEN];          /* IRQ number */
+    char name[IRQ_SOURCE_LEN];
+    uint64_t total;
+} irq_source_t;
+
+typedef struct {
+    irq_source_t rows[MAX_IRQ_SOURCES];
+    int count;
+} irq_source_list_t;
+
+static irq_sample_t samples[2];
+static irq_source_list_t sources[2];
+static int cur = 0;
+static bool initialized = false;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Map the "CPU0 CPU1 ..." header to CPU numbers; only online (interrupts)
+   or possible (softirqs) CPUs get a column */
+static const char *parse_header(const char *p, const char *end, int *cols, int *col_count) {
+    *col_count = 0;
+    while (p < end && *p != '\n') {
+        p = procfs_skip_blanks(p, end);
+        uint64_t id;
+        if (procfs_has_prefix(p, end, "CPU") && procfs_parse_u64(p + 3, end, &id) &&
+            id < MAX_CPU_CORES && *col_count < MAX_CPU_CORES) {
+            cols[(*col_count)++] = (int)id;
+        }
+        while (p < end && *p != ' ' && *p != '\n') p++;
+    }
+    return procfs_next_line(p, end);
+}
+
+static int highest_cpu(const int *cols, int col_count) {
+    int n = 0;
+    for (int i = 0; i < col_count; i++) {
+        if (cols[i] + 1 > n) n = cols[i] + 1;
+    }
+    return n;
+}
+
+/* Read one row's per-CPU values into row[cpu] (zeroed first). Rows such
+   as "ERR:" carry fewer values than there are columns. */
+static const char *parse_row_values(const char *p, const char *end, const int *cols,
+                                    int col_count, uint64_t *row) {
+    for (int c = 0; c < col_count; c++) {
+        const char *next = procfs_parse_u64(p, end, &row[cols[c]]);
+        if (!next) break;
+        p = next;
+    }
+    return p;
+}
+
+/* Last whitespace-separated token before the end of the line, which for
+   device IRQs is the handler name (e.g. "eth0-TxRx-0") */
+static void last_token(const char *p, const char *end, char *out, size_t size) {
+    const char *eol = p;
+    while (eol < end && *eol != '\n') eol++;
+    const char *tok_end = eol;
+    while (tok_end > p && (tok_end[-1] == ' ' || tok_end[-1] == '\t')) tok_end--;
+    const char *tok = tok_end;
+    while (tok > p && tok[-1] != ' ' && tok[-1] != '\t') tok--;
+    snprintf(out, size, "%.*s", (int)(tok_end - tok), tok);
+}
+
+/* Wide adds over the CPU columns; kept separate so the loop vectorizes */
+static void add_row(uint64_t *restrict dst, const uint64_t *restrict row, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] += row[i];
+    }
+}
+
+static uint64_t sum_row(const uint64_t *row, int count) {
+    uint64_t total = 0;
+    for (int i = 0; i < count; i++) {
+        total += row[i];
+    }
+    return total;
+}
+
+/* /proc/interrupts: only numbered (device) IRQs count towards the
+   hardirq vector. Architecture rows such as LOC or RES fire on every CPU
+   and would hide a device IRQ pinned to one core. */
+static bool parse_interrupts(irq_sample_t *s, irq_source_list_t *list) {
+    static uint64_t row[MAX_CPU_CORES];
+    int cols[MAX_CPU_CORES], col_count;
+
+    if (!procfs_read(&interrupts_file)) {
+        return false;
+    }
+    const char *p = interrupts_file.buf;
+    const char *end = p + interrupts_file.len;
+
+    p = parse_header(p, end, cols, &col_count);
+    if (col_count == 0) {
+        return false;
+    }
+    int width = highest_cpu(cols, col_count);
+    if (width > s->cpu_count) s->cpu_count = width;
+
+    list->count = 0;
+    while (p < end) {
+        p = procfs_skip_blanks(p, end);
+        const char *key = p;
+        while (p < end && *p != ':' && *p != '\n') p++;
+        if (p >= end || *p != ':') {
+            p = procfs_next_line(p, end);
+            continue;
+        }
+        size_t key_len = (size_t)(p - key);
+        bool device = key_len > 0 && key[0] >= '0' && key[0] <= '9';
+        p++;
+
+        if (!device) {
+            p = procfs_next_line(p, end);
+            continue;
+        }
+
+        memset(row, 0, (size_t)width * sizeof(uint64_t));
+        p = parse_row_values(p, end, cols, col_count, row);
+        add_row(s->hard, row, width);
+
+        if (list->count < MAX_IRQ_SOURCES) {
+            irq_source_t *src = &list->rows[list->count++];
+            snprintf(src->key, sizeof(src->key), "%.*s", (int)key_len, key);
+            last_token(p, end, src->name, sizeof(src->name));
+            src->total = sum_row(row, width);
+        }
+        p = procfs_next_line(p, end);
+    }
+    return true;
+}
+
+static bool parse_softirqs(irq_sample_t *s) {
+    static uint64_t row[MAX_CPU_CORES];
+    int cols[MAX_CPU_CORES], col_count;
+
+    if (!procfs_read(&softirqs_file)) {
+        return false;
+    }
+    const char *p = softirqs_file.buf;
+    const char *end = p + softirqs_file.len;
+
+    p = parse_header(p, end, cols, &col_count);
+    if (col_count == 0) {
+        return false;
+    }
+    int width = highest_cpu(cols, col_count);
+    if (width > s->cpu_count) s->cpu_count = width;
+
+    while (p < end) {
+        p = procfs_skip_blanks(p, end);
+        bool net_rx = procfs_has_prefix(p, end, "NET_RX:");
+        while (p < end && *p != ':' && *p != '\n') p++;
+        if (p < end && *p == ':') {
+            memset(row, 0, (size_t)width * sizeof(uint64_t));
+            p = parse_row_values(p + 1, end, cols, col_count, row);
+            add_row(s->soft, row, width);
+            if (net_rx) {
+                add_row(s->net_rx, row, width);
+            }
+        }
+        p = procfs_next_line(p, end);
+    }
+    return true;
+}
+
+static bool parse_stat(irq_sample_t *s) {
+    if (!procfs_read(&stat_file)) {
+        return false;
+    }
+    const char *p = stat_file.buf;
+    const char *end = p + stat_file.len;
+    int found = 0;
+
+    while (p < end && found < 2) {
+        if (procfs_has_prefix(p, end, "intr ") && procfs_parse_u64(p + 5, end, &s->intr)) {
+            found++;
+        } else if (procfs_has_prefix(p, end, "ctxt ") &&
+                   procfs_parse_u64(p + 5, end, &s->ctxt)) {
+            found++;
+        }
+        p = procfs_next_line(p, end);
+    }
+    return found == 2;
+}
+
+static bool take_sample(irq_sample_t *s, irq_source_list_t *list) {
+    memset(s, 0, sizeof(*s));
+    s->when = now_seconds();
+    bool ok = parse_interrupts(s, list);
+    ok = parse_softirqs(s) && ok;
+    ok = parse_stat(s) && ok;
+    return ok;
+}
+
+void irq_rates_compute(const uint64_t *restrict prev, const uint64_t *restrict cur_row,
+                       int count, float per_second, float *restrict out) {
+    /* Same narrowing as cpu_cores_compute: per-interval deltas fit in 32
+       bits, which keeps the loop in 32-bit lanes. Counters that went
+       backwards (a CPU came back online) clamp to zero. */
+    for (int i = 0; i < count; i++) {
+        int32_t d = (int32_t)(cur_row[i] - prev[i]);
+        d = d > 0 ? d : 0;
+        out[i] = (float)d * per_second;
+    }
+}
+
+int irq_find_hot(const float *rates, int count, float floor, uint8_t flag, uint8_t *hot) {
+    if (count < 2) {
+        return 0;
+    }
+
+    float sum = 0.0f;
+    for (int i = 0; i < count; i++) {
+        sum += rates[i];
+    }
+    float limit = IRQ_HOT_FACTOR * sum / (float)count;
+    if (limit < floor) limit = floor;
+
+    int flagged = 0;
+    for (int i = 0; i < count; i++) {
+        if (rates[i] > limit) {
+            hot[i] |= flag;
+            flagged++;
+        }
+    }
+    return flagged;
+}
+
+/* Busiest device IRQ line; rows usually keep their order between samples */
+static void find_top_source(const irq_source_list_t *prev, const irq_source_list_t *now,
+                            double per_second, irq_metrics_t *irq) {
+    irq->top_source[0] = '\0';
+    irq->top_source_rate = 0.0;
+
+    for (int i = 0; i < now->count; i++) {
+        const irq_source_t *row = &now->rows[i];
+        const irq_source_t *old = NULL;
+        if (i < prev->count && strcmp(prev->rows[i].key, row->key) == 0) {
+            old = &prev->rows[i];
+        } else {
+            for (int j = 0; j < prev->count; j++) {
+                if (strcmp(prev->rows[j].key, row->key) == 0) {
+                    old = &prev->rows[j];
+                    break;
+                }
+            }
+        }
+        if (!old || row->total < old->total) continue;
+
+        double rate = (double)(row->total - old->total) * per_second;
+        if (rate > irq->top_source_rate) {
+            irq->top_source_rate = rate;
+            snprintf(irq->top_source, sizeof(irq->top_source), "%s", row->name);
+        }
+    }
+}
+
+static double sum_rates(const float *rates, int count) {
+    double total = 0.0;
+    for (int i = 0; i < count; i++) {
+        total += rates[i];
+    }
+    return total;
+}
+
+bool irq_metrics_init(const char *proc_root) {
+    irq_metrics_cleanup();
+
+    const char *root = proc_root ? proc_root : "/proc";
+    char path[MAX_PATH_LEN];
+
+    snprintf(path, sizeof(path), "%s/interrupts", root);
+    bool ok = procfs_open(&interrupts_file, path, INTERRUPTS_BUF_SIZE);
+    snprintf(path, sizeof(path), "%s/softirqs", root);
+    ok = ok && procfs_open(&softirqs_file, path, SOFTIRQS_BUF_SIZE);
+    snprintf(path, sizeof(path), "%s/stat", root);
+    ok = ok && procfs_open(&stat_file, path, STAT_BUF_SIZE);
+
+    cur = 0;
+    if (!ok || !take_sample(&samples[cur], &sources[cur])) {
+        irq_metrics_cleanup();
+        return false;
+    }
+    procfs_batch_add(&interrupts_file);
+    procfs_batch_add(&softirqs_file);
+    procfs_batch_add(&stat_file);
+
+    initialized = true;
+    return true;
+}
+
+void irq_metrics_cleanup(void) {
+    procfs_close(&interrupts_file);
+    procfs_close(&softirqs_file);
+    procfs_close(&stat_file);
+    initialized = false;
+}
+
+bool irq_metrics_get(irq_metrics_t *irq) {
+    if (!initialized) {
+        return false;
+    }
+
+    int prev = cur;
+    cur ^= 1;
+    if (!take_sample(&samples[cur], &sources[cur])) {
+        cur = prev;
+        return false;
+    }
+
+    const irq_sample_t *a = &samples[prev];
+    const irq_sample_t *b = &samples[cur];
+    double elapsed = b->when - a->when;
+    float per_second = elapsed > 0.0 ? (float)(1.0 / elapsed) : 0.0f;
+    int count = b->cpu_count;
+
+    irq->cpu_count = count;
+    irq_rates_compute(a->hard, b->hard, count, per_second, irq->hardirq_rate);
+    irq_rates_compute(a->soft, b->soft, count, per_second, irq->softirq_rate);
+    irq_rates_compute(a->net_rx, b->net_rx, count, per_second, irq->net_rx_rate);
+
+    irq->hardirq_total = sum_rates(irq->hardirq_rate, count);
+    irq->softirq_total = sum_rates(irq->softirq_rate, count);
+    irq->net_rx_total = sum_rates(irq->net_rx_rate, count);
+    irq->ctxt_rate = b->ctxt >= a->ctxt ? (double)(b->ctxt - a->ctxt) * per_second : 0.0;
+    irq->intr_rate = b->intr >= a->intr ? (double)(b->intr - a->intr) * per_second : 0.0;
+
+    memset(irq->hot, 0, (size_t)count);
+    irq_find_hot(irq->hardirq_rate, count, IRQ_HOT_FLOOR_HARD, IRQ_HOT_HARD, irq->hot);
+    irq_find_hot(irq->softirq_rate, count, IRQ_HOT_FLOOR_SOFT, IRQ_HOT_SOFT, irq->hot);
+    irq->hot_count = 0;
+    for (int i = 0; i < count; i++) {
+        irq->hot_count += irq->hot[i] != 0;
+    }
+
+    find_top_source(&sources[prev], &sources[cur], per_second, irq);
+    return true;
+}
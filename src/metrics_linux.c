@@ -0,0 +1,260 @@
+#include "metrics.h"
+#include "cpu_cores.h"
+#include "meminfo.h"
+#include "procfs.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/statvfs.h>
+
+/* Initial buffer sizes; procfs_read grows them if a file is larger */
+#define STAT_BUF_SIZE 16384
+#define MEMINFO_BUF_SIZE 8192
+
+/* Persistent file handles, opened once in metrics_init */
+static procfs_file_t stat_file = PROCFS_FILE_INIT;
+static procfs_file_t meminfo_file = PROCFS_FILE_INIT;
+
+/* Breakdown groups extracted from /proc/meminfo */
+static unsigned memory_fields = MEMORY_FIELD_ALL;
+
+/* Store previous CPU ticks for delta calculation */
+static uint64_t prev_user_ticks = 0;
+static uint64_t prev_system_ticks = 0;
+static uint64_t prev_idle_ticks = 0;
+static uint64_t prev_total_ticks = 0;
+static bool first_cpu_read = true;
+
+/* Per-core ticks, double-buffered: core_ticks[core_cur] is the latest read */
+static cpu_core_ticks_t core_ticks[2];
+static int core_cur = 0;
+static int core_count = 0;
+static bool core_seen[2][MAX_CPU_CORES];   /* Cores with a line in each read */
+
+bool metrics_init(void) {
+    /* Allow re-initialization without an intervening cleanup */
+    metrics_cleanup();
+
+    if (!procfs_open(&stat_file, "/proc/stat", STAT_BUF_SIZE) ||
+        !procfs_open(&meminfo_file, "/proc/meminfo", MEMINFO_BUF_SIZE)) {
+        metrics_cleanup();
+        return false;
+    }
+    procfs_batch_add(&stat_file);
+    procfs_batch_add(&meminfo_file);
+
+    /* Perform an initial CPU read to establish baseline */
+    cpu_metrics_t dummy;
+    metrics_get_cpu(&dummy);
+    return true;
+}
+
+void metrics_cleanup(void) {
+    procfs_close(&stat_file);
+    procfs_close(&meminfo_file);
+    first_cpu_read = true;
+    core_count = 0;
+    memset(core_seen, 0, sizeof(core_seen));
+}
+
+/* Parse the tick columns of one "cpu..." line starting at p.
+   Fills user/system/idle/total buckets, returns false if malformed. */
+static bool parse_cpu_ticks(const char *p, const char *end,
+                            uint64_t *user, uint64_t *system,
+                            uint64_t *idle, uint64_t *total) {
+    /* Columns: user nice system idle iowait irq softirq steal ... */
+    uint64_t fields[8] = {0};
+    for (int i = 0; i < 8; i++) {
+        p = procfs_parse_u64(p, end, &fields[i]);
+        if (!p) {
+            /* Older kernels report fewer columns */
+            if (i < 4) return false;
+            break;
+        }
+    }
+
+    *user = fields[0] + fields[1];                  /* user + nice */
+    *system = fields[2] + fields[5] + fields[6];    /* system + irq + softirq */
+    *idle = fields[3] + fields[4];                  /* idle + iowait */
+    *total = *user + *system + *idle + fields[7];   /* + steal */
+    return true;
+}
+
+/* Parse the "cpuN" lines that follow the aggregate into the next tick buffer */
+static void parse_core_lines(const char *p, const char *end) {
+    core_cur ^= 1;
+    cpu_core_ticks_t *ticks = &core_ticks[core_cur];
+    bool *seen = core_seen[core_cur];
+
+    /* Offline CPUs have no line; zeroing makes their delta non-positive */
+    memset(ticks, 0, sizeof(*ticks));
+    memset(seen, 0, sizeof(core_seen[0]));
+
+    int max_id = -1;
+    while (p < end && procfs_has_prefix(p, end, "cpu")) {
+        uint64_t id, idle;
+        const char *q = procfs_parse_u64(p + 3, end, &id);
+        if (q && id < MAX_CPU_CORES) {
+            parse_cpu_ticks(q, end, &ticks->user[id], &ticks->system[id],
+                            &idle, &ticks->total[id]);
+            seen[id] = true;
+            if ((int)id > max_id) max_id = (int)id;
+        }
+        p = procfs_next_line(p, end);
+    }
+
+    /* A CPU back online is measured from this read on: against the zeroed
+       previous read its delta would be its lifetime average */
+    cpu_core_ticks_t *prev = &core_ticks[core_cur ^ 1];
+    const bool *prev_seen = core_seen[core_cur ^ 1];
+    for (int i = 0; i <= max_id; i++) {
+        if (seen[i] && !prev_seen[i]) {
+            prev->user[i] = ticks->user[i];
+            prev->system[i] = ticks->system[i];
+            prev->total[i] = ticks->total[i];
+        }
+    }
+
+    core_count = max_id + 1;
+}
+
+bool metrics_get_cpu(cpu_metrics_t *cpu) {
+    if (!procfs_read(&stat_file)) {
+        return false;
+    }
+
+    const char *p = stat_file.buf;
+    const char *end = p + stat_file.len;
+
+    /* The aggregate line is always first */
+    if (!procfs_has_prefix(p, end, "cpu ")) {
+        return false;
+    }
+
+    uint64_t user, system, idle, total;
+    if (!parse_cpu_ticks(p + 4, end, &user, &system, &idle, &total)) {
+        return false;
+    }
+
+    parse_core_lines(procfs_next_line(p, end), end);
+
+    cpu->temperature_celsius = -1;
+
+    if (first_cpu_read) {
+        prev_user_ticks = user;
+        prev_system_ticks = system;
+        prev_idle_ticks = idle;
+        prev_total_ticks = total;
+        core_ticks[core_cur ^ 1] = core_ticks[core_cur];
+        first_cpu_read = false;
+
+        /* Return zeros for first read */
+        cpu->user_percent = 0.0;
+        cpu->system_percent = 0.0;
+        cpu->idle_percent = 100.0;
+        cpu->total_percent = 0.0;
+        return true;
+    }
+
+    /* Calculate deltas */
+    uint64_t user_delta = user - prev_user_ticks;
+    uint64_t system_delta = system - prev_system_ticks;
+    uint64_t idle_delta = idle - prev_idle_ticks;
+    uint64_t total_delta = total - prev_total_ticks;
+
+    if (total_delta > 0) {
+        cpu->user_percent = (double)user_delta / total_delta * 100.0;
+        cpu->system_percent = (double)system_delta / total_delta * 100.0;
+        cpu->idle_percent = (double)idle_delta / total_delta * 100.0;
+        cpu->total_percent = cpu->user_percent + cpu->system_percent;
+    } else {
+        cpu->user_percent = 0.0;
+        cpu->system_percent = 0.0;
+        cpu->idle_percent = 100.0;
+        cpu->total_percent = 0.0;
+    }
+
+    /* Store current values for next calculation */
+    prev_user_ticks = user;
+    prev_system_ticks = system;
+    prev_idle_ticks = idle;
+    prev_total_ticks = total;
+
+    return true;
+}
+
+bool metrics_get_cpu_cores(cpu_core_metrics_t *cores) {
+    if (core_count == 0) {
+        return false;
+    }
+
+    cpu_cores_compute(&core_ticks[core_cur ^ 1], &core_ticks[core_cur],
+                      core_count, cores);
+    return true;
+}
+
+bool metrics_get_memory(memory_metrics_t *mem) {
+    if (!procfs_read(&meminfo_file)) {
+        return false;
+    }
+
+    return meminfo_parse(meminfo_file.buf, meminfo_file.len, memory_fields, mem);
+}
+
+void metrics_set_memory_fields(unsigned fields) {
+    memory_fields = fields;
+}
+
+bool metrics_get_disk(const char *mount_point, disk_metrics_t *disk) {
+    struct statvfs fs;
+
+    if (statvfs(mount_point, &fs) != 0) {
+        return false;
+    }
+
+    strncpy(disk->mount_point, mount_point, MAX_PATH_LEN - 1);
+    disk->mount_point[MAX_PATH_LEN - 1] = '\0';
+
+    disk->total_bytes = (uint64_t)fs.f_blocks * fs.f_frsize;
+    disk->free_bytes = (uint64_t)fs.f_bavail * fs.f_frsize;
+    disk->used_bytes = disk->total_bytes - disk->free_bytes;
+
+    if (disk->total_bytes > 0) {
+        disk->used_percent = (double)disk->used_bytes / disk->total_bytes * 100.0;
+    } else {
+        disk->used_percent = 0.0;
+    }
+
+    return true;
+}
+
+bool metrics_get_disks(const char **mount_points, int count, disk_metrics_list_t *disks) {
+    disks->count = 0;
+    if (!metrics_reserve_disks(disks, count)) {
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (metrics_get_disk(mount_points[i], &disks->disks[disks->count])) {
+            disks->count++;
+        }
+    }
+
+    return disks->count > 0;
+}
+
+void metrics_format_bytes(uint64_t bytes, char *buf, size_t buf_size) {
+    const char *units[] = {"B", "KB", "MB", "GB", "TB", "PB"};
+    int unit_index = 0;
+    double size = (double)bytes;
+
+    while (size >= 1024.0 && unit_index < 5) {
+        size /= 1024.0;
+        unit_index++;
+    }
+
+    if (unit_index == 0) {
+        snprintf(buf, buf_size, "%llu %s", (unsigned long long)bytes, units[unit_index]);
+    } else {
+        snprintf(buf, buf_size, "%.1f %s", size, units[unit_index]);
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef METRICS_NET_H
+#define METRICS_NET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "history.h"
+
+#define MAX_NET_INTERFACES 32
+#define NET_IFACE_NAME_LEN 16
+
+typedef struct {
+    char name[NET_IFACE_NAME_LEN];
+    double rx_bytes_per_sec;
+    double tx_bytes_per_sec;
+    double rx_packets_per_sec;
+    double tx_packets_per_sec;
+    double rx_errors_per_sec;
+    double tx_errors_per_sec;
+    double rx_drops_per_sec;
+    double tx_drops_per_sec;
+    /* Byte-rate history owned by the collector, valid until the next
+       net_metrics_get call */
+    const history_t *rx_history;
+    const history_t *tx_history;
+} net_interface_metrics_t;
+
+typedef struct {
+    net_interface_metrics_t ifaces[MAX_NET_INTERFACES];
+    int count;
+} net_metrics_list_t;
+
+/* Initialize network metrics (call once at startup). names selects the
+   interfaces to report; with count 0 every non-loopback one is reported. */
+bool net_metrics_init(const char **names, int count);
+
+/* Cleanup network metrics (call once at shutdown) */
+void net_metrics_cleanup(void);
+
+/* Get per-interface rates since the previous call */
+bool net_metrics_get(net_metrics_list_t *list);
+
+#endif /* METRICS_NET_H */
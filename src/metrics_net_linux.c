@@ -0,0 +1,202 @@
+#include "metrics_net.h"
+#include "procfs.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define NET_DEV_BUF_SIZE 8192
+
+/* Counter columns of /proc/net/dev after "name:" */
+enum {
+    ND_RX_BYTES = 0,
+    ND_RX_PACKETS,
+    ND_RX_ERRS,
+    ND_RX_DROP,
+    ND_RX_FIFO,
+    ND_RX_FRAME,
+    ND_RX_COMPRESSED,
+    ND_RX_MULTICAST,
+    ND_TX_BYTES,
+    ND_TX_PACKETS,
+    ND_TX_ERRS,
+    ND_TX_DROP,
+    ND_FIELD_COUNT      /* Remaining tx columns are not used */
+};
+
+typedef struct {
+    char name[NET_IFACE_NAME_LEN];
+    uint64_t prev[ND_FIELD_COUNT];
+    bool has_prev;
+    bool seen;          /* Present in the latest read */
+    history_t rx_history;
+    history_t tx_history;
+} iface_state_t;
+
+static procfs_file_t net_dev_file = PROCFS_FILE_INIT;
+static iface_state_t ifaces[MAX_NET_INTERFACES];
+static int iface_count = 0;
+
+/* Optional allow-list from the config */
+static char filter_names[MAX_NET_INTERFACES][NET_IFACE_NAME_LEN];
+static int filter_count = 0;
+
+static struct timespec prev_read_time;
+
+static bool iface_wanted(const char *name) {
+    if (filter_count == 0) {
+        return strcmp(name, "lo") != 0;
+    }
+    for (int i = 0; i < filter_count; i++) {
+        if (strcmp(filter_names[i], name) == 0) return true;
+    }
+    return false;
+}
+
+static iface_state_t *find_or_add_iface(const char *name) {
+    for (int i = 0; i < iface_count; i++) {
+        if (strcmp(ifaces[i].name, name) == 0) return &ifaces[i];
+    }
+    if (iface_count >= MAX_NET_INTERFACES) {
+        return NULL;
+    }
+
+    iface_state_t *s = &ifaces[iface_count++];
+    memset(s, 0, sizeof(*s));
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    return s;
+}
+
+bool net_metrics_init(const char **names, int count) {
+    net_metrics_cleanup();
+
+    filter_count = 0;
+    for (int i = 0; i < count && i < MAX_NET_INTERFACES; i++) {
+        strncpy(filter_names[filter_count], names[i], NET_IFACE_NAME_LEN - 1);
+        filter_names[filter_count][NET_IFACE_NAME_LEN - 1] = '\0';
+        filter_count++;
+    }
+
+    if (!procfs_open(&net_dev_file, "/proc/net/dev", NET_DEV_BUF_SIZE)) {
+        return false;
+    }
+    procfs_batch_add(&net_dev_file);
+
+    /* Baseline read so the first real call has deltas */
+    net_metrics_list_t dummy;
+    net_metrics_get(&dummy);
+    return true;
+}
+
+void net_metrics_cleanup(void) {
+    procfs_close(&net_dev_file);
+    iface_count = 0;
+}
+
+bool net_metrics_get(net_metrics_list_t *list) {
+    list->count = 0;
+
+    if (!procfs_read(&net_dev_file)) {
+        return false;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double seconds = (double)(now.tv_sec - prev_read_time.tv_sec) +
+                     (double)(now.tv_nsec - prev_read_time.tv_nsec) / 1e9;
+    prev_read_time = now;
+
+    for (int i = 0; i < iface_count; i++) {
+        ifaces[i].seen = false;
+    }
+
+    const char *p = net_dev_file.buf;
+    const char *end = p + net_dev_file.len;
+
+    /* Two header lines */
+    p = procfs_next_line(p, end);
+    p = procfs_next_line(p, end);
+
+    while (p < end) {
+        const char *next = procfs_next_line(p, end);
+
+        /* "  eth0: 1116 16 ..." */
+        p = procfs_skip_blanks(p, next);
+        const char *colon = memchr(p, ':', (size_t)(next - p));
+        if (!colon) {
+            p = next;
+            continue;
+        }
+
+        char name[NET_IFACE_NAME_LEN];
+        size_t name_len = (size_t)(colon - p);
+        if (name_len >= NET_IFACE_NAME_LEN) name_len = NET_IFACE_NAME_LEN - 1;
+        memcpy(name, p, name_len);
+        name[name_len] = '\0';
+
+        if (!iface_wanted(name)) {
+            p = next;
+            continue;
+        }
+
+        uint64_t cur[ND_FIELD_COUNT];
+        const char *q = colon + 1;
+        for (int f = 0; f < ND_FIELD_COUNT && q; f++) {
+            q = procfs_parse_u64(q, next, &cur[f]);
+        }
+
+        iface_state_t *s = q ? find_or_add_iface(name) : NULL;
+        if (s) {
+            s->seen = true;
+
+            if (list->count < MAX_NET_INTERFACES) {
+                net_interface_metrics_t *out = &list->ifaces[list->count++];
+                memset(out, 0, sizeof(*out));
+                memcpy(out->name, s->name, NET_IFACE_NAME_LEN);
+
+                if (s->has_prev && seconds > 0.0) {
+                    double d[ND_FIELD_COUNT];
+                    for (int f = 0; f < ND_FIELD_COUNT; f++) {
+                        /* Counters reset if the driver reloads */
+                        d[f] = cur[f] >= s->prev[f] ? (double)(cur[f] - s->prev[f]) : 0.0;
+                    }
+                    out->rx_bytes_per_sec = d[ND_RX_BYTES] / seconds;
+                    out->tx_bytes_per_sec = d[ND_TX_BYTES] / seconds;
+                    out->rx_packets_per_sec = d[ND_RX_PACKETS] / seconds;
+                    out->tx_packets_per_sec = d[ND_TX_PACKETS] / seconds;
+                    out->rx_errors_per_sec = d[ND_RX_ERRS] / seconds;
+                    out->tx_errors_per_sec = d[ND_TX_ERRS] / seconds;
+                    out->rx_drops_per_sec = d[ND_RX_DROP] / seconds;
+                    out->tx_drops_per_sec = d[ND_TX_DROP] / seconds;
+
+                    history_add(&s->rx_history, out->rx_bytes_per_sec);
+                    history_add(&s->tx_history, out->tx_bytes_per_sec);
+                }
+            }
+
+            memcpy(s->prev, cur, sizeof(cur));
+            s->has_prev = true;
+        }
+
+        p = next;
+    }
+
+    /* Forget interfaces that went away so a later one with the same name
+       starts with fresh counters */
+    int kept = 0;
+    for (int i = 0; i < iface_count; i++) {
+        if (ifaces[i].seen) {
+            if (kept != i) ifaces[kept] = ifaces[i];
+            kept++;
+        }
+    }
+    iface_count = kept;
+
+    /* Point outputs at their (possibly moved) history */
+    for (int i = 0; i < list->count; i++) {
+        iface_state_t *s = find_or_add_iface(list->ifaces[i].name);
+        list->ifaces[i].rx_history = &s->rx_history;
+        list->ifaces[i].tx_history = &s->tx_history;
+    }
+
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef METRICS_NUMA_H
+#define METRICS_NUMA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MAX_NUMA_NODES 64
+
+/* A node whose local_percent drops below this is flagged */
+#define NUMA_LOCAL_WARN_PERCENT 90.0f
+
+typedef struct {
+    int node;                   /* N in nodeN */
+    uint64_t total;             /* Bytes */
+    uint64_t free;
+    uint64_t used;
+    uint64_t file;              /* Page cache on this node */
+    double hit_rate;            /* Per second: allocations satisfied here as intended */
+    double miss_rate;           /* Meant for another node, landed here */
+    double foreign_rate;        /* Meant for this node, landed elsewhere */
+    double other_node_rate;     /* Allocated here by a process running elsewhere */
+    float local_percent;        /* local_node / (local_node + other_node), 100 if idle */
+} numa_node_t;
+
+typedef struct {
+    int count;
+    numa_node_t nodes[MAX_NUMA_NODES];  /* Sorted by node number */
+} numa_metrics_t;
+
+/* Open meminfo and numastat of every node under sysfs_root (NULL for
+   "/sys") and take the baseline sample. Returns false if there are none. */
+bool numa_metrics_init(const char *sysfs_root);
+
+/* Close the files (call once at shutdown) */
+void numa_metrics_cleanup(void);
+
+/* Per-node memory and allocation rates since the previous call */
+bool numa_metrics_get(numa_metrics_t *numa);
+
+#endif /* METRICS_NUMA_H */
@@ -0,0 +1,225 @@
+#include "metrics_numa.h"
+#include "procfs.h"
+#include <dirent.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MEMINFO_BUF_SIZE 4096
+#define NUMASTAT_BUF_SIZE 256
+/* Nested so each level always fits in the next one's buffer */
+#define SYSFS_DIR_LEN 320
+#define SYSFS_PATH_LEN 384
+
+/* numastat counters, in file order */
+enum {
+    NS_HIT,
+    NS_MISS,
+    NS_FOREIGN,
+    NS_INTERLEAVE,
+    NS_LOCAL,
+    NS_OTHER,
+    NS_COUNT
+};
+
+static const char *const numastat_keys[NS_COUNT] = {
+    "numa_hit ", "numa_miss ", "numa_foreign ", "interleave_hit ", "local_node ", "other_node ",
+};
+
+typedef struct {
+    uint64_t v[NS_COUNT];
+} numastat_t;
+
+/* Per-node meminfo lines after the "Node N " prefix */
+static const struct {
+    const char *key;
+    size_t offset;
+} meminfo_keys[] = {
+    { "MemTotal:",  offsetof(numa_node_t, total) },
+    { "MemFree:",   offsetof(numa_node_t, free) },
+    { "MemUsed:",   offsetof(numa_node_t, used) },
+    { "FilePages:", offsetof(numa_node_t, file) },
+};
+
+#define MEMINFO_KEY_COUNT ((int)(sizeof(meminfo_keys) / sizeof(meminfo_keys[0])))
+
+typedef struct {
+    int node;
+    procfs_file_t meminfo;
+    procfs_file_t numastat;
+    numastat_t prev;
+} node_slot_t;
+
+static node_slot_t slots[MAX_NUMA_NODES];
+static int slot_count = 0;
+static double prev_when = 0.0;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int compare_ints(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/* "numa_hit 5263205" lines */
+static bool read_numastat(node_slot_t *s, numastat_t *out) {
+    if (!procfs_read(&s->numastat)) {
+        return false;
+    }
+
+    const char *p = s->numastat.buf;
+    const char *end = p + s->numastat.len;
+    memset(out, 0, sizeof(*out));
+
+    for (; p < end; p = procfs_next_line(p, end)) {
+        for (int k = 0; k < NS_COUNT; k++) {
+            if (procfs_has_prefix(p, end, numastat_keys[k])) {
+                procfs_parse_u64(p + strlen(numastat_keys[k]), end, &out->v[k]);
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+/* "Node 0 MemTotal:        4292344 kB" lines; stops once all keys are found */
+static bool read_node_meminfo(node_slot_t *s, numa_node_t *out) {
+    if (!procfs_read(&s->meminfo)) {
+        return false;
+    }
+
+    const char *p = s->meminfo.buf;
+    const char *end = p + s->meminfo.len;
+    int found = 0;
+
+    for (; p < end && found < MEMINFO_KEY_COUNT; p = procfs_next_line(p, end)) {
+        uint64_t id, kb;
+        if (!procfs_has_prefix(p, end, "Node ")) continue;
+        const char *key = procfs_parse_u64(p + 5, end, &id);
+        if (!key) continue;
+        key = procfs_skip_blanks(key, end);
+
+        for (int k = 0; k < MEMINFO_KEY_COUNT; k++) {
+            if (procfs_has_prefix(key, end, meminfo_keys[k].key) &&
+                procfs_parse_u64(key + strlen(meminfo_keys[k].key), end, &kb)) {
+                *(uint64_t *)((char *)out + meminfo_keys[k].offset) = kb * 1024;
+                found++;
+                break;
+            }
+        }
+    }
+    return found > 0;
+}
+
+static void open_node(const char *dir, int node) {
+    char path[SYSFS_PATH_LEN];
+    node_slot_t *s = &slots[slot_count];
+    procfs_file_t closed = PROCFS_FILE_INIT;
+
+    s->node = node;
+    s->meminfo = closed;
+    s->numastat = closed;
+
+    snprintf(path, sizeof(path), "%s/node%d/meminfo", dir, node);
+    if (!procfs_open(&s->meminfo, path, MEMINFO_BUF_SIZE)) {
+        return;
+    }
+    procfs_batch_add(&s->meminfo);
+    snprintf(path, sizeof(path), "%s/node%d/numastat", dir, node);
+    if (procfs_open(&s->numastat, path, NUMASTAT_BUF_SIZE)) {
+        read_numastat(s, &s->prev);
+        procfs_batch_add(&s->numastat);
+    }
+    slot_count++;
+}
+
+bool numa_metrics_init(const char *sysfs_root) {
+    numa_metrics_cleanup();
+
+    char dir[SYSFS_DIR_LEN];
+    snprintf(dir, sizeof(dir), "%s/devices/system/node", sysfs_root ? sysfs_root : "/sys");
+
+    DIR *d = opendir(dir);
+    if (!d) {
+        return false;
+    }
+
+    int nodes[MAX_NUMA_NODES];
+    int count = 0;
+    struct dirent *ent;
+    while ((ent = readdir(d)) != NULL && count < MAX_NUMA_NODES) {
+        const char *p = ent->d_name;
+        if (strncmp(p, "node", 4) != 0 || p[4] < '0' || p[4] > '9') continue;
+
+        int node = 0;
+        for (p += 4; *p >= '0' && *p <= '9'; p++) node = node * 10 + (*p - '0');
+        if (*p == '\0') nodes[count++] = node;
+    }
+    closedir(d);
+    qsort(nodes, (size_t)count, sizeof(int), compare_ints);
+
+    for (int i = 0; i < count; i++) {
+        open_node(dir, nodes[i]);
+    }
+    prev_when = now_seconds();
+    return slot_count > 0;
+}
+
+void numa_metrics_cleanup(void) {
+    for (int i = 0; i < slot_count; i++) {
+        procfs_close(&slots[i].meminfo);
+        procfs_close(&slots[i].numastat);
+    }
+    slot_count = 0;
+}
+
+bool numa_metrics_get(numa_metrics_t *numa) {
+    numa->count = 0;
+    if (slot_count == 0) {
+        return false;
+    }
+
+    double when = now_seconds();
+    double elapsed = when - prev_when;
+    double per_second = elapsed > 0.0 ? 1.0 / elapsed : 0.0;
+    prev_when = when;
+
+    for (int i = 0; i < slot_count; i++) {
+        node_slot_t *s = &slots[i];
+        numa_node_t *n = &numa->nodes[numa->count];
+        memset(n, 0, sizeof(*n));
+        n->node = s->node;
+        n->local_percent = 100.0f;
+
+        if (!read_node_meminfo(s, n)) continue;
+        if (n->used == 0 && n->total > n->free) {
+            n->used = n->total - n->free;
+        }
+
+        numastat_t cur;
+        if (s->numastat.fd >= 0 && read_numastat(s, &cur)) {
+            /* Counters only grow; treat a decrease (node re-onlined) as 0 */
+            uint64_t d[NS_COUNT];
+            for (int k = 0; k < NS_COUNT; k++) {
+                d[k] = cur.v[k] >= s->prev.v[k] ? cur.v[k] - s->prev.v[k] : 0;
+            }
+            n->hit_rate = (double)d[NS_HIT] * per_second;
+            n->miss_rate = (double)d[NS_MISS] * per_second;
+            n->foreign_rate = (double)d[NS_FOREIGN] * per_second;
+            n->other_node_rate = (double)d[NS_OTHER] * per_second;
+            if (d[NS_LOCAL] + d[NS_OTHER] > 0) {
+                n->local_percent = (float)((double)d[NS_LOCAL] * 100.0 /
+                                           (double)(d[NS_LOCAL] + d[NS_OTHER]));
+            }
+            s->prev = cur;
+        }
+        numa->count++;
+    }
+    return numa->count > 0;
+}
@@ -0,0 +1,43 @@
+#ifndef METRICS_PERF_H
+#define METRICS_PERF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "metrics.h"
+
+/* IPC this high fills a sparkline cell */
+#define PERF_IPC_SCALE 4.0f
+
+/* Per-CPU vectors are indexed by CPU number */
+typedef struct {
+    int cpu_count;                      /* Highest CPU number with counters + 1 */
+    bool hardware;                      /* Cycle/instruction counters available */
+    bool multiplexed;                   /* Counters were time-shared; values are estimates */
+    float ipc[MAX_CPU_CORES];           /* Instructions per cycle, 0 without a PMU */
+    float mpki[MAX_CPU_CORES];          /* Cache misses per 1000 instructions */
+    double ipc_total;                   /* All CPUs */
+    double mpki_total;
+    double cycles_rate;                 /* Per second, all CPUs */
+    double ctx_switch_rate;
+    double page_fault_rate;
+    double migration_rate;
+} perf_metrics_t;
+
+/* Open one counter group per CPU with perf_event_open: cycles,
+   instructions, cache-misses, context-switches, page-faults and
+   migrations. Without a hardware PMU (most VMs), or if allow_hardware is
+   false, only the software events are counted. Returns false if no group
+   could be opened (e.g. perf_event_paranoid denies system-wide counting). */
+bool perf_metrics_init(bool allow_hardware);
+
+/* Close all counters (call once at shutdown) */
+void perf_metrics_cleanup(void);
+
+/* Rates since the previous call; each CPU's group is read with one read() */
+bool perf_metrics_get(perf_metrics_t *perf);
+
+/* Scale a counter delta for the share of time it was actually counting
+   when the PMU was multiplexed (exposed for testing) */
+uint64_t perf_scale_delta(uint64_t delta, uint64_t enabled_delta, uint64_t running_delta);
+
+#endif /* METRICS_PERF_H */
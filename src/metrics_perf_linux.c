@@ -0,0 +1,220 @@
+#include "metrics_perf.h"
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* Group members, leader first; hardware events are skipped in software mode */
+typedef enum {
+    COUNTER_CYCLES = 0,
+    COUNTER_INSTRUCTIONS,
+    COUNTER_CACHE_MISSES,
+    COUNTER_CTX_SWITCHES,
+    COUNTER_PAGE_FAULTS,
+    COUNTER_MIGRATIONS,
+    COUNTER_COUNT
+} counter_t;
+
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} counter_defs[COUNTER_COUNT] = {
+    [COUNTER_CYCLES]       = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    [COUNTER_INSTRUCTIONS] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    [COUNTER_CACHE_MISSES] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    [COUNTER_CTX_SWITCHES] = { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+    [COUNTER_PAGE_FAULTS]  = { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+    [COUNTER_MIGRATIONS]   = { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS },
+};
+
+/* Layout of a PERF_FORMAT_GROUP | TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING read */
+typedef struct {
+    uint64_t nr;
+    uint64_t time_enabled;
+    uint64_t time_running;
+    uint64_t values[COUNTER_COUNT];
+} group_read_t;
+
+/* One CPU's counter group */
+typedef struct {
+    int cpu;
+    int leader;                         /* fd the whole group is read through */
+    int fds[COUNTER_COUNT];             /* -1 where the event could not be opened */
+    int position[COUNTER_COUNT];        /* Index into group_read_t.values, -1 if absent */
+    int member_count;
+    group_read_t prev;
+    bool have_prev;
+} cpu_group_t;
+
+static cpu_group_t groups[MAX_CPU_CORES];
+static int group_count = 0;
+static bool hardware_mode = false;
+
+static int perf_event_open(struct perf_event_attr *attr, int cpu, int group_fd) {
+    return (int)syscall(SYS_perf_event_open, attr, -1, cpu, group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+
+static int open_counter(counter_t c, int cpu, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = counter_defs[c].type;
+    attr.config = counter_defs[c].config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return perf_event_open(&attr, cpu, group_fd);
+}
+
+static void close_group(cpu_group_t *g) {
+    /* Members first, then the leader */
+    for (int c = COUNTER_COUNT - 1; c >= 0; c--) {
+        if (g->fds[c] >= 0) close(g->fds[c]);
+        g->fds[c] = -1;
+    }
+}
+
+/* Open the group for one CPU; the first event that opens becomes leader */
+static bool open_group(cpu_group_t *g, int cpu, bool hardware) {
+    g->cpu = cpu;
+    g->member_count = 0;
+    g->have_prev = false;
+
+    int leader = -1;
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        g->fds[c] = -1;
+        g->position[c] = -1;
+        if (!hardware && counter_defs[c].type == PERF_TYPE_HARDWARE) continue;
+
+        int fd = open_counter((counter_t)c, cpu, leader);
+        if (fd < 0) {
+            /* Without cycles there is no IPC: drop to the software set */
+            if (c == COUNTER_CYCLES) return false;
+            continue;
+        }
+        if (leader < 0) leader = fd;
+        g->fds[c] = fd;
+        g->position[c] = g->member_count++;
+    }
+
+    if (leader < 0) {
+        return false;
+    }
+    g->leader = leader;
+    if (hardware && g->fds[COUNTER_INSTRUCTIONS] < 0) {
+        close_group(g);
+        return false;
+    }
+    return true;
+}
+
+static int open_all(int cpus, bool hardware) {
+    for (int cpu = 0; cpu < cpus && group_count < MAX_CPU_CORES; cpu++) {
+        if (open_group(&groups[group_count], cpu, hardware)) {
+            group_count++;
+        } else if (hardware && (errno == ENOENT || errno == EOPNOTSUPP)) {
+            /* No PMU exposed (e.g. in a VM): none on any CPU */
+            return 0;
+        }
+    }
+    return group_count;
+}
+
+bool perf_metrics_init(bool allow_hardware) {
+    perf_metrics_cleanup();
+
+    long configured = sysconf(_SC_NPROCESSORS_CONF);
+    int cpus = configured > 0 ? (int)configured : 1;
+    if (cpus > MAX_CPU_CORES) cpus = MAX_CPU_CORES;
+
+    hardware_mode = allow_hardware && open_all(cpus, true) > 0;
+    if (!hardware_mode) {
+        perf_metrics_cleanup();
+        open_all(cpus, false);
+    }
+    return group_count > 0;
+}
+
+void perf_metrics_cleanup(void) {
+    for (int i = 0; i < group_count; i++) {
+        close_group(&groups[i]);
+    }
+    group_count = 0;
+    hardware_mode = false;
+}
+
+uint64_t perf_scale_delta(uint64_t delta, uint64_t enabled_delta, uint64_t running_delta) {
+    if (running_delta == 0) {
+        return 0;
+    }
+    if (running_delta >= enabled_delta) {
+        return delta;
+    }
+    return (uint64_t)((double)delta * (double)enabled_delta / (double)running_delta);
+}
+
+bool perf_metrics_get(perf_metrics_t *perf) {
+    uint64_t totals[COUNTER_COUNT] = { 0 };
+    double seconds = 0.0;
+
+    memset(perf, 0, sizeof(*perf));
+    perf->hardware = hardware_mode;
+    if (group_count == 0) {
+        return false;
+    }
+
+    for (int i = 0; i < group_count; i++) {
+        cpu_group_t *g = &groups[i];
+        group_read_t cur;
+        ssize_t n = read(g->leader, &cur, sizeof(cur));
+        if (n < (ssize_t)(3 + g->member_count) * (ssize_t)sizeof(uint64_t)) continue;
+
+        if (!g->have_prev) {
+            g->prev = cur;
+            g->have_prev = true;
+            continue;
+        }
+
+        uint64_t enabled = cur.time_enabled - g->prev.time_enabled;
+        uint64_t running = cur.time_running - g->prev.time_running;
+        if (running < enabled) perf->multiplexed = true;
+
+        uint64_t delta[COUNTER_COUNT] = { 0 };
+        for (int c = 0; c < COUNTER_COUNT; c++) {
+            int pos = g->position[c];
+            if (pos < 0) continue;
+            delta[c] = perf_scale_delta(cur.values[pos] - g->prev.values[pos], enabled, running);
+            totals[c] += delta[c];
+        }
+        g->prev = cur;
+
+        /* time_enabled is wall time for a per-CPU event */
+        double cpu_seconds = (double)enabled / 1e9;
+        if (cpu_seconds > seconds) seconds = cpu_seconds;
+
+        if (delta[COUNTER_CYCLES] > 0) {
+            perf->ipc[g->cpu] = (float)((double)delta[COUNTER_INSTRUCTIONS] /
+                                        (double)delta[COUNTER_CYCLES]);
+        }
+        if (delta[COUNTER_INSTRUCTIONS] > 0) {
+            perf->mpki[g->cpu] = (float)((double)delta[COUNTER_CACHE_MISSES] * 1000.0 /
+                                         (double)delta[COUNTER_INSTRUCTIONS]);
+        }
+        if (g->cpu + 1 > perf->cpu_count) perf->cpu_count = g->cpu + 1;
+    }
+
+    if (totals[COUNTER_CYCLES] > 0) {
+        perf->ipc_total = (double)totals[COUNTER_INSTRUCTIONS] / (double)totals[COUNTER_CYCLES];
+    }
+    if (totals[COUNTER_INSTRUCTIONS] > 0) {
+        perf->mpki_total = (double)totals[COUNTER_CACHE_MISSES] * 1000.0 /
+                           (double)totals[COUNTER_INSTRUCTIONS];
+    }
+    if (seconds > 0.0) {
+        perf->cycles_rate = (double)totals[COUNTER_CYCLES] / seconds;
+        perf->ctx_switch_rate = (double)totals[COUNTER_CTX_SWITCHES] / seconds;
+        perf->page_fault_rate = (double)totals[COUNTER_PAGE_FAULTS] / seconds;
+        perf->migration_rate = (double)totals[COUNTER_MIGRATIONS] / seconds;
+    }
+    return true;
+}
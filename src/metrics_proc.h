@@ -0,0 +1,35 @@
+#ifndef METRICS_PROC_H
+#define METRICS_PROC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MAX_TOP_PROCESSES 16
+#define PROCESS_NAME_LEN 16     /* Kernel comm is at most 15 chars */
+
+typedef struct {
+    int pid;
+    char name[PROCESS_NAME_LEN];
+    double cpu_percent;           /* Percent of one CPU, like top */
+    uint64_t rss_bytes;
+} process_info_t;
+
+typedef struct {
+    process_info_t by_cpu[MAX_TOP_PROCESSES];   /* Highest CPU first */
+    int cpu_count;
+    process_info_t by_rss[MAX_TOP_PROCESSES];   /* Highest RSS first */
+    int rss_count;
+    int total_processes;
+} process_list_t;
+
+/* Initialize process tracking (call once at startup) */
+bool process_metrics_init(void);
+
+/* Cleanup process tracking (call once at shutdown) */
+void process_metrics_cleanup(void);
+
+/* Scan all processes and select the top_n by CPU and by RSS.
+   CPU usage is measured since the previous call. */
+bool process_metrics_get(int top_n, process_list_t *list);
+
+#endif /* METRICS_PROC_H */
@@ -0,0 +1,365 @@
+#include "metrics_proc.h"
+#include "procfs.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Initial hash table size; doubles when more than half full */
+#define PROC_TABLE_INITIAL 4096
+#define DENTS_BUF_SIZE 32768
+#define STAT_LINE_SIZE 1024
+
+/* Cached per-PID state, kept between refreshes */
+typedef struct {
+    int pid;                      /* 0 marks an empty slot */
+    uint32_t seen_gen;            /* Scan generation that last saw this PID */
+    uint64_t start_time;          /* Detects PID reuse */
+    uint64_t prev_ticks;          /* utime + stime at the previous scan */
+    double cpu_percent;
+    uint64_t rss_pages;
+    char name[PROCESS_NAME_LEN];
+} proc_entry_t;
+
+/* Layout of the records returned by getdents64 */
+struct linux_dirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+static int proc_dir_fd = -1;
+static proc_entry_t *table = NULL;
+static uint32_t table_size = 0;       /* Always a power of two */
+static uint32_t table_used = 0;
+static uint32_t scan_gen = 0;
+
+static char dents_buf[DENTS_BUF_SIZE];
+static struct timespec prev_scan_time;
+static long clock_ticks = 100;
+static long page_size = 4096;
+
+/* Fibonacci hashing; size must be a power of two */
+static uint32_t hash_pid(int pid, uint32_t size) {
+    return ((uint32_t)pid * 2654435761u) & (size - 1);
+}
+
+/* Find the slot holding pid, or the empty slot where it would go */
+static proc_entry_t *table_slot(proc_entry_t *tab, uint32_t size, int pid) {
+    uint32_t i = hash_pid(pid, size);
+    while (tab[i].pid != 0 && tab[i].pid != pid) {
+        i = (i + 1) & (size - 1);
+    }
+    return &tab[i];
+}
+
+/* Double the table. Only happens when the process count reaches a new
+   high-water mark, never in steady state. */
+static bool table_grow(void) {
+    uint32_t new_size = table_size * 2;
+    proc_entry_t *grown = calloc(new_size, sizeof(proc_entry_t));
+    if (!grown) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < table_size; i++) {
+        if (table[i].pid != 0) {
+            *table_slot(grown, new_size, table[i].pid) = table[i];
+        }
+    }
+
+    free(table);
+    table = grown;
+    table_size = new_size;
+    return true;
+}
+
+/* Remove the entry at slot i, shifting later probe-chain members back so
+   lookups never need tombstones */
+static void table_remove(uint32_t i) {
+    uint32_t mask = table_size - 1;
+    uint32_t j = i;
+
+    for (;;) {
+        j = (j + 1) & mask;
+        if (table[j].pid == 0) break;
+
+        uint32_t home = hash_pid(table[j].pid, table_size);
+        /* Move j into the hole at i unless its home lies cyclically in (i, j] */
+        bool in_range = (i <= j) ? (home > i && home <= j) : (home > i || home <= j);
+        if (!in_range) {
+            table[i] = table[j];
+            i = j;
+        }
+    }
+
+    table[i].pid = 0;
+    table_used--;
+}
+
+/* Skip n space-separated fields */
+static const char *skip_fields(const char *p, const char *end, int n) {
+    for (int k = 0; k < n; k++) {
+        p = procfs_skip_blanks(p, end);
+        while (p < end && *p != ' ') p++;
+    }
+    return p;
+}
+
+/* Read /proc/<pid>/stat and update the cached entry */
+static bool read_pid_stat(const char *pid_str, int pid, double elapsed_ticks) {
+    char path[32];
+    char line[STAT_LINE_SIZE];
+
+    size_t n = strlen(pid_str);
+    if (n > sizeof(path) - 6) return false;
+    memcpy(path, pid_str, n);
+    memcpy(path + n, "/stat", 6);
+
+    int fd = openat(proc_dir_fd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;   /* Exited since the directory scan */
+    }
+    ssize_t len = read(fd, line, sizeof(line));
+    close(fd);
+    if (len <= 0) {
+        return false;
+    }
+
+    const char *end = line + len;
+
+    /* "pid (comm) state ..." - comm may itself contain ')' or spaces */
+    const char *open_paren = memchr(line, '(', (size_t)len);
+    const char *close_paren = NULL;
+    for (const char *q = end - 1; q > line; q--) {
+        if (*q == ')') { close_paren = q; break; }
+    }
+    if (!open_paren || !close_paren || close_paren < open_paren) {
+        return false;
+    }
+
+    /* Fields after comm, counted from 3 (state) per proc(5) */
+    uint64_t utime, stime, start_time, rss;
+    const char *p = skip_fields(close_paren + 1, end, 11);     /* to field 14 */
+    p = procfs_parse_u64(p, end, &utime);
+    if (!p) return false;
+    p = procfs_parse_u64(p, end, &stime);
+    if (!p) return false;
+    p = skip_fields(p, end, 6);                                 /* to field 22 */
+    p = procfs_parse_u64(p, end, &start_time);
+    if (!p) return false;
+    p = skip_fields(p, end, 1);                                 /* to field 24 */
+    p = procfs_parse_u64(p, end, &rss);
+    if (!p) return false;
+
+    if (table_used + 1 > table_size / 2 && !table_grow()) {
+        return false;
+    }
+
+    proc_entry_t *e = table_slot(table, table_size, pid);
+    uint64_t ticks = utime + stime;
+
+    if (e->pid == pid && e->start_time == start_time) {
+        /* Known process: only the counters change */
+        uint64_t delta = ticks >= e->prev_ticks ? ticks - e->prev_ticks : 0;
+        e->cpu_percent = elapsed_ticks > 0 ? (double)delta / elapsed_ticks * 100.0 : 0.0;
+    } else {
+        /* New process (or a reused PID): capture the name once */
+        if (e->pid == 0) {
+            table_used++;
+        }
+        e->pid = pid;
+        e->start_time = start_time;
+        e->cpu_percent = 0.0;
+
+        size_t name_len = (size_t)(close_paren - open_paren - 1);
+        if (name_len >= PROCESS_NAME_LEN) name_len = PROCESS_NAME_LEN - 1;
+        memcpy(e->name, open_paren + 1, name_len);
+        e->name[name_len] = '\0';
+    }
+
+    e->prev_ticks = ticks;
+    e->rss_pages = rss;
+    e->seen_gen = scan_gen;
+    return true;
+}
+
+/* Min-heap of entry pointers keyed by CPU or RSS, holding the current top N.
+   Each process costs one comparison against the root unless it qualifies. */
+typedef struct {
+    const proc_entry_t *items[MAX_TOP_PROCESSES];
+    int count;
+    int limit;
+    bool by_rss;
+} top_heap_t;
+
+static bool heap_less(const top_heap_t *h, const proc_entry_t *a, const proc_entry_t *b) {
+    if (h->by_rss) return a->rss_pages < b->rss_pages;
+    return a->cpu_percent < b->cpu_percent;
+}
+
+static void heap_sift_down(top_heap_t *h, int i) {
+    for (;;) {
+        int smallest = i;
+        int l = 2 * i + 1, r = 2 * i + 2;
+        if (l < h->count && heap_less(h, h->items[l], h->items[smallest])) smallest = l;
+        if (r < h->count && heap_less(h, h->items[r], h->items[smallest])) smallest = r;
+        if (smallest == i) return;
+        const proc_entry_t *tmp = h->items[i];
+        h->items[i] = h->items[smallest];
+        h->items[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+static void heap_offer(top_heap_t *h, const proc_entry_t *e) {
+    if (h->count < h->limit) {
+        int i = h->count++;
+        h->items[i] = e;
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (!heap_less(h, h->items[i], h->items[parent])) break;
+            const proc_entry_t *tmp = h->items[i];
+            h->items[i] = h->items[parent];
+            h->items[parent] = tmp;
+            i = parent;
+        }
+    } else if (h->limit > 0 && heap_less(h, h->items[0], e)) {
+        h->items[0] = e;
+        heap_sift_down(h, 0);
+    }
+}
+
+/* Drain the heap into out[], largest first */
+static int heap_drain(top_heap_t *h, process_info_t *out) {
+    int n = h->count;
+    for (int k = n - 1; k >= 0; k--) {
+        const proc_entry_t *e = h->items[0];
+        out[k].pid = e->pid;
+        memcpy(out[k].name, e->name, PROCESS_NAME_LEN);
+        out[k].cpu_percent = e->cpu_percent;
+        out[k].rss_bytes = e->rss_pages * (uint64_t)page_size;
+
+        h->items[0] = h->items[--h->count];
+        heap_sift_down(h, 0);
+    }
+    return n;
+}
+
+bool process_metrics_init(void) {
+    process_metrics_cleanup();
+
+    proc_dir_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (proc_dir_fd < 0) {
+        return false;
+    }
+
+    table = calloc(PROC_TABLE_INITIAL, sizeof(proc_entry_t));
+    if (!table) {
+        process_metrics_cleanup();
+        return false;
+    }
+    table_size = PROC_TABLE_INITIAL;
+    table_used = 0;
+
+    clock_ticks = sysconf(_SC_CLK_TCK);
+    if (clock_ticks <= 0) clock_ticks = 100;
+    page_size = sysconf(_SC_PAGESIZE);
+    if (page_size <= 0) page_size = 4096;
+
+    /* Baseline scan so the first real call has CPU deltas */
+    process_list_t dummy;
+    process_metrics_get(0, &dummy);
+    return true;
+}
+
+void process_metrics_cleanup(void) {
+    if (proc_dir_fd >= 0) {
+        close(proc_dir_fd);
+        proc_dir_fd = -1;
+    }
+    free(table);
+    table = NULL;
+    table_size = 0;
+    table_used = 0;
+}
+
+bool process_metrics_get(int top_n, process_list_t *list) {
+    list->cpu_count = 0;
+    list->rss_count = 0;
+    list->total_processes = 0;
+
+    if (proc_dir_fd < 0) {
+        return false;
+    }
+
+    if (top_n > MAX_TOP_PROCESSES) top_n = MAX_TOP_PROCESSES;
+    if (top_n < 0) top_n = 0;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double elapsed = (double)(now.tv_sec - prev_scan_time.tv_sec) +
+                     (double)(now.tv_nsec - prev_scan_time.tv_nsec) / 1e9;
+    double elapsed_ticks = elapsed * (double)clock_ticks;
+    prev_scan_time = now;
+
+    scan_gen++;
+
+    /* Walk /proc with raw getdents64 on the long-lived directory fd,
+       which avoids opendir's per-scan allocation */
+    if (lseek(proc_dir_fd, 0, SEEK_SET) < 0) {
+        return false;
+    }
+
+    int total = 0;
+    for (;;) {
+        long nread = syscall(SYS_getdents64, proc_dir_fd, dents_buf, sizeof(dents_buf));
+        if (nread <= 0) break;
+
+        for (long off = 0; off < nread; ) {
+            struct linux_dirent64 *d = (struct linux_dirent64 *)(dents_buf + off);
+            off += d->d_reclen;
+
+            const char *name = d->d_name;
+            if (name[0] < '1' || name[0] > '9') continue;
+
+            int pid = 0;
+            const char *c = name;
+            while (*c >= '0' && *c <= '9') pid = pid * 10 + (*c++ - '0');
+            if (*c != '\0') continue;
+
+            if (read_pid_stat(name, pid, elapsed_ticks)) {
+                total++;
+            }
+        }
+    }
+
+    /* Drop processes that have exited */
+    for (uint32_t i = 0; i < table_size; ) {
+        if (table[i].pid != 0 && table[i].seen_gen != scan_gen) {
+            table_remove(i);    /* Slot i may now hold a shifted entry */
+        } else {
+            i++;
+        }
+    }
+
+    /* Partial selection of the top N; entries no longer move from here on */
+    top_heap_t cpu_heap = { .count = 0, .limit = top_n, .by_rss = false };
+    top_heap_t rss_heap = { .count = 0, .limit = top_n, .by_rss = true };
+
+    for (uint32_t i = 0; i < table_size; i++) {
+        if (table[i].pid != 0) {
+            heap_offer(&cpu_heap, &table[i]);
+            heap_offer(&rss_heap, &table[i]);
+        }
+    }
+
+    list->cpu_count = heap_drain(&cpu_heap, list->by_cpu);
+    list->rss_count = heap_drain(&rss_heap, list->by_rss);
+    list->total_processes = total;
+    return true;
+}
@@ -0,0 +1,59 @@
+#ifndef METRICS_PSI_H
+#define METRICS_PSI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Resources covered by /proc/pressure */
+typedef enum {
+    PSI_CPU = 0,
+    PSI_MEMORY,
+    PSI_IO,
+    PSI_RESOURCE_COUNT
+} psi_resource_t;
+
+/* One "some" or "full" line: percentage of wall time stalled */
+typedef struct {
+    double avg10;
+    double avg60;
+    double avg300;
+    uint64_t total_us;      /* Cumulative stall time */
+} psi_line_t;
+
+typedef struct {
+    bool available;
+    bool has_full;          /* cpu "full" is missing before Linux 5.13 */
+    bool triggered;         /* A stall trigger fired since the last get */
+    psi_line_t some;        /* At least one task stalled */
+    psi_line_t full;        /* All non-idle tasks stalled */
+} psi_resource_metrics_t;
+
+typedef struct {
+    psi_resource_metrics_t res[PSI_RESOURCE_COUNT];
+} psi_metrics_t;
+
+/* Initialize pressure tracking (call once at startup). With a non-zero
+   window_us a "some" trigger of stall_us per window_us is registered on each
+   resource; the kernel requires window_us to be a multiple of 2 s for
+   unprivileged users. Returns false if PSI is not available at all. */
+bool psi_metrics_init(uint32_t stall_us, uint32_t window_us);
+
+/* Cleanup pressure tracking (call once at shutdown) */
+void psi_metrics_cleanup(void);
+
+/* Read the current averages */
+bool psi_metrics_get(psi_metrics_t *psi);
+
+/* Sleep for up to timeout_ms, returning early (true) as soon as a stall
+   trigger fires. Falls back to a plain sleep when no trigger is armed. */
+bool psi_metrics_wait(int timeout_ms);
+
+/* For callers waiting in their own event loop: the armed trigger fds, to be
+   watched for POLLPRI. Stores up to max and returns how many. */
+int psi_metrics_trigger_fds(int *fds, int max);
+
+/* Report that trigger fd woke the caller, with error set on POLLERR (the
+   fd is then closed here). Returns true if a stall trigger fired. */
+bool psi_metrics_trigger_ready(int fd, bool error);
+
+#endif /* METRICS_PSI_H */
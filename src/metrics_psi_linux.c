@@ -0,0 +1,189 @@
+#include "metrics_psi.h"
+#include "procfs.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PSI_BUF_SIZE 256
+
+static const char *const psi_paths[PSI_RESOURCE_COUNT] = {
+    "/proc/pressure/cpu",
+    "/proc/pressure/memory",
+    "/proc/pressure/io",
+};
+
+/* Read side: one persistent fd per resource */
+static procfs_file_t psi_files[PSI_RESOURCE_COUNT] = {
+    PROCFS_FILE_INIT,
+    PROCFS_FILE_INIT,
+    PROCFS_FILE_INIT,
+};
+
+/* Trigger side: a trigger lives as long as the fd it was written to, so
+   these are separate fds that are never read */
+static int trigger_fds[PSI_RESOURCE_COUNT] = { -1, -1, -1 };
+static bool triggered[PSI_RESOURCE_COUNT];
+
+/* Register "some <stall> <window>" on path; returns the fd or -1 */
+static int open_trigger(const char *path, uint32_t stall_us, uint32_t window_us) {
+    int fd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+
+    char trig[64];
+    int n = snprintf(trig, sizeof(trig), "some %u %u", stall_us, window_us);
+    /* The kernel expects the terminating NUL as part of the write */
+    if (write(fd, trig, (size_t)n + 1) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Parse "avg10=0.12 avg60=0.05 avg300=0.01 total=12345" after the tag */
+static bool parse_psi_line(const char *p, const char *end, psi_line_t *out) {
+    static const char *const keys[] = { "avg10=", "avg60=", "avg300=" };
+    double *avgs[] = { &out->avg10, &out->avg60, &out->avg300 };
+
+    for (int k = 0; k < 3; k++) {
+        p = procfs_skip_blanks(p, end);
+        if (!procfs_has_prefix(p, end, keys[k])) return false;
+        p = procfs_parse_decimal(p + strlen(keys[k]), end, avgs[k]);
+        if (!p) return false;
+    }
+
+    p = procfs_skip_blanks(p, end);
+    if (!procfs_has_prefix(p, end, "total=")) return false;
+    return procfs_parse_u64(p + 6, end, &out->total_us) != NULL;
+}
+
+bool psi_metrics_init(uint32_t stall_us, uint32_t window_us) {
+    psi_metrics_cleanup();
+
+    bool any = false;
+    for (int r = 0; r < PSI_RESOURCE_COUNT; r++) {
+        if (!procfs_open(&psi_files[r], psi_paths[r], PSI_BUF_SIZE)) {
+            continue;
+        }
+        procfs_batch_add(&psi_files[r]);
+        any = true;
+
+        if (window_us > 0) {
+            trigger_fds[r] = open_trigger(psi_paths[r], stall_us, window_us);
+        }
+    }
+
+    return any;
+}
+
+void psi_metrics_cleanup(void) {
+    for (int r = 0; r < PSI_RESOURCE_COUNT; r++) {
+        procfs_close(&psi_files[r]);
+        if (trigger_fds[r] >= 0) {
+            close(trigger_fds[r]);
+            trigger_fds[r] = -1;
+        }
+        triggered[r] = false;
+    }
+}
+
+bool psi_metrics_get(psi_metrics_t *psi) {
+    bool any = false;
+
+    for (int r = 0; r < PSI_RESOURCE_COUNT; r++) {
+        psi_resource_metrics_t *out = &psi->res[r];
+        memset(out, 0, sizeof(*out));
+
+        if (!procfs_read(&psi_files[r])) {
+            continue;
+        }
+
+        const char *p = psi_files[r].buf;
+        const char *end = p + psi_files[r].len;
+
+        while (p < end) {
+            const char *next = procfs_next_line(p, end);
+            if (procfs_has_prefix(p, next, "some ")) {
+                out->available = parse_psi_line(p + 5, next, &out->some);
+            } else if (procfs_has_prefix(p, next, "full ")) {
+                out->has_full = parse_psi_line(p + 5, next, &out->full);
+            }
+            p = next;
+        }
+
+        out->triggered = triggered[r];
+        triggered[r] = false;
+        any = any || out->available;
+    }
+
+    return any;
+}
+
+/* Record a wakeup on resource r's trigger; true if it fired */
+static bool trigger_ready(int r, bool error) {
+    if (error) {
+        /* The monitor went away (e.g. cgroup removed); stop polling it */
+        close(trigger_fds[r]);
+        trigger_fds[r] = -1;
+        return false;
+    }
+    triggered[r] = true;
+    return true;
+}
+
+bool psi_metrics_wait(int timeout_ms) {
+    struct pollfd pfds[PSI_RESOURCE_COUNT];
+    int owner[PSI_RESOURCE_COUNT];
+    int nfds = 0;
+
+    for (int r = 0; r < PSI_RESOURCE_COUNT; r++) {
+        if (trigger_fds[r] >= 0) {
+            pfds[nfds].fd = trigger_fds[r];
+            pfds[nfds].events = POLLPRI;
+            pfds[nfds].revents = 0;
+            owner[nfds] = r;
+            nfds++;
+        }
+    }
+
+    if (nfds == 0) {
+        usleep((useconds_t)timeout_ms * 1000);
+        return false;
+    }
+
+    /* A signal (e.g. SIGINT) ends the wait early; the caller re-checks */
+    int ready = poll(pfds, (nfds_t)nfds, timeout_ms);
+    if (ready <= 0) {
+        return false;
+    }
+
+    bool fired = false;
+    for (int i = 0; i < nfds; i++) {
+        if (pfds[i].revents & (POLLERR | POLLPRI)) {
+            fired = trigger_ready(owner[i], pfds[i].revents & POLLERR) || fired;
+        }
+    }
+    return fired;
+}
+
+int psi_metrics_trigger_fds(int *fds, int max) {
+    int count = 0;
+    for (int r = 0; r < PSI_RESOURCE_COUNT && count < max; r++) {
+        if (trigger_fds[r] >= 0) {
+            fds[count++] = trigger_fds[r];
+        }
+    }
+    return count;
+}
+
+bool psi_metrics_trigger_ready(int fd, bool error) {
+    for (int r = 0; r < PSI_RESOURCE_COUNT; r++) {
+        if (fd >= 0 && trigger_fds[r] == fd) {
+            return trigger_ready(r, error);
+        }
+    }
+    return false;
+}
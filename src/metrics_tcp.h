@@ -0,0 +1,43 @@
+#ifndef METRICS_TCP_H
+#define METRICS_TCP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Socket counts by state, IPv4 and IPv6 together */
+typedef struct {
+    uint32_t established;
+    uint32_t syn_sent;
+    uint32_t syn_recv;
+    uint32_t fin_wait;          /* FIN_WAIT1 + FIN_WAIT2 */
+    uint32_t time_wait;
+    uint32_t close_wait;
+    uint32_t last_ack;
+    uint32_t closing;
+    uint32_t listen;
+    uint32_t total;
+    uint32_t listen_full;       /* Listeners whose accept queue reached the backlog */
+    bool has_listen_stats;      /* TcpExt counters below were read */
+    double listen_overflow_rate;    /* ListenOverflows per second */
+    double listen_drop_rate;        /* ListenDrops per second */
+} tcp_metrics_t;
+
+/* Open the NETLINK_SOCK_DIAG socket and <proc_root>/net/netstat (NULL
+   for "/proc"). Returns false if sock_diag is unavailable. */
+bool tcp_metrics_init(const char *proc_root);
+
+/* Close the socket and files (call once at shutdown) */
+void tcp_metrics_cleanup(void);
+
+/* Dump TCP sockets through sock_diag and count them by state. Replies are
+   aggregated as they arrive; no per-socket data is kept. */
+bool tcp_metrics_get(tcp_metrics_t *tcp);
+
+/* Add the inet_diag_msg replies to request seq in one netlink datagram to
+   tcp; stale replies to earlier requests are skipped. Returns 1 at
+   NLMSG_DONE, 0 if more datagrams follow, -1 on an error reply (exposed
+   for testing). */
+int tcp_diag_accumulate(const void *buf, size_t len, uint32_t seq, tcp_metrics_t *tcp);
+
+#endif /* METRICS_TCP_H */
@@ -0,0 +1,234 @@
+#include "metrics_tcp.h"
+#include "procfs.h"
+#include <errno.h>
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define NETSTAT_BUF_SIZE 8192
+#define PROC_PATH_LEN 256
+/* Large enough that a dump of 500k sockets takes few recv() calls */
+#define DIAG_BUF_SIZE (256 * 1024)
+
+/* States worth counting; TCP_CLOSE (unbound or unconnected) is left out */
+#define TCP_STATE_MASK ((1u << TCP_ESTABLISHED) | (1u << TCP_SYN_SENT) | \
+                        (1u << TCP_SYN_RECV) | (1u << TCP_FIN_WAIT1) | \
+                        (1u << TCP_FIN_WAIT2) | (1u << TCP_TIME_WAIT) | \
+                        (1u << TCP_CLOSE_WAIT) | (1u << TCP_LAST_ACK) | \
+                        (1u << TCP_LISTEN) | (1u << TCP_CLOSING))
+
+static int diag_fd = -1;
+static uint32_t diag_seq = 0;
+static uint64_t diag_buf[DIAG_BUF_SIZE / sizeof(uint64_t)];     /* Aligned for nlmsghdr */
+
+/* TcpExt listen counters from net/netstat */
+static procfs_file_t netstat_file = PROCFS_FILE_INIT;
+static uint64_t prev_overflows = 0;
+static uint64_t prev_drops = 0;
+static double prev_when = 0.0;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* "TcpExt: name name ..." is followed by "TcpExt: value value ..." */
+static bool read_listen_counters(uint64_t *overflows, uint64_t *drops) {
+    if (!procfs_read(&netstat_file)) {
+        return false;
+    }
+
+    const char *p = netstat_file.buf;
+    const char *end = p + netstat_file.len;
+    while (p < end && !procfs_has_prefix(p, end, "TcpExt:")) {
+        p = procfs_next_line(p, end);
+    }
+    if (p >= end) {
+        return false;
+    }
+
+    const char *names = p + 7;
+    const char *values = procfs_next_line(p, end);
+    if (!procfs_has_prefix(values, end, "TcpExt:")) {
+        return false;
+    }
+    values += 7;
+
+    int found = 0;
+    while (names < end && *names != '\n' && found < 2) {
+        names = procfs_skip_blanks(names, end);
+        const char *name_end = names;
+        while (name_end < end && *name_end != ' ' && *name_end != '\n') name_end++;
+
+        uint64_t value;
+        const char *next = procfs_parse_u64(values, end, &value);
+        if (!next) {
+            return false;
+        }
+        values = next;
+
+        size_t n = (size_t)(name_end - names);
+        if (n == 15 && memcmp(names, "ListenOverflows", n) == 0) {
+            *overflows = value;
+            found++;
+        } else if (n == 11 && memcmp(names, "ListenDrops", n) == 0) {
+            *drops = value;
+            found++;
+        }
+        names = name_end;
+    }
+    return found == 2;
+}
+
+bool tcp_metrics_init(const char *proc_root) {
+    tcp_metrics_cleanup();
+
+    diag_fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    if (diag_fd < 0) {
+        return false;
+    }
+
+    char path[PROC_PATH_LEN];
+    snprintf(path, sizeof(path), "%s/net/netstat", proc_root ? proc_root : "/proc");
+    if (procfs_open(&netstat_file, path, NETSTAT_BUF_SIZE)) {
+        if (read_listen_counters(&prev_overflows, &prev_drops)) {
+            procfs_batch_add(&netstat_file);
+        } else {
+            procfs_close(&netstat_file);
+        }
+    }
+    prev_when = now_seconds();
+    return true;
+}
+
+void tcp_metrics_cleanup(void) {
+    if (diag_fd >= 0) {
+        close(diag_fd);
+        diag_fd = -1;
+    }
+    procfs_close(&netstat_file);
+}
+
+static void count_socket(const struct inet_diag_msg *msg, tcp_metrics_t *tcp) {
+    switch (msg->idiag_state) {
+    case TCP_ESTABLISHED: tcp->established++; break;
+    case TCP_SYN_SENT:    tcp->syn_sent++; break;
+    case TCP_SYN_RECV:    tcp->syn_recv++; break;
+    case TCP_FIN_WAIT1:
+    case TCP_FIN_WAIT2:   tcp->fin_wait++; break;
+    case TCP_TIME_WAIT:   tcp->time_wait++; break;
+    case TCP_CLOSE_WAIT:  tcp->close_wait++; break;
+    case TCP_LAST_ACK:    tcp->last_ack++; break;
+    case TCP_CLOSING:     tcp->closing++; break;
+    case TCP_LISTEN:
+        tcp->listen++;
+        /* For listeners rqueue is the accept queue, wqueue the backlog */
+        if (msg->idiag_wqueue > 0 && msg->idiag_rqueue >= msg->idiag_wqueue) {
+            tcp->listen_full++;
+        }
+        break;
+    default:
+        return;
+    }
+    tcp->total++;
+}
+
+int tcp_diag_accumulate(const void *buf, size_t len, uint32_t seq, tcp_metrics_t *tcp) {
+    const struct nlmsghdr *h = buf;
+    int remaining = (int)len;
+
+    for (; NLMSG_OK(h, remaining); h = NLMSG_NEXT(h, remaining)) {
+        if (h->nlmsg_seq != seq) {
+            continue;
+        }
+        if (h->nlmsg_type == NLMSG_DONE) {
+            return 1;
+        }
+        if (h->nlmsg_type == NLMSG_ERROR) {
+            return -1;
+        }
+        if (h->nlmsg_type == SOCK_DIAG_BY_FAMILY &&
+            h->nlmsg_len >= NLMSG_LENGTH(sizeof(struct inet_diag_msg))) {
+            count_socket(NLMSG_DATA(h), tcp);
+        }
+    }
+    return 0;
+}
+
+/* One dump request per address family */
+static bool dump_family(uint8_t family, tcp_metrics_t *tcp) {
+    struct {
+        struct nlmsghdr nlh;
+        struct inet_diag_req_v2 req;
+    } msg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.nlh.nlmsg_len = sizeof(msg);
+    msg.nlh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    msg.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    msg.nlh.nlmsg_seq = ++diag_seq;
+    msg.req.sdiag_family = family;
+    msg.req.sdiag_protocol = IPPROTO_TCP;
+    msg.req.idiag_states = TCP_STATE_MASK;
+    /* No extensions: each reply is just the fixed inet_diag_msg */
+    msg.req.idiag_ext = 0;
+
+    struct sockaddr_nl kernel = { .nl_family = AF_NETLINK };
+    if (sendto(diag_fd, &msg, sizeof(msg), 0, (struct sockaddr *)&kernel,
+               sizeof(kernel)) < 0) {
+        return false;
+    }
+
+    for (;;) {
+        ssize_t n = recv(diag_fd, diag_buf, sizeof(diag_buf), 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) {
+            return false;
+        }
+        int status = tcp_diag_accumulate(diag_buf, (size_t)n, diag_seq, tcp);
+        if (status != 0) {
+            return status > 0;
+        }
+    }
+}
+
+bool tcp_metrics_get(tcp_metrics_t *tcp) {
+    memset(tcp, 0, sizeof(*tcp));
+    if (diag_fd < 0) {
+        return false;
+    }
+
+    if (!dump_family(AF_INET, tcp)) {
+        return false;
+    }
+    /* Hosts without IPv6 answer with an error; keep the IPv4 counts */
+    dump_family(AF_INET6, tcp);
+
+    uint64_t overflows, drops;
+    if (netstat_file.fd >= 0 && read_listen_counters(&overflows, &drops)) {
+        double when = now_seconds();
+        double elapsed = when - prev_when;
+        if (elapsed > 0.0) {
+            tcp->listen_overflow_rate = overflows >= prev_overflows
+                                            ? (double)(overflows - prev_overflows) / elapsed : 0.0;
+            tcp->listen_drop_rate = drops >= prev_drops
+                                        ? (double)(drops - prev_drops) / elapsed : 0.0;
+        }
+        tcp->has_listen_stats = true;
+        prev_overflows = overflows;
+        prev_drops = drops;
+        prev_when = when;
+    }
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef METRICS_THERMAL_H
+#define METRICS_THERMAL_H
+
+#include <stdbool.h>
+
+#define MAX_THERMAL_PACKAGES 8
+#define MAX_THERMAL_CORES 256
+#define THERMAL_LABEL_LEN 16
+
+typedef struct {
+    char label[THERMAL_LABEL_LEN];  /* e.g. "Pkg0", "Core3", "Tccd1" */
+    int package;                    /* Package index, 0 if unknown */
+    int celsius;                    /* -1 if the last read failed */
+} thermal_sensor_t;
+
+typedef struct {
+    int cpu_celsius;                /* Hottest package, -1 if none */
+    int package_count;
+    thermal_sensor_t packages[MAX_THERMAL_PACKAGES];
+    int core_count;                 /* Per core (Intel) or per CCD (AMD) */
+    thermal_sensor_t cores[MAX_THERMAL_CORES];
+} thermal_metrics_t;
+
+/* Discover CPU temperature sensors under sysfs_root (NULL for "/sys"):
+   coretemp/k10temp/zenpower hwmon devices, falling back to CPU thermal
+   zones. Sensor files stay open until cleanup. Returns false if no CPU
+   sensor was found. */
+bool thermal_metrics_init(const char *sysfs_root);
+
+/* Close all sensor files (call once at shutdown) */
+void thermal_metrics_cleanup(void);
+
+/* Re-read every discovered sensor */
+bool thermal_metrics_get(thermal_metrics_t *thermal);
+
+#endif /* METRICS_THERMAL_H */
@@ -0,0 +1,262 @@
+#include "metrics_thermal.h"
+#include "procfs.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SENSOR_BUF_SIZE 32
+/* Nested so each level always fits in the next one's buffer */
+#define SYSFS_CLASS_LEN 384
+#define SYSFS_DEVICE_LEN 448
+#define SYSFS_PATH_LEN 512
+#define MAX_SCAN_ENTRIES 512
+
+/* An open temp*_input (millidegrees) and what it measures */
+typedef struct {
+    procfs_file_t file;
+    thermal_sensor_t info;
+} sensor_slot_t;
+
+static sensor_slot_t package_slots[MAX_THERMAL_PACKAGES];
+static int package_slot_count = 0;
+static sensor_slot_t core_slots[MAX_THERMAL_CORES];
+static int core_slot_count = 0;
+
+/* Read a small sysfs attribute into buf without the trailing newline */
+static bool read_attr(const char *path, char *buf, size_t size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t n = read(fd, buf, size - 1);
+    close(fd);
+    if (n <= 0) {
+        return false;
+    }
+    while (n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == ' ')) n--;
+    buf[n] = '\0';
+    return true;
+}
+
+static int compare_ints(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/* Collect N from entries named "<prefix>N<suffix>" in dir, sorted, so
+   discovery order does not depend on readdir order */
+static int scan_indices(const char *dir, const char *prefix, const char *suffix,
+                        int *out, int max) {
+    DIR *d = opendir(dir);
+    if (!d) {
+        return 0;
+    }
+
+    size_t prefix_len = strlen(prefix);
+    int count = 0;
+    struct dirent *ent;
+
+    while ((ent = readdir(d)) != NULL && count < max) {
+        const char *name = ent->d_name;
+        if (strncmp(name, prefix, prefix_len) != 0) continue;
+
+        const char *p = name + prefix_len;
+        if (*p < '0' || *p > '9') continue;
+        int index = 0;
+        while (*p >= '0' && *p <= '9') index = index * 10 + (*p++ - '0');
+        if (strcmp(p, suffix) != 0) continue;
+
+        out[count++] = index;
+    }
+
+    closedir(d);
+    qsort(out, (size_t)count, sizeof(int), compare_ints);
+    return count;
+}
+
+static bool add_sensor(sensor_slot_t *slots, int *count, int max, const char *input_path,
+                       const char *label, int package) {
+    if (*count >= max) {
+        return false;
+    }
+
+    sensor_slot_t *s = &slots[*count];
+    if (!procfs_open(&s->file, input_path, SENSOR_BUF_SIZE)) {
+        return false;
+    }
+    procfs_batch_add(&s->file);
+    snprintf(s->info.label, sizeof(s->info.label), "%s", label);
+    s->info.package = package;
+    s->info.celsius = -1;
+    (*count)++;
+    return true;
+}
+
+/* coretemp: "Package id N" and "Core M" labels; k10temp and zenpower:
+   Tctl/Tdie for the package and TccdN per core complex */
+static void scan_cpu_hwmon(const char *dev_dir, const char *driver, int ordinal) {
+    int indices[MAX_SCAN_ENTRIES];
+    int n = scan_indices(dev_dir, "temp", "_input", indices, MAX_SCAN_ENTRIES);
+    bool is_coretemp = strcmp(driver, "coretemp") == 0;
+
+    int package = ordinal;
+    char pkg_input[SYSFS_PATH_LEN] = "";
+    bool have_tdie = false;
+    int first_core = core_slot_count;
+
+    for (int i = 0; i < n; i++) {
+        char path[SYSFS_PATH_LEN], label[64] = "";
+        snprintf(path, sizeof(path), "%s/temp%d_label", dev_dir, indices[i]);
+        read_attr(path, label, sizeof(label));
+        snprintf(path, sizeof(path), "%s/temp%d_input", dev_dir, indices[i]);
+
+        if (is_coretemp && strncmp(label, "Package id ", 11) == 0) {
+            package = atoi(label + 11);
+            snprintf(pkg_input, sizeof(pkg_input), "%s", path);
+        } else if (is_coretemp && strncmp(label, "Core ", 5) == 0) {
+            char core_label[THERMAL_LABEL_LEN];
+            snprintf(core_label, sizeof(core_label), "Core%d", atoi(label + 5));
+            add_sensor(core_slots, &core_slot_count, MAX_THERMAL_CORES, path, core_label, package);
+        } else if (!is_coretemp && strcmp(label, "Tdie") == 0) {
+            snprintf(pkg_input, sizeof(pkg_input), "%s", path);
+            have_tdie = true;
+        } else if (!is_coretemp && strcmp(label, "Tctl") == 0 && !have_tdie) {
+            /* Tctl carries a fan-curve offset on some parts; Tdie wins */
+            snprintf(pkg_input, sizeof(pkg_input), "%s", path);
+        } else if (!is_coretemp && strncmp(label, "Tccd", 4) == 0) {
+            add_sensor(core_slots, &core_slot_count, MAX_THERMAL_CORES, path, label, package);
+        } else if (label[0] == '\0' && pkg_input[0] == '\0') {
+            /* Unlabelled single-sensor drivers such as cpu_thermal */
+            snprintf(pkg_input, sizeof(pkg_input), "%s", path);
+        }
+    }
+
+    /* Core labels seen before the package label belong to it too */
+    for (int i = first_core; i < core_slot_count; i++) {
+        core_slots[i].info.package = package;
+    }
+
+    if (pkg_input[0] != '\0') {
+        char pkg_label[THERMAL_LABEL_LEN];
+        snprintf(pkg_label, sizeof(pkg_label), "Pkg%d", package);
+        add_sensor(package_slots, &package_slot_count, MAX_THERMAL_PACKAGES,
+                   pkg_input, pkg_label, package);
+    }
+}
+
+static bool is_cpu_hwmon(const char *driver) {
+    return strcmp(driver, "coretemp") == 0 ||
+           strcmp(driver, "k10temp") == 0 ||
+           strcmp(driver, "zenpower") == 0 ||
+           strcmp(driver, "cpu_thermal") == 0;
+}
+
+static void scan_hwmon(const char *root) {
+    char class_dir[SYSFS_CLASS_LEN];
+    snprintf(class_dir, sizeof(class_dir), "%s/class/hwmon", root);
+
+    int indices[MAX_SCAN_ENTRIES];
+    int n = scan_indices(class_dir, "hwmon", "", indices, MAX_SCAN_ENTRIES);
+    int ordinal = 0;
+
+    for (int i = 0; i < n; i++) {
+        char dev_dir[SYSFS_DEVICE_LEN], path[SYSFS_PATH_LEN], driver[64];
+        snprintf(dev_dir, sizeof(dev_dir), "%s/hwmon%d", class_dir, indices[i]);
+        snprintf(path, sizeof(path), "%s/name", dev_dir);
+
+        if (read_attr(path, driver, sizeof(driver)) && is_cpu_hwmon(driver)) {
+            scan_cpu_hwmon(dev_dir, driver, ordinal++);
+        }
+    }
+}
+
+/* Thermal zones that track the CPU die, for when no hwmon driver matched.
+   acpitz is only used as a last resort: it is often a board sensor. */
+static void scan_thermal_zones(const char *root, bool allow_acpi) {
+    char class_dir[SYSFS_CLASS_LEN];
+    snprintf(class_dir, sizeof(class_dir), "%s/class/thermal", root);
+
+    int indices[MAX_SCAN_ENTRIES];
+    int n = scan_indices(class_dir, "thermal_zone", "", indices, MAX_SCAN_ENTRIES);
+
+    for (int i = 0; i < n; i++) {
+        char path[SYSFS_PATH_LEN], type[64];
+        snprintf(path, sizeof(path), "%s/thermal_zone%d/type", class_dir, indices[i]);
+        if (!read_attr(path, type, sizeof(type))) continue;
+
+        bool cpu_zone = strcmp(type, "x86_pkg_temp") == 0 ||
+                        strncmp(type, "cpu", 3) == 0 ||
+                        strncmp(type, "soc", 3) == 0;
+        if (!cpu_zone && !(allow_acpi && strcmp(type, "acpitz") == 0)) continue;
+
+        char label[THERMAL_LABEL_LEN];
+        snprintf(label, sizeof(label), "Pkg%d", package_slot_count);
+        snprintf(path, sizeof(path), "%s/thermal_zone%d/temp", class_dir, indices[i]);
+        add_sensor(package_slots, &package_slot_count, MAX_THERMAL_PACKAGES,
+                   path, label, package_slot_count);
+    }
+}
+
+static int read_celsius(procfs_file_t *file) {
+    uint64_t millideg;
+    if (!procfs_read(file) ||
+        !procfs_parse_u64(file->buf, file->buf + file->len, &millideg)) {
+        return -1;
+    }
+    return (int)((millideg + 500) / 1000);
+}
+
+bool thermal_metrics_init(const char *sysfs_root) {
+    thermal_metrics_cleanup();
+
+    const char *root = sysfs_root ? sysfs_root : "/sys";
+
+    scan_hwmon(root);
+    if (package_slot_count == 0) {
+        scan_thermal_zones(root, false);
+    }
+    if (package_slot_count == 0) {
+        scan_thermal_zones(root, true);
+    }
+
+    return package_slot_count > 0 || core_slot_count > 0;
+}
+
+void thermal_metrics_cleanup(void) {
+    for (int i = 0; i < package_slot_count; i++) {
+        procfs_close(&package_slots[i].file);
+    }
+    for (int i = 0; i < core_slot_count; i++) {
+        procfs_close(&core_slots[i].file);
+    }
+    package_slot_count = 0;
+    core_slot_count = 0;
+}
+
+bool thermal_metrics_get(thermal_metrics_t *thermal) {
+    thermal->cpu_celsius = -1;
+    thermal->package_count = package_slot_count;
+    thermal->core_count = core_slot_count;
+
+    for (int i = 0; i < package_slot_count; i++) {
+        package_slots[i].info.celsius = read_celsius(&package_slots[i].file);
+        thermal->packages[i] = package_slots[i].info;
+        if (package_slots[i].info.celsius > thermal->cpu_celsius) {
+            thermal->cpu_celsius = package_slots[i].info.celsius;
+        }
+    }
+
+    for (int i = 0; i < core_slot_count; i++) {
+        core_slots[i].info.celsius = read_celsius(&core_slots[i].file);
+        thermal->cores[i] = core_slots[i].info;
+        /* No package sensor (e.g. k10temp without Tctl): use the hottest core */
+        if (package_slot_count == 0 && core_slots[i].info.celsius > thermal->cpu_celsius) {
+            thermal->cpu_celsius = core_slots[i].info.celsius;
+        }
+    }
+
+    return thermal->cpu_celsius >= 0;
+}
@@ -87,6 +87,13 @@ bool metrics_get_cpu(cpu_metrics_t *cpu) {
     return true;
 }
 
+bool metrics_get_cpu_cores(cpu_core_metrics_t *cores) {
+    /* GetSystemTimes only reports system-wide totals. Per-core times need
+       NtQuerySystemInformation, which is not wired up yet. */
+    cores->count = 0;
+    return false;
+}
+
 bool metrics_get_memory(memory_metrics_t *mem) {
     MEMORYSTATUSEX statex;
     statex.dwLength = sizeof(statex);
@@ -95,6 +102,7 @@ bool metrics_get_memory(memory_metrics_t *mem) {
         return false;
     }
 
+    memset(mem, 0, sizeof(*mem));
     mem->total_bytes = statex.ullTotalPhys;
     mem->free_bytes = statex.ullAvailPhys;
     mem->used_bytes = mem->total_bytes - mem->free_bytes;
@@ -103,6 +111,11 @@ bool metrics_get_memory(memory_metrics_t *mem) {
     return true;
 }
 
+/* No breakdown sources wired up on this platform yet */
+void metrics_set_memory_fields(unsigned fields) {
+    (void)fields;
+}
+
 bool metrics_get_disk(const char *mount_point, disk_metrics_t *disk) {
     ULARGE_INTEGER free_bytes_available;
     ULARGE_INTEGER total_bytes;
@@ -134,8 +147,11 @@ bool metrics_get_disk(const char *mount_point, disk_metrics_t *disk) {
 
 bool metrics_get_disks(const char **mount_points, int count, disk_metrics_list_t *disks) {
     disks->count = 0;
+    if (!metrics_reserve_disks(disks, count)) {
+        return false;
+    }
 
-    for (int i = 0; i < count && i < MAX_DISKS; i++) {
+    for (int i = 0; i < count; i++) {
         if (metrics_get_disk(mount_points[i], &disks->disks[disks->count])) {
             disks->count++;
         }
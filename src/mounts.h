@@ -0,0 +1,30 @@
+#ifndef MOUNTS_H
+#define MOUNTS_H
+
+#include <stdbool.h>
+
+/* Which mounts discovery reports. With no fstypes, filesystems the kernel
+   lists as "nodev" in /proc/filesystems (proc, tmpfs, cgroup, ...) are
+   skipped; with no patterns every mount point matches. */
+typedef struct {
+    const char **fstypes;       /* Exact filesystem type names */
+    int fstype_count;
+    const char **patterns;      /* fnmatch() globs on the mount point */
+    int pattern_count;
+} mount_filter_t;
+
+/* Start watching a mountinfo file (NULL for /proc/self/mountinfo) and do
+   the first parse. The filter is copied. */
+bool mounts_init(const char *mountinfo_path, const mount_filter_t *filter);
+
+/* Stop watching and free the mount list */
+void mounts_cleanup(void);
+
+/* Re-parse only if the kernel flagged a mount table change since the last
+   call (POLLPRI on the mountinfo fd); returns true if the list changed */
+bool mounts_refresh(void);
+
+/* Current matching mount points, valid until the next refresh or cleanup */
+const char **mounts_get(int *count);
+
+#endif /* MOUNTS_H */
@@ -0,0 +1,286 @@
+#include "mounts.h"
+#include "procfs.h"
+#include <fnmatch.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MOUNTINFO_BUF_SIZE 65536
+#define FILESYSTEMS_BUF_SIZE 4096
+#define FSTYPE_LEN 32
+
+static procfs_file_t mountinfo_file = PROCFS_FILE_INIT;
+
+/* Filter copies: fixed-width names in one allocation each */
+static char (*fstypes)[FSTYPE_LEN] = NULL;
+static int fstype_count = 0;
+static char **patterns = NULL;
+static int pattern_count = 0;
+
+/* Filesystem types that have no backing device, used when no fstype
+   filter is configured */
+static char (*nodev_types)[FSTYPE_LEN] = NULL;
+static int nodev_count = 0;
+
+/* Mount points are stored NUL-separated in one arena, with an index of
+   pointers into it. Both are rebuilt on each re-parse. */
+static char *arena = NULL;
+static const char **paths = NULL;
+static int path_count = 0;
+
+static bool in_type_list(char (*list)[FSTYPE_LEN], int count, const char *type) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(list[i], type) == 0) return true;
+    }
+    return false;
+}
+
+/* Read the "nodev" entries of /proc/filesystems */
+static void load_nodev_types(void) {
+    procfs_file_t f;
+    if (!procfs_open(&f, "/proc/filesystems", FILESYSTEMS_BUF_SIZE) || !procfs_read(&f)) {
+        procfs_close(&f);
+        return;
+    }
+
+    const char *p = f.buf;
+    const char *end = p + f.len;
+    int cap = 0;
+
+    while (p < end) {
+        const char *next = procfs_next_line(p, end);
+        if (procfs_has_prefix(p, next, "nodev\t")) {
+            if (nodev_count == cap) {
+                int new_cap = cap > 0 ? cap * 2 : 32;
+                char (*grown)[FSTYPE_LEN] = realloc(nodev_types, (size_t)new_cap * FSTYPE_LEN);
+                if (!grown) break;
+                nodev_types = grown;
+                cap = new_cap;
+            }
+            const char *name = p + 6;
+            size_t len = (size_t)(next - name);
+            if (len > 0 && name[len - 1] == '\n') len--;
+            if (len >= FSTYPE_LEN) len = FSTYPE_LEN - 1;
+            memcpy(nodev_types[nodev_count], name, len);
+            nodev_types[nodev_count][len] = '\0';
+            nodev_count++;
+        }
+        p = next;
+    }
+
+    procfs_close(&f);
+}
+
+static bool mount_wanted(const char *mount_point, const char *fstype) {
+    if (fstype_count > 0) {
+        if (!in_type_list(fstypes, fstype_count, fstype)) return false;
+    } else if (in_type_list(nodev_types, nodev_count, fstype)) {
+        return false;
+    }
+
+    if (pattern_count == 0) {
+        return true;
+    }
+    for (int i = 0; i < pattern_count; i++) {
+        if (fnmatch(patterns[i], mount_point, 0) == 0) return true;
+    }
+    return false;
+}
+
+/* Copy one space-terminated mountinfo field, decoding the \ooo octal
+   escapes the kernel uses for spaces, tabs, newlines and backslashes */
+static size_t decode_field(const char *p, const char *end, char *out) {
+    size_t n = 0;
+    while (p < end && *p != ' ') {
+        if (*p == '\\' && end - p >= 4 &&
+            p[1] >= '0' && p[1] <= '7' && p[2] >= '0' && p[2] <= '7' && p[3] >= '0' && p[3] <= '7') {
+            out[n++] = (char)(((p[1] - '0') << 6) | ((p[2] - '0') << 3) | (p[3] - '0'));
+            p += 4;
+        } else {
+            out[n++] = *p++;
+        }
+    }
+    out[n] = '\0';
+    return n;
+}
+
+/* Advance past n space-separated fields */
+static const char *skip_fields(const char *p, const char *end, int n) {
+    for (int i = 0; i < n && p; i++) {
+        const char *sp = memchr(p, ' ', (size_t)(end - p));
+        p = sp ? sp + 1 : NULL;
+    }
+    return p;
+}
+
+/* Rebuild the mount list from the current mountinfo contents. Returns
+   true if the result differs from the previous list. */
+static bool parse_mountinfo(void) {
+    if (!procfs_read(&mountinfo_file)) {
+        return false;
+    }
+
+    const char *buf = mountinfo_file.buf;
+    const char *end = buf + mountinfo_file.len;
+
+    /* Decoded paths are never longer than the file itself */
+    char *new_arena = malloc(mountinfo_file.len + 1);
+    if (!new_arena) {
+        return false;
+    }
+
+    const char **new_paths = NULL;
+    int new_count = 0, new_cap = 0;
+    size_t used = 0;
+
+    for (const char *p = buf; p < end; ) {
+        const char *next = procfs_next_line(p, end);
+        const char *line_end = (next > p && next[-1] == '\n') ? next - 1 : next;
+
+        /* "id parent maj:min root mount_point opts [tags...] - fstype source opts" */
+        const char *mp = skip_fields(p, line_end, 4);
+        const char *sep = NULL;
+        for (const char *q = mp; q && q + 3 <= line_end; q++) {
+            if (q[0] == ' ' && q[1] == '-' && q[2] == ' ') { sep = q + 3; break; }
+        }
+        if (!mp || !sep) {
+            p = next;
+            continue;
+        }
+
+        char fstype[FSTYPE_LEN];
+        const char *type_end = memchr(sep, ' ', (size_t)(line_end - sep));
+        size_t type_len = (size_t)((type_end ? type_end : line_end) - sep);
+        if (type_len >= FSTYPE_LEN) type_len = FSTYPE_LEN - 1;
+        memcpy(fstype, sep, type_len);
+        fstype[type_len] = '\0';
+
+        char *dst = new_arena + used;
+        size_t len = decode_field(mp, line_end, dst);
+
+        if (mount_wanted(dst, fstype)) {
+            /* Over-mounts repeat a mount point; list it once */
+            bool dup = false;
+            for (int i = 0; i < new_count && !dup; i++) {
+                dup = strcmp(new_paths[i], dst) == 0;
+            }
+
+            if (!dup) {
+                if (new_count == new_cap) {
+                    int cap = new_cap > 0 ? new_cap * 2 : 64;
+                    const char **grown = realloc(new_paths, (size_t)cap * sizeof(*grown));
+                    if (!grown) {
+                        free(new_paths);
+                        free(new_arena);
+                        return false;
+                    }
+                    new_paths = grown;
+                    new_cap = cap;
+                }
+                new_paths[new_count++] = dst;
+                used += len + 1;
+            }
+        }
+        p = next;
+    }
+
+    bool changed = new_count != path_count;
+    for (int i = 0; i < new_count && !changed; i++) {
+        changed = strcmp(new_paths[i], paths[i]) != 0;
+    }
+
+    free(arena);
+    free(paths);
+    arena = new_arena;
+    paths = new_paths;
+    path_count = new_count;
+    return changed;
+}
+
+bool mounts_init(const char *mountinfo_path, const mount_filter_t *filter) {
+    mounts_cleanup();
+
+    if (filter->fstype_count > 0) {
+        fstypes = calloc((size_t)filter->fstype_count, FSTYPE_LEN);
+        if (!fstypes) return false;
+        for (int i = 0; i < filter->fstype_count; i++) {
+            strncpy(fstypes[i], filter->fstypes[i], FSTYPE_LEN - 1);
+        }
+        fstype_count = filter->fstype_count;
+    } else {
+        load_nodev_types();
+    }
+
+    if (filter->pattern_count > 0) {
+        patterns = calloc((size_t)filter->pattern_count, sizeof(char *));
+        if (!patterns) {
+            mounts_cleanup();
+            return false;
+        }
+        for (int i = 0; i < filter->pattern_count; i++) {
+            patterns[i] = strdup(filter->patterns[i]);
+            if (!patterns[i]) {
+                pattern_count = i;
+                mounts_cleanup();
+                return false;
+            }
+        }
+        pattern_count = filter->pattern_count;
+    }
+
+    if (!procfs_open(&mountinfo_file,
+                     mountinfo_path ? mountinfo_path : "/proc/self/mountinfo",
+                     MOUNTINFO_BUF_SIZE)) {
+        mounts_cleanup();
+        return false;
+    }
+
+    parse_mountinfo();
+    return true;
+}
+
+void mounts_cleanup(void) {
+    procfs_close(&mountinfo_file);
+
+    free(fstypes);
+    fstypes = NULL;
+    fstype_count = 0;
+
+    for (int i = 0; i < pattern_count; i++) {
+        free(patterns[i]);
+    }
+    free(patterns);
+    patterns = NULL;
+    pattern_count = 0;
+
+    free(nodev_types);
+    nodev_types = NULL;
+    nodev_count = 0;
+
+    free(arena);
+    arena = NULL;
+    free(paths);
+    paths = NULL;
+    path_count = 0;
+}
+
+bool mounts_refresh(void) {
+    if (mountinfo_file.fd < 0) {
+        return false;
+    }
+
+    /* The kernel raises POLLERR|POLLPRI on mountinfo once per change to the
+       namespace's mount table (reporting it re-arms the fd); a zero timeout
+       keeps this a cheap check on every tick */
+    struct pollfd pfd = { .fd = mountinfo_file.fd, .events = POLLPRI, .revents = 0 };
+    if (poll(&pfd, 1, 0) <= 0 || !(pfd.revents & POLLPRI)) {
+        return false;
+    }
+
+    return parse_mountinfo();
+}
+
+const char **mounts_get(int *count) {
+    *count = path_count;
+    return paths;
+}
@@ -0,0 +1,179 @@
+#include "plugins.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+typedef HMODULE lib_handle_t;
+#define LOAD_LIBRARY(name) LoadLibraryA(name)
+#define GET_PROC(lib, name) GetProcAddress(lib, name)
+#define FREE_LIBRARY(lib) FreeLibrary(lib)
+#else
+#include <dlfcn.h>
+#include <time.h>
+typedef void* lib_handle_t;
+#define LOAD_LIBRARY(name) dlopen(name, RTLD_NOW | RTLD_LOCAL)
+#define GET_PROC(lib, name) dlsym(lib, name)
+#define FREE_LIBRARY(lib) dlclose(lib)
+#endif
+
+typedef struct {
+    lib_handle_t lib;
+    const dashboard_plugin_t *desc;
+    void *state;
+    double values[MAX_PLUGIN_SERIES];
+    uint64_t last_sample_us;
+    bool attempted;                     /* sample() has been called */
+    bool sampled;
+    bool stale;
+    uint32_t measured_cost_us;
+} plugin_slot_t;
+
+static plugin_slot_t slots[MAX_PLUGINS];
+static int slot_count = 0;
+
+static uint64_t now_us(void) {
+#ifdef _WIN32
+    return (uint64_t)GetTickCount64() * 1000;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+#endif
+}
+
+static const char *load_error(void) {
+#ifdef _WIN32
+    static char buf[32];
+    snprintf(buf, sizeof(buf), "error %lu", (unsigned long)GetLastError());
+    return buf;
+#else
+    const char *msg = dlerror();
+    return msg ? msg : "unknown error";
+#endif
+}
+
+/* Reject descriptions this build cannot drive safely */
+static bool check_plugin(const dashboard_plugin_t *desc, char *err, size_t err_size) {
+    if (desc->abi_version != DASHBOARD_PLUGIN_ABI_VERSION) {
+        snprintf(err, err_size, "ABI version %u, expected %u",
+                 (unsigned)desc->abi_version, (unsigned)DASHBOARD_PLUGIN_ABI_VERSION);
+        return false;
+    }
+    if (desc->struct_size < sizeof(dashboard_plugin_t)) {
+        snprintf(err, err_size, "descriptor too small (%u bytes)", (unsigned)desc->struct_size);
+        return false;
+    }
+    if (!desc->name || !desc->sample) {
+        snprintf(err, err_size, "missing name or sample()");
+        return false;
+    }
+    if (desc->series_count < 1 || desc->series_count > MAX_PLUGIN_SERIES || !desc->series) {
+        snprintf(err, err_size, "%d series, expected 1-%d",
+                 desc->series_count, MAX_PLUGIN_SERIES);
+        return false;
+    }
+    for (int i = 0; i < desc->series_count; i++) {
+        if (!desc->series[i].name) {
+            snprintf(err, err_size, "series %d has no name", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool plugins_load(const char *path, char *err, size_t err_size) {
+    if (slot_count >= MAX_PLUGINS) {
+        snprintf(err, err_size, "more than %d plugins", MAX_PLUGINS);
+        return false;
+    }
+
+    lib_handle_t lib = LOAD_LIBRARY(path);
+    if (!lib) {
+        snprintf(err, err_size, "%s", load_error());
+        return false;
+    }
+
+    dashboard_plugin_entry_t entry;
+    *(void **)&entry = (void *)GET_PROC(lib, DASHBOARD_PLUGIN_ENTRY);
+    if (!entry) {
+        snprintf(err, err_size, "no %s symbol", DASHBOARD_PLUGIN_ENTRY);
+        FREE_LIBRARY(lib);
+        return false;
+    }
+
+    const dashboard_plugin_t *desc = entry();
+    if (!desc || !check_plugin(desc, err, err_size)) {
+        if (!desc) snprintf(err, err_size, "%s returned NULL", DASHBOARD_PLUGIN_ENTRY);
+        FREE_LIBRARY(lib);
+        return false;
+    }
+
+    plugin_slot_t *slot = &slots[slot_count];
+    memset(slot, 0, sizeof(*slot));
+    if (desc->init && !desc->init(&slot->state)) {
+        snprintf(err, err_size, "%s: init failed", desc->name);
+        FREE_LIBRARY(lib);
+        return false;
+    }
+
+    slot->lib = lib;
+    slot->desc = desc;
+    slot_count++;
+    return true;
+}
+
+void plugins_cleanup(void) {
+    for (int i = 0; i < slot_count; i++) {
+        if (slots[i].desc->cleanup) {
+            slots[i].desc->cleanup(slots[i].state);
+        }
+        FREE_LIBRARY(slots[i].lib);
+    }
+    slot_count = 0;
+}
+
+bool plugins_get(plugin_metrics_t *plugins) {
+    uint64_t now = now_us();
+
+    plugins->count = slot_count;
+    for (int i = 0; i < slot_count; i++) {
+        plugin_slot_t *slot = &slots[i];
+        const dashboard_plugin_t *desc = slot->desc;
+
+        uint64_t interval_us = (uint64_t)desc->min_interval_ms * 1000;
+        bool fresh = false;
+        if (!slot->attempted || now - slot->last_sample_us >= interval_us) {
+            /* Sampled into scratch, so a failed sample that wrote some
+               values still leaves the slots as they were */
+            double scratch[MAX_PLUGIN_SERIES];
+            memcpy(scratch, slot->values, sizeof(scratch));
+            bool ok = desc->sample(slot->state, scratch);
+            if (ok) {
+                memcpy(slot->values, scratch, sizeof(scratch));
+            }
+            uint64_t done = now_us();
+            slot->measured_cost_us = (uint32_t)(done - now);
+            slot->last_sample_us = now;
+            slot->attempted = true;
+            slot->stale = !ok;
+            slot->sampled = slot->sampled || ok;
+            fresh = ok;
+            now = done;
+        }
+
+        plugins->plugins[i] = (plugin_view_t){
+            .name = desc->name,
+            .series = desc->series,
+            .series_count = desc->series_count,
+            .values = slot->values,
+            .sampled = slot->sampled,
+            .stale = slot->stale,
+            .fresh = fresh,
+            .sample_cost_us = desc->sample_cost_us,
+            .measured_cost_us = slot->measured_cost_us,
+        };
+    }
+
+    return slot_count > 0;
+}
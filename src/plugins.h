@@ -0,0 +1,45 @@
+#ifndef PLUGINS_H
+#define PLUGINS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "dashboard_plugin.h"
+
+/* Series a single plugin may declare */
+#define MAX_PLUGIN_SERIES 8
+
+/* One loaded plugin; series and values point into registry storage and
+   stay valid until plugins_cleanup */
+typedef struct {
+    const char *name;
+    const dashboard_series_t *series;
+    int series_count;
+    const double *values;               /* One per series */
+    bool sampled;                       /* values hold at least one sample */
+    bool stale;                         /* Latest sample() failed; values are older */
+    bool fresh;                         /* values were sampled by this plugins_get */
+    uint32_t sample_cost_us;            /* Declared by the plugin */
+    uint32_t measured_cost_us;          /* Duration of the latest sample() */
+} plugin_view_t;
+
+typedef struct {
+    int count;
+    plugin_view_t plugins[MAX_PLUGINS];
+} plugin_metrics_t;
+
+/* Load the shared object at path, check its ABI version and series
+   declarations, and run its init(). On failure writes the reason to err
+   and returns false; nothing stays loaded. */
+bool plugins_load(const char *path, char *err, size_t err_size);
+
+/* Run every plugin's cleanup() and unload them (call once at shutdown) */
+void plugins_cleanup(void);
+
+/* Sample each plugin whose min_interval_ms has passed, then describe all
+   of them. Values are written into preallocated slots, so this does not
+   allocate. Returns false if no plugin is loaded. */
+bool plugins_get(plugin_metrics_t *plugins);
+
+#endif /* PLUGINS_H */
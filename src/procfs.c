@@ -0,0 +1,441 @@
+#include "procfs.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* Submission ring size; larger batches are submitted in chunks */
+#define BATCH_RING_ENTRIES 64
+
+static procfs_file_t *batch_files[PROCFS_BATCH_MAX];
+static uint32_t batch_groups[PROCFS_BATCH_MAX];     /* Groups each file belongs to */
+static int batch_count = 0;
+static uint32_t current_groups = PROCFS_BATCH_ALL;
+/* Files covered by the submit in progress, as indices into batch_files */
+static int selected[PROCFS_BATCH_MAX];
+static int selected_count = 0;
+/* Reads submitted to the ring and not yet completed, by selected index */
+static bool in_flight[PROCFS_BATCH_MAX];
+static bool batch_enabled = false;
+static procfs_batch_stats_t batch_stats;
+
+/* io_uring set up with raw syscalls, so there is no liburing dependency */
+typedef struct {
+    int fd;
+    unsigned entries;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_map;
+    size_t sq_map_size;
+    void *cq_map;           /* Same as sq_map with IORING_FEAT_SINGLE_MMAP */
+    size_t cq_map_size;
+    size_t sqes_size;
+} uring_t;
+
+static uring_t ring = { .fd = -1 };
+
+static void batch_remove(procfs_file_t *file);
+
+bool procfs_open(procfs_file_t *file, const char *path, size_t initial_cap) {
+    file->fd = -1;
+    file->buf = NULL;
+    file->cap = 0;
+    file->len = 0;
+    file->batch_slot = -1;
+    file->batched = false;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    file->buf = malloc(initial_cap);
+    if (!file->buf) {
+        close(fd);
+        return false;
+    }
+
+    file->fd = fd;
+    file->cap = initial_cap;
+    return true;
+}
+
+void procfs_close(procfs_file_t *file) {
+    batch_remove(file);
+    if (file->fd >= 0) {
+        close(file->fd);
+    }
+    free(file->buf);
+    file->fd = -1;
+    file->buf = NULL;
+    file->cap = 0;
+    file->len = 0;
+}
+
+bool procfs_read(procfs_file_t *file) {
+    if (file->fd < 0) {
+        return false;
+    }
+    if (file->batched) {
+        file->batched = false;
+        return true;
+    }
+
+    size_t len = 0;
+    for (;;) {
+        if (len == file->cap) {
+            /* File outgrew the buffer (e.g. CPUs hot-added); grow once */
+            size_t new_cap = file->cap * 2;
+            char *grown = realloc(file->buf, new_cap);
+            if (!grown) {
+                return false;
+            }
+            file->buf = grown;
+            file->cap = new_cap;
+        }
+
+        ssize_t n = pread(file->fd, file->buf + len, file->cap - len, (off_t)len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        len += (size_t)n;
+    }
+
+    file->len = len;
+    return true;
+}
+
+/* ---- Batched reads ---- */
+
+static void uring_teardown(void) {
+    if (ring.sqes) munmap(ring.sqes, ring.sqes_size);
+    if (ring.cq_map && ring.cq_map != ring.sq_map) munmap(ring.cq_map, ring.cq_map_size);
+    if (ring.sq_map) munmap(ring.sq_map, ring.sq_map_size);
+    if (ring.fd >= 0) close(ring.fd);
+    memset(&ring, 0, sizeof(ring));
+    ring.fd = -1;
+}
+
+static bool uring_setup(void) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+
+    /* Fails with ENOSYS on old kernels, EPERM when io_uring_disabled or
+       a seccomp filter blocks it */
+    int fd = (int)syscall(__NR_io_uring_setup, BATCH_RING_ENTRIES, &p);
+    if (fd < 0) {
+        return false;
+    }
+    ring.fd = fd;
+    ring.entries = p.sq_entries;
+
+    ring.sq_map_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring.cq_map_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && ring.cq_map_size > ring.sq_map_size) {
+        ring.sq_map_size = ring.cq_map_size;
+    }
+
+    ring.sq_map = mmap(NULL, ring.sq_map_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring.sq_map == MAP_FAILED) {
+        ring.sq_map = NULL;
+        uring_teardown();
+        return false;
+    }
+    ring.cq_map = single ? ring.sq_map
+                         : mmap(NULL, ring.cq_map_size, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (ring.cq_map == MAP_FAILED) {
+        ring.cq_map = NULL;
+        uring_teardown();
+        return false;
+    }
+    ring.sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    ring.sqes = mmap(NULL, ring.sqes_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring.sqes == MAP_FAILED) {
+        ring.sqes = NULL;
+        uring_teardown();
+        return false;
+    }
+
+    char *sq = ring.sq_map, *cq = ring.cq_map;
+    ring.sq_tail = (unsigned *)(sq + p.sq_off.tail);
+    ring.sq_mask = (unsigned *)(sq + p.sq_off.ring_mask);
+    ring.sq_array = (unsigned *)(sq + p.sq_off.array);
+    ring.cq_head = (unsigned *)(cq + p.cq_off.head);
+    ring.cq_tail = (unsigned *)(cq + p.cq_off.tail);
+    ring.cq_mask = (unsigned *)(cq + p.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    return true;
+}
+
+bool procfs_batch_init(bool allow_uring) {
+    procfs_batch_cleanup();
+    batch_enabled = true;
+    return allow_uring && uring_setup();
+}
+
+void procfs_batch_cleanup(void) {
+    while (batch_count > 0) {
+        batch_remove(batch_files[batch_count - 1]);
+    }
+    uring_teardown();
+    batch_enabled = false;
+    current_groups = PROCFS_BATCH_ALL;
+    memset(&batch_stats, 0, sizeof(batch_stats));
+}
+
+void procfs_batch_set_group(uint32_t groups) {
+    current_groups = groups;
+}
+
+bool procfs_batch_add(procfs_file_t *file) {
+    if (!batch_enabled || file->fd < 0 || file->batch_slot >= 0 ||
+        batch_count >= PROCFS_BATCH_MAX) {
+        return false;
+    }
+    file->batch_slot = batch_count;
+    batch_groups[batch_count] = current_groups;
+    batch_files[batch_count++] = file;
+    return true;
+}
+
+static void batch_remove(procfs_file_t *file) {
+    int slot = file->batch_slot;
+    if (slot < 0 || slot >= batch_count || batch_files[slot] != file) {
+        return;
+    }
+    /* Move the last file into the hole */
+    batch_count--;
+    batch_files[slot] = batch_files[batch_count];
+    batch_groups[slot] = batch_groups[batch_count];
+    batch_files[slot]->batch_slot = slot;
+    file->batch_slot = -1;
+    file->batched = false;
+}
+
+/* A read shorter than the buffer saw EOF; a full one may have been cut off */
+static bool complete_read(procfs_file_t *file, ssize_t n) {
+    if (n < 0 || (size_t)n >= file->cap) {
+        file->batched = false;
+        return false;
+    }
+    file->len = (size_t)n;
+    file->batched = true;
+    return true;
+}
+
+static int submit_pread(int first) {
+    int fresh = 0;
+    for (int i = first; i < selected_count; i++) {
+        procfs_file_t *f = batch_files[selected[i]];
+        ssize_t n;
+        do {
+            n = pread(f->fd, f->buf, f->cap, 0);
+        } while (n < 0 && errno == EINTR);
+        batch_stats.preads++;
+        fresh += complete_read(f, n);
+    }
+    return fresh;
+}
+
+/* Move the reads still in flight off their buffers: the kernel may write
+   into those after the ring is gone, so the file gets a new one */
+static void abandon_reads(int first, int n) {
+    for (int i = first; i < first + n; i++) {
+        if (!in_flight[i]) continue;
+        procfs_file_t *f = batch_files[selected[i]];
+        char *buf = malloc(f->cap);
+        if (buf) f->buf = buf;
+        f->batched = false;
+        in_flight[i] = false;
+    }
+}
+
+/* Queue files [first, first + n) and wait for all n completions. Returns
+   false if the ring failed, leaving files from first on unread; reads it
+   had already submitted are waited for first, so none is still writing
+   into a buffer the caller goes on to use. */
+static bool submit_uring_chunk(int first, int n, int *fresh) {
+    unsigned tail = *ring.sq_tail;
+    unsigned mask = *ring.sq_mask;
+
+    for (int i = 0; i < n; i++) {
+        procfs_file_t *f = batch_files[selected[first + i]];
+        unsigned idx = tail & mask;
+        struct io_uring_sqe *sqe = &ring.sqes[idx];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = f->fd;
+        sqe->addr = (uint64_t)(uintptr_t)f->buf;
+        sqe->len = (uint32_t)f->cap;
+        sqe->off = 0;
+        sqe->user_data = (uint64_t)(first + i);
+        ring.sq_array[idx] = idx;
+        tail++;
+    }
+    __atomic_store_n(ring.sq_tail, tail, __ATOMIC_RELEASE);
+
+    unsigned to_submit = (unsigned)n;
+    int reaped = 0;
+    bool unsupported = false;
+    bool failed = false;
+    for (;;) {
+        /* After a failed enter, only the reads already submitted are
+           waited for */
+        int outstanding = (failed ? n - (int)to_submit : n) - reaped;
+        if (outstanding <= 0) break;
+
+        int ret = (int)syscall(__NR_io_uring_enter, ring.fd, failed ? 0u : to_submit,
+                               (unsigned)outstanding, IORING_ENTER_GETEVENTS, NULL, 0);
+        batch_stats.enters++;
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            if (failed) {
+                abandon_reads(first, n);
+                break;
+            }
+            failed = true;
+            continue;
+        }
+        if (!failed) {
+            unsigned taken = (unsigned)ret < to_submit ? (unsigned)ret : to_submit;
+            int submitted = n - (int)to_submit;
+            for (int i = submitted; i < submitted + (int)taken; i++) {
+                in_flight[first + i] = true;
+            }
+            to_submit -= taken;
+        }
+
+        unsigned head = *ring.cq_head;
+        unsigned cq_tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != cq_tail; head++) {
+            const struct io_uring_cqe *cqe = &ring.cqes[head & *ring.cq_mask];
+            procfs_file_t *f = batch_files[selected[cqe->user_data]];
+            /* IORING_OP_READ needs 5.6; older kernels reject the opcode */
+            if (cqe->res == -EINVAL) unsupported = true;
+            *fresh += complete_read(f, cqe->res);
+            in_flight[cqe->user_data] = false;
+            reaped++;
+        }
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    }
+    return !failed && !unsupported;
+}
+
+int procfs_batch_submit(void) {
+    return procfs_batch_submit_groups(PROCFS_BATCH_ALL);
+}
+
+int procfs_batch_submit_groups(uint32_t groups) {
+    if (!batch_enabled) {
+        return 0;
+    }
+    batch_stats.submits++;
+
+    /* Snapshots from earlier submits are dropped, so a collector that was
+       not due then reads its file directly instead of getting old data */
+    selected_count = 0;
+    for (int i = 0; i < batch_count; i++) {
+        if (batch_groups[i] & groups) {
+            selected[selected_count++] = i;
+        } else {
+            batch_files[i]->batched = false;
+        }
+    }
+
+    int fresh = 0;
+    int first = 0;
+    while (ring.fd >= 0 && first < selected_count) {
+        int n = selected_count - first;
+        if (n > (int)ring.entries) n = (int)ring.entries;
+        if (!submit_uring_chunk(first, n, &fresh)) {
+            /* Retry the chunk with pread from now on */
+            uring_teardown();
+            for (int i = first; i < first + n; i++) {
+                fresh -= batch_files[selected[i]]->batched;
+            }
+            break;
+        }
+        first += n;
+    }
+    if (first < selected_count) {
+        fresh += submit_pread(first);
+    }
+    return fresh;
+}
+
+void procfs_batch_get_stats(procfs_batch_stats_t *stats) {
+    *stats = batch_stats;
+}
+
+const char *procfs_skip_blanks(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+const char *procfs_next_line(const char *p, const char *end) {
+    const char *nl = memchr(p, '\n', (size_t)(end - p));
+    return nl ? nl + 1 : end;
+}
+
+const char *procfs_parse_u64(const char *p, const char *end, uint64_t *out) {
+    p = procfs_skip_blanks(p, end);
+
+    uint64_t value = 0;
+    const char *start = p;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + (uint64_t)(*p - '0');
+        p++;
+    }
+
+    if (p == start) {
+        return NULL;
+    }
+
+    *out = value;
+    return p;
+}
+
+const char *procfs_parse_decimal(const char *p, const char *end, double *out) {
+    uint64_t whole;
+    p = procfs_parse_u64(p, end, &whole);
+    if (!p) {
+        return NULL;
+    }
+
+    double value = (double)whole;
+    if (p < end && *p == '.') {
+        double scale = 0.1;
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            value += (*p - '0') * scale;
+            scale *= 0.1;
+            p++;
+        }
+    }
+
+    *out = value;
+    return p;
+}
+
+bool procfs_has_prefix(const char *p, const char *end, const char *prefix) {
+    size_t n = strlen(prefix);
+    return (size_t)(end - p) >= n && memcmp(p, prefix, n) == 0;
+}
@@ -0,0 +1,97 @@
+#ifndef PROCFS_H
+#define PROCFS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* A /proc or /sys file that stays open across refreshes.
+   Each read re-fetches the whole file with pread() into a buffer that is
+   allocated once at open and only grows if the file outgrows it. */
+typedef struct {
+    int fd;
+    char *buf;
+    size_t cap;
+    size_t len;     /* Bytes valid after the last successful read */
+    int batch_slot; /* Position in the tick batch, -1 if not registered */
+    bool batched;   /* buf already holds this tick's contents */
+} procfs_file_t;
+
+/* A file that has not been opened yet */
+#define PROCFS_FILE_INIT { -1, NULL, 0, 0, -1, false }
+
+/* Open path for reading with an initial buffer of initial_cap bytes */
+bool procfs_open(procfs_file_t *file, const char *path, size_t initial_cap);
+
+/* Close the file and release its buffer (safe on a never-opened file) */
+void procfs_close(procfs_file_t *file);
+
+/* Re-read the file from offset 0, returns false on I/O error. Returns the
+   contents fetched by the last procfs_batch_submit() instead, once, if
+   the file is registered for batching. */
+bool procfs_read(procfs_file_t *file);
+
+/* Batched reads. Collectors register the files they re-read every tick;
+   procfs_batch_submit() then fetches all of them up front as one io_uring
+   submission (or one pread each when io_uring is unavailable), saving the
+   per-file syscalls and the trailing EOF read of procfs_read(). */
+
+/* Most files one batch covers; later registrations are read normally */
+#define PROCFS_BATCH_MAX 256
+
+/* Group mask covering every registered file */
+#define PROCFS_BATCH_ALL 0xFFFFFFFFu
+
+typedef struct {
+    uint64_t submits;       /* procfs_batch_submit() calls */
+    uint64_t enters;        /* io_uring_enter() syscalls */
+    uint64_t preads;        /* pread() syscalls in the fallback path */
+} procfs_batch_stats_t;
+
+/* Enable batching, using io_uring when allow_uring is set and the kernel
+   permits it. Returns true if io_uring is in use. */
+bool procfs_batch_init(bool allow_uring);
+
+/* Disable batching and tear down the ring; registered files stay open */
+void procfs_batch_cleanup(void);
+
+/* Include file in every submit covering its groups; false if batching is
+   off or full */
+bool procfs_batch_add(procfs_file_t *file);
+
+/* Groups (a bitmask) given to files registered from now on, so collectors
+   sampled on different intervals can be fetched separately. Defaults to
+   PROCFS_BATCH_ALL. */
+void procfs_batch_set_group(uint32_t groups);
+
+/* Read every registered file. Returns how many now hold fresh contents;
+   a file that filled its buffer is left to procfs_read() to grow. */
+int procfs_batch_submit(void);
+
+/* Read the files in any of groups; the rest drop their batched contents */
+int procfs_batch_submit_groups(uint32_t groups);
+
+/* Counters since procfs_batch_init (for the benchmark) */
+void procfs_batch_get_stats(procfs_batch_stats_t *stats);
+
+/* Scanner helpers. All operate on the half-open range [p, end) and never
+   read past end; the buffer does not need to be NUL terminated. */
+
+/* Skip spaces and tabs (not newlines) */
+const char *procfs_skip_blanks(const char *p, const char *end);
+
+/* Return the first character of the next line, or end */
+const char *procfs_next_line(const char *p, const char *end);
+
+/* Parse an unsigned decimal after optional blanks. Returns the position
+   after the digits, or NULL if no digits were found. */
+const char *procfs_parse_u64(const char *p, const char *end, uint64_t *out);
+
+/* Parse an unsigned decimal with an optional fraction ("7.81") after
+   optional blanks. Returns the position after it, or NULL. */
+const char *procfs_parse_decimal(const char *p, const char *end, double *out);
+
+/* True if [p, end) starts with prefix */
+bool procfs_has_prefix(const char *p, const char *end, const char *prefix);
+
+#endif /* PROCFS_H */
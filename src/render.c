@@ -1,5 +1,8 @@
 #include "render.h"
+#include "screen.h"
+#include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #ifdef _WIN32
@@ -9,9 +12,6 @@
 #include <unistd.h>
 #endif
 
-/* History tracking for line graphs */
-#define MAX_HISTORY 128
-
 /* Use internal typedef that maps to public enum */
 typedef render_history_type_t history_type_t;
 #define HISTORY_CPU RENDER_HISTORY_CPU
@@ -20,42 +20,33 @@ typedef render_history_type_t history_type_t;
 #define HISTORY_GPU_MEM RENDER_HISTORY_GPU_MEM
 #define HISTORY_COUNT RENDER_HISTORY_COUNT
 
-static double history_data[HISTORY_COUNT][MAX_HISTORY];
-static int history_count_arr[HISTORY_COUNT] = {0};
-static int history_index[HISTORY_COUNT] = {0};
+/* History tracking for line graphs */
+static history_t histories[HISTORY_COUNT];
 
-static void history_add(history_type_t type, double value) {
-    history_data[type][history_index[type]] = value;
-    history_index[type] = (history_index[type] + 1) % MAX_HISTORY;
-    if (history_count_arr[type] < MAX_HISTORY) {
-        history_count_arr[type]++;
-    }
-}
+/* GPUs after the first; GPU 0 uses the HISTORY_GPU slots above */
+static history_t extra_gpu_histories[MAX_GPUS - 1][2];
 
-static double history_get(history_type_t type, int samples_ago) {
-    if (samples_ago >= history_count_arr[type]) {
-        return 0.0;
-    }
-    int idx = (history_index[type] - 1 - samples_ago + MAX_HISTORY) % MAX_HISTORY;
-    return history_data[type][idx];
-}
+/* Per-CPU clock in MHz, indexed by CPU number */
+static history_t core_freq_histories[MAX_CPU_CORES];
+
+/* Plugin series, indexed by load order and series */
+static history_t plugin_histories[MAX_PLUGINS][MAX_PLUGIN_SERIES];
 
 /* Public wrappers for testing */
 void render_history_add(render_history_type_t type, double value) {
-    history_add(type, value);
+    history_add(&histories[type], value);
 }
 
 double render_history_get(render_history_type_t type, int samples_ago) {
-    return history_get(type, samples_ago);
+    return history_get(&histories[type], samples_ago);
 }
 
 int render_history_count(render_history_type_t type) {
-    return history_count_arr[type];
+    return histories[type].count;
 }
 
 void render_history_clear(render_history_type_t type) {
-    history_count_arr[type] = 0;
-    history_index[type] = 0;
+    history_clear(&histories[type]);
 }
 
 /* Unicode sparkline characters (8 levels) */
@@ -80,6 +71,9 @@ static const char *sparkline_chars[] = {
 #define RESET_COLOR ESC "[0m"
 #define BOLD ESC "[1m"
 
+/* Degree sign, U+00B0 in UTF-8 */
+#define DEGREE "\xc2\xb0"
+
 #define LABEL_WIDTH 9
 #define MIN_BAR_WIDTH 10
 /* Fixed overhead: label(9) + space(1) + brackets(2) + spacing(2) + percent(6) + suffix(~28) */
@@ -97,14 +91,58 @@ static int calculate_bar_width(void) {
     return render_calculate_bar_width(term_width);
 }
 
+/* Frames are drawn into the screen grid, which sends only the cells that
+   changed; without one (allocation failed) they go straight out */
+static bool framed = false;
+
+static void emit_text(const char *text, size_t len) {
+    if (framed) {
+        screen_write(text, len);
+    } else {
+        fwrite(text, 1, len, stdout);
+    }
+}
+
+#ifdef __GNUC__
+__attribute__((format(printf, 1, 2)))
+#endif
+static void emit(const char *fmt, ...) {
+    char buf[512];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (len < 0) {
+        return;
+    }
+    if ((size_t)len < sizeof(buf)) {
+        emit_text(buf, (size_t)len);
+        return;
+    }
+
+    char *big = malloc((size_t)len + 1);
+    if (!big) {
+        return;
+    }
+    va_start(args, fmt);
+    vsnprintf(big, (size_t)len + 1, fmt, args);
+    va_end(args);
+    emit_text(big, (size_t)len);
+    free(big);
+}
+
+static void emit_char(char c) {
+    emit_text(&c, 1);
+}
+
 static void set_color(color_t color) {
     if (color != COLOR_DEFAULT) {
-        printf(ESC "[%dm", color);
+        emit(ESC "[%dm", color);
     }
 }
 
 static void reset_style(void) {
-    printf(RESET_COLOR);
+    emit(RESET_COLOR);
 }
 
 void render_init(void) {
@@ -124,15 +162,18 @@ void render_init(void) {
 
 void render_cleanup(void) {
     /* Show cursor again */
-    printf(CURSOR_SHOW);
-    reset_style();
+    printf(CURSOR_SHOW RESET_COLOR);
     fflush(stdout);
+    screen_cleanup();
 }
 
 void render_clear(void) {
-    /* Only move cursor home - don't clear screen to avoid flickering */
-    printf(CURSOR_HOME);
-    fflush(stdout);
+    screen_invalidate();
+}
+
+void render_resize(void) {
+    /* A new size repaints anyway; the same size may still have reflowed */
+    screen_invalidate();
 }
 
 void render_get_terminal_size(int *width, int *height) {
@@ -184,58 +225,67 @@ static void render_bar(const config_t *cfg, double percent, color_t color, int b
     if (filled > bar_width) filled = bar_width;
     if (filled < 0) filled = 0;
 
-    printf("[");
+    emit("[");
     set_color(color);
 
     for (int i = 0; i < bar_width; i++) {
         if (i < filled) {
-            putchar(cfg->bar_fill_char);
+            emit_char(cfg->bar_fill_char);
         } else {
-            putchar(cfg->bar_empty_char);
+            emit_char(cfg->bar_empty_char);
         }
     }
 
     reset_style();
-    printf("]");
+    emit("]");
 }
 
-static void render_sparkline(const config_t *cfg, history_type_t type, int graph_width) {
+/* Map 0-100% to 0-7 for sparkline character index */
+static int sparkline_level(double percent) {
+    int level = (int)(percent / 100.0 * 7.99);
+    if (level < 0) level = 0;
+    if (level > 7) level = 7;
+    return level;
+}
+
+/* Draw the newest graph_width samples of h. Values are scaled against
+   scale_max; percent series (scale_max 100) get threshold colors, other
+   series use the bar color. */
+static void render_sparkline(const config_t *cfg, const history_t *h,
+                             int graph_width, double scale_max) {
     int samples = graph_width;
-    if (samples > history_count_arr[type]) {
-        samples = history_count_arr[type];
+    if (samples > h->count) {
+        samples = h->count;
     }
 
-    printf("[");
+    emit("[");
 
     /* Pad with spaces if not enough history */
     int padding = graph_width - samples;
     for (int i = 0; i < padding; i++) {
-        printf(" ");
+        emit(" ");
     }
 
     /* Render sparkline from oldest to newest */
     for (int i = samples - 1; i >= 0; i--) {
-        double value = history_get(type, i);
-        color_t color = get_threshold_color(cfg, value);
-
-        /* Map 0-100% to 0-7 for sparkline character index */
-        int level = (int)(value / 100.0 * 7.99);
-        if (level < 0) level = 0;
-        if (level > 7) level = 7;
+        double value = history_get(h, i);
+        double percent = scale_max > 0.0 ? value / scale_max * 100.0 : 0.0;
+        color_t color = scale_max == 100.0 ? get_threshold_color(cfg, value) : cfg->bar_color;
 
         set_color(color);
-        printf("%s", sparkline_chars[level]);
+        emit("%s", sparkline_chars[sparkline_level(percent)]);
         reset_style();
     }
 
-    printf("]");
+    emit("]");
 }
 
+/* fresh: percent is a new sample, not one already in history */
 static void render_graph(const config_t *cfg, double percent, color_t color,
-                         int bar_width, history_type_t history_type) {
+                         int bar_width, history_t *history, bool fresh) {
     if (cfg->graph_style == GRAPH_STYLE_LINE) {
-        history_add(history_type, percent);
-        render_sparkline(cfg, history_type, bar_width);
+        if (fresh) history_add(history, percent);
+        render_sparkline(cfg, history, bar_width, 100.0);
     } else {
         render_bar(cfg, percent, color, bar_width);
     }
@@ -250,120 +300,491 @@ static void render_title(const config_t *cfg) {
     int padding = (term_width - title_len - 4) / 2;
     if (padding < 0) padding = 0;
 
-    printf(BOLD);
+    emit(BOLD);
     set_color(cfg->title_color);
 
-    for (int i = 0; i < padding; i++) putchar(' ');
-    printf("[ %s ]", cfg->title);
+    for (int i = 0; i < padding; i++) emit_char(' ');
+    emit("[ %s ]", cfg->title);
 
     reset_style();
-    printf(CLEAR_LINE "\n" CLEAR_LINE "\n");
+    emit(CLEAR_LINE "\n" CLEAR_LINE "\n");
 }
 
-static void render_cpu(const config_t *cfg, const cpu_metrics_t *cpu, int bar_width) {
+/* A busy CPU running this far below its maximum clock is being held back
+   (thermal or power limits) rather than idling down */
+#define FREQ_THROTTLED_RATIO 0.7f
+
+static bool freq_throttled(const config_t *cfg, const cpu_metrics_t *cpu,
+                           const cpufreq_metrics_t *freq) {
+    if (freq->throttle_events > 0) {
+        return true;
+    }
+    return cpu->total_percent >= cfg->warning_threshold && freq->avg_max_mhz > 0.0f &&
+           freq->avg_mhz < freq->avg_max_mhz * FREQ_THROTTLED_RATIO;
+}
+
+static void render_cpu(const config_t *cfg, const cpu_metrics_t *cpu,
+                       const cpufreq_metrics_t *freq, int bar_width, bool fresh) {
     set_color(cfg->label_color);
-    printf(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, "CPU");
+    emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, "CPU");
 
     color_t bar_color = get_threshold_color(cfg, cpu->total_percent);
-    render_graph(cfg, cpu->total_percent, bar_color, bar_width, HISTORY_CPU);
+    render_graph(cfg, cpu->total_percent, bar_color, bar_width, &histories[HISTORY_CPU], fresh);
 
-    printf("  ");
+    emit("  ");
     set_color(cfg->value_color);
-    printf("%5.1f%%", cpu->total_percent);
+    emit("%5.1f%%", cpu->total_percent);
     reset_style();
 
-    printf("  (usr: %.1f%% sys: %.1f%%)", cpu->user_percent, cpu->system_percent);
+    emit("  (usr: %.1f%% sys: %.1f%%)", cpu->user_percent, cpu->system_percent);
+
+    /* Effective clock, against the hardware maximum when known */
+    if (freq && freq->avg_mhz > 0.0f) {
+        emit("  ");
+        set_color(freq_throttled(cfg, cpu, freq) ? cfg->critical_color : cfg->value_color);
+        if (freq->avg_max_mhz > 0.0f) {
+            emit("%.2f/%.2f GHz", freq->avg_mhz / 1000.0f, freq->avg_max_mhz / 1000.0f);
+        } else {
+            emit("%.2f GHz", freq->avg_mhz / 1000.0f);
+        }
+        reset_style();
+    }
 
     /* Show CPU temperature if available and enabled */
     if (cfg->show_temperature && cpu->temperature_celsius >= 0) {
-        printf("  ");
+        emit("  ");
         set_color(get_temp_color(cfg, cpu->temperature_celsius));
-        printf("%d%cC", cpu->temperature_celsius, 0xB0);  /* degree symbol */
+        emit("%d" DEGREE "C", cpu->temperature_celsius);
+        reset_style();
+    }
+
+    emit(CLEAR_LINE "\n");
+}
+
+/* Compact per-core grid: one sparkline cell per core, wrapped to the bar width */
+static void render_cpu_cores(const config_t *cfg, const cpu_core_metrics_t *cores,
+                             int bar_width) {
+    if (cores->count <= 0) return;
+
+    /* Find the hottest core so it can be called out by number */
+    int hottest = 0;
+    for (int i = 1; i < cores->count; i++) {
+        if (cores->total_percent[i] > cores->total_percent[hottest]) {
+            hottest = i;
+        }
+    }
+
+    int per_row = bar_width;
+    for (int row_start = 0; row_start < cores->count; row_start += per_row) {
+        set_color(cfg->label_color);
+        emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, row_start == 0 ? "Cores" : "");
+        emit(" ");
+
+        int row_end = row_start + per_row;
+        if (row_end > cores->count) row_end = cores->count;
+
+        for (int i = row_start; i < row_end; i++) {
+            double value = cores->total_percent[i];
+            set_color(get_threshold_color(cfg, value));
+            emit("%s", sparkline_chars[sparkline_level(value)]);
+            reset_style();
+        }
+
+        if (row_start == 0) {
+            for (int i = row_end - row_start; i < per_row; i++) emit_char(' ');
+            emit("   max ");
+            set_color(get_threshold_color(cfg, cores->total_percent[hottest]));
+            emit("%5.1f%%", cores->total_percent[hottest]);
+            reset_style();
+            emit(" (cpu%d of %d)", hottest, cores->count);
+        }
+
+        emit(CLEAR_LINE "\n");
+    }
+}
+
+/* Per-core clock as a fraction of that core's maximum (or of the fastest
+   core when the maximum is unknown), plus the slowest clock any core ran at
+   within the graph window */
+static void render_cpu_freq(const config_t *cfg, const cpufreq_metrics_t *freq,
+                            int bar_width, bool fresh) {
+    if (freq->count <= 0) return;
+
+    float fastest = 0.0f;
+    for (int i = 0; i < freq->count; i++) {
+        if (freq->cur_mhz[i] > fastest) fastest = freq->cur_mhz[i];
+        if (fresh && freq->cur_mhz[i] > 0.0f) {
+            history_add(&core_freq_histories[i], freq->cur_mhz[i]);
+        }
+    }
+
+    int slowest = -1;
+    double slowest_mhz = 0.0;
+    for (int i = 0; i < freq->count; i++) {
+        if (core_freq_histories[i].count == 0) continue;
+        double low = history_min(&core_freq_histories[i], bar_width);
+        if (slowest < 0 || low < slowest_mhz) {
+            slowest = i;
+            slowest_mhz = low;
+        }
+    }
+
+    int per_row = bar_width;
+    for (int row_start = 0; row_start < freq->count; row_start += per_row) {
+        set_color(cfg->label_color);
+        emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, row_start == 0 ? "Freq" : "");
+        emit(" ");
+
+        int row_end = row_start + per_row;
+        if (row_end > freq->count) row_end = freq->count;
+
+        set_color(cfg->bar_color);
+        for (int i = row_start; i < row_end; i++) {
+            float scale = freq->max_mhz[i] > 0.0f ? freq->max_mhz[i] : fastest;
+            double value = scale > 0.0f ? freq->cur_mhz[i] * 100.0 / scale : 0.0;
+            emit("%s", freq->cur_mhz[i] > 0.0f ? sparkline_chars[sparkline_level(value)] : " ");
+        }
         reset_style();
+
+        if (row_start == 0) {
+            for (int i = row_end - row_start; i < per_row; i++) emit_char(' ');
+            if (slowest >= 0) {
+                emit("   min %.2f GHz (cpu%d)", slowest_mhz / 1000.0, slowest);
+            }
+            if (freq->throttle_events > 0) {
+                emit("  ");
+                set_color(cfg->critical_color);
+                emit("throttled x%llu", (unsigned long long)freq->throttle_events);
+                reset_style();
+            }
+        }
+
+        emit(CLEAR_LINE "\n");
     }
+}
 
-    printf(CLEAR_LINE "\n");
+static void render_temp_cell(const config_t *cfg, const thermal_sensor_t *s) {
+    emit(" %s ", s->label);
+    if (s->celsius < 0) {
+        emit("  ?");
+        return;
+    }
+    set_color(get_temp_color(cfg, s->celsius));
+    emit("%3d", s->celsius);
+    reset_style();
 }
 
-static void render_memory(const config_t *cfg, const memory_metrics_t *mem, int bar_width) {
+/* Package temperatures, then per-core (or per-CCD) sensors wrapped to the
+   width of the bar column */
+static void render_temperatures(const config_t *cfg, const thermal_metrics_t *thermal,
+                                int bar_width) {
+    set_color(cfg->label_color);
+    emit(BOLD "%-*s" RESET_COLOR, LABEL_WIDTH, "Temps");
+    for (int i = 0; i < thermal->package_count; i++) {
+        render_temp_cell(cfg, &thermal->packages[i]);
+    }
+    if (thermal->package_count > 0) {
+        emit(" " DEGREE "C");
+    }
+    emit(CLEAR_LINE "\n");
+
+    /* " Core12  54" is 11 columns */
+    int per_row = (bar_width + 20) / 11;
+    if (per_row < 1) per_row = 1;
+
+    for (int row_start = 0; row_start < thermal->core_count; row_start += per_row) {
+        emit("%-*s", LABEL_WIDTH, "");
+        for (int i = row_start; i < row_start + per_row && i < thermal->core_count; i++) {
+            render_temp_cell(cfg, &thermal->cores[i]);
+        }
+        emit(CLEAR_LINE "\n");
+    }
+}
+
+/* Format a byte rate compactly, e.g. "12.3 MB/s" */
+static void format_rate(double bytes_per_sec, char *buf, size_t buf_size) {
+    char bytes_str[24];
+    metrics_format_bytes((uint64_t)bytes_per_sec, bytes_str, sizeof(bytes_str));
+    snprintf(buf, buf_size, "%s/s", bytes_str);
+}
+
+/* Format a count rate compactly, e.g. "1.2k" */
+static void format_count_rate(double per_sec, char *buf, size_t buf_size) {
+    if (per_sec >= 1e6) {
+        snprintf(buf, buf_size, "%.1fM", per_sec / 1e6);
+    } else if (per_sec >= 1e3) {
+        snprintf(buf, buf_size, "%.1fk", per_sec / 1e3);
+    } else {
+        snprintf(buf, buf_size, "%.0f", per_sec);
+    }
+}
+
+static void render_memory(const config_t *cfg, const memory_metrics_t *mem, int bar_width,
+                          bool fresh) {
     char used_str[32], total_str[32];
     metrics_format_bytes(mem->used_bytes, used_str, sizeof(used_str));
     metrics_format_bytes(mem->total_bytes, total_str, sizeof(total_str));
 
     set_color(cfg->label_color);
-    printf(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, "Memory");
+    emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, "Memory");
 
     color_t bar_color = get_threshold_color(cfg, mem->used_percent);
-    render_graph(cfg, mem->used_percent, bar_color, bar_width, HISTORY_MEMORY);
+    render_graph(cfg, mem->used_percent, bar_color, bar_width, &histories[HISTORY_MEMORY], fresh);
 
-    printf("  ");
+    emit("  ");
     set_color(cfg->value_color);
-    printf("%5.1f%%", mem->used_percent);
+    emit("%5.1f%%", mem->used_percent);
     reset_style();
 
-    printf("  (%s / %s)" CLEAR_LINE "\n", used_str, total_str);
+    emit("  (%s / %s)" CLEAR_LINE "\n", used_str, total_str);
 }
 
-static void render_gpu(const config_t *cfg, const gpu_metrics_t *gpu, int bar_width) {
-    char used_str[32], total_str[32];
+/* One row per NUMA node: usage bar, then how much of the node's allocation
+   traffic stayed local and how often it spilled across nodes */
+static void render_numa(const config_t *cfg, const numa_metrics_t *numa, int bar_width) {
+    for (int i = 0; i < numa->count; i++) {
+        const numa_node_t *n = &numa->nodes[i];
+        char label[LABEL_WIDTH + 1], used_str[32], total_str[32], a[16], b[16];
+        double percent = n->total > 0 ? (double)n->used * 100.0 / (double)n->total : 0.0;
+
+        snprintf(label, sizeof(label), "Node%d", n->node);
+        set_color(cfg->label_color);
+        emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, label);
+
+        render_bar(cfg, percent, get_threshold_color(cfg, percent), bar_width);
+
+        metrics_format_bytes(n->used, used_str, sizeof(used_str));
+        metrics_format_bytes(n->total, total_str, sizeof(total_str));
+        emit("  ");
+        set_color(cfg->value_color);
+        emit("%5.1f%%", percent);
+        reset_style();
+        emit("  (%s / %s)", used_str, total_str);
+
+        emit("  local ");
+        set_color(n->local_percent < NUMA_LOCAL_WARN_PERCENT ? cfg->warning_color
+                                                             : cfg->value_color);
+        emit("%.0f%%", n->local_percent);
+        reset_style();
+
+        format_count_rate(n->miss_rate, a, sizeof(a));
+        format_count_rate(n->foreign_rate, b, sizeof(b));
+        emit("  miss ");
+        set_color(n->miss_rate > 0.0 ? cfg->warning_color : cfg->value_color);
+        emit("%s/s", a);
+        reset_style();
+        emit("  foreign ");
+        set_color(n->foreign_rate > 0.0 ? cfg->warning_color : cfg->value_color);
+        emit("%s/s", b);
+        reset_style();
+
+        emit(CLEAR_LINE "\n");
+    }
+}
+
+/* Width of one stacked-bar segment, rounded so the segments fill the bar */
+static int segment_cells(uint64_t upto, uint64_t total, int bar_width) {
+    return (int)((double)upto / (double)total * bar_width + 0.5);
+}
 
-    /* Truncate GPU name if too long */
-    char name_display[LABEL_WIDTH + 2];
-    if (strlen(gpu->name) > LABEL_WIDTH) {
-        strncpy(name_display, gpu->name, LABEL_WIDTH - 1);
-        name_display[LABEL_WIDTH - 1] = '\0';
-        strcat(name_display, "~");
+/* Breakdown row under the memory line: a stacked used/buffers/cache bar
+   when the cache group is collected, then the other selected groups */
+static void render_memory_breakdown(const config_t *cfg, const memory_metrics_t *mem,
+                                    int bar_width) {
+    char a[32], b[32];
+    unsigned fields = mem->breakdown_fields;
+
+    emit("%-*s ", LABEL_WIDTH, "");
+
+    if ((fields & MEMORY_FIELD_CACHE) && mem->total_bytes > 0) {
+        uint64_t cache = mem->buffers_bytes + mem->cached_bytes;
+        uint64_t in_use = mem->unused_bytes + cache < mem->total_bytes
+                              ? mem->total_bytes - mem->unused_bytes - cache : 0;
+        int used_end = segment_cells(in_use, mem->total_bytes, bar_width);
+        int buf_end = segment_cells(in_use + mem->buffers_bytes, mem->total_bytes, bar_width);
+        int cache_end = segment_cells(in_use + cache, mem->total_bytes, bar_width);
+
+        emit("[");
+        set_color(cfg->bar_color);
+        for (int i = 0; i < used_end; i++) emit_char(cfg->bar_fill_char);
+        set_color(COLOR_BLUE);
+        for (int i = used_end; i < buf_end; i++) emit_char(cfg->bar_fill_char);
+        set_color(COLOR_YELLOW);
+        for (int i = buf_end; i < cache_end; i++) emit_char(cfg->bar_fill_char);
+        reset_style();
+        for (int i = cache_end; i < bar_width; i++) emit_char(cfg->bar_empty_char);
+        emit("]");
+
+        metrics_format_bytes(in_use, a, sizeof(a));
+        set_color(cfg->bar_color);
+        emit("  used %s", a);
+        metrics_format_bytes(mem->buffers_bytes, a, sizeof(a));
+        set_color(COLOR_BLUE);
+        emit("  buf %s", a);
+        metrics_format_bytes(mem->cached_bytes, a, sizeof(a));
+        set_color(COLOR_YELLOW);
+        emit("  cache %s", a);
+        reset_style();
+    }
+
+    if (fields & MEMORY_FIELD_DIRTY) {
+        metrics_format_bytes(mem->dirty_bytes, a, sizeof(a));
+        metrics_format_bytes(mem->writeback_bytes, b, sizeof(b));
+        emit("  dirty %s  wb %s", a, b);
+    }
+
+    if (fields & MEMORY_FIELD_SWAP) {
+        if (mem->swap_total_bytes > 0) {
+            metrics_format_bytes(mem->swap_used_bytes, a, sizeof(a));
+            metrics_format_bytes(mem->swap_total_bytes, b, sizeof(b));
+            emit("  swap %s/%s", a, b);
+        } else {
+            emit("  swap off");
+        }
+    }
+
+    if (fields & MEMORY_FIELD_HUGEPAGES) {
+        if (mem->hugetlb_total_bytes > 0) {
+            metrics_format_bytes(mem->hugetlb_used_bytes, a, sizeof(a));
+            metrics_format_bytes(mem->hugetlb_total_bytes, b, sizeof(b));
+            emit("  huge %s/%s", a, b);
+        }
+        metrics_format_bytes(mem->thp_bytes, a, sizeof(a));
+        emit("  thp %s", a);
+    }
+
+    emit(CLEAR_LINE "\n");
+}
+
+/* Container row: which group the CPU/memory rows describe, and throttling */
+static void render_cgroup(const config_t *cfg, const cgroup_metrics_t *cg) {
+    set_color(cfg->label_color);
+    emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, "Cgroup");
+
+    /* Keep the tail of long paths, which is the informative part */
+    size_t len = strlen(cg->path);
+    const char *path = len > 32 ? cg->path + len - 32 : cg->path;
+    emit("%s%s", len > 32 ? "..." : "", path);
+
+    if (cg->cpu_limit_cores > 0.0) {
+        emit("  cpu %.2f", cg->cpu_limit_cores);
     } else {
-        strncpy(name_display, gpu->name, LABEL_WIDTH);
-        name_display[LABEL_WIDTH] = '\0';
+        emit("  cpu max");
     }
 
+    if (cg->mem_limit > 0) {
+        char limit_str[32];
+        metrics_format_bytes(cg->mem_limit, limit_str, sizeof(limit_str));
+        emit("  mem %s", limit_str);
+    } else {
+        emit("  mem max");
+    }
+
+    if (cg->periods_delta > 0) {
+        double pct = (double)cg->throttled_delta / (double)cg->periods_delta * 100.0;
+        emit("  throttled ");
+        set_color(cg->throttled_delta > 0 ? get_threshold_color(cfg, pct) : cfg->value_color);
+        emit("%llu/%llu", (unsigned long long)cg->throttled_delta,
+               (unsigned long long)cg->periods_delta);
+        reset_style();
+        emit(" (%.0fms, total %llu)", cg->throttled_ms, (unsigned long long)cg->nr_throttled);
+    }
+
+    emit(CLEAR_LINE "\n");
+}
+
+static history_t *gpu_history(int slot, bool memory) {
+    if (slot == 0) {
+        return &histories[memory ? HISTORY_GPU_MEM : HISTORY_GPU];
+    }
+    return &extra_gpu_histories[slot - 1][memory ? 1 : 0];
+}
+
+/* Utilization and VRAM rows for the GPU in list position slot */
+static void render_gpu(const config_t *cfg, const gpu_metrics_t *gpu, int slot,
+                       int bar_width, bool fresh) {
+    char used_str[32], total_str[32];
+    char label[LABEL_WIDTH + 1];
+
     /* GPU utilization line */
+    snprintf(label, sizeof(label), "GPU%d", gpu->index);
     set_color(cfg->label_color);
-    printf(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, "GPU");
+    emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, label);
 
     color_t bar_color = get_threshold_color(cfg, (double)gpu->utilization_percent);
-    render_graph(cfg, (double)gpu->utilization_percent, bar_color, bar_width, HISTORY_GPU);
+    render_graph(cfg, (double)gpu->utilization_percent, bar_color, bar_width,
+                 gpu_history(slot, false), fresh);
 
-    printf("  ");
+    emit("  ");
     set_color(cfg->value_color);
-    printf("%5.1f%%", (double)gpu->utilization_percent);
+    emit("%5.1f%%", (double)gpu->utilization_percent);
     reset_style();
 
+    /* Spread of the sub-refresh samples behind the average */
+    if (gpu->utilization_max > gpu->utilization_min) {
+        emit("  %d-%d%%", gpu->utilization_min, gpu->utilization_max);
+    }
+
     /* Show GPU temperature if available and enabled */
     if (cfg->show_temperature && gpu->temperature_celsius >= 0) {
-        printf("  ");
+        emit("  ");
         set_color(get_temp_color(cfg, gpu->temperature_celsius));
-        printf("%d%cC", gpu->temperature_celsius, 0xB0);  /* degree symbol */
+        emit("%d" DEGREE "C", gpu->temperature_celsius);
         reset_style();
     }
 
     /* Show power if available */
     if (gpu->power_watts >= 0) {
-        printf("  %dW", gpu->power_watts);
+        if (gpu->power_limit_watts > 0) {
+            emit("  %d/%dW", gpu->power_watts, gpu->power_limit_watts);
+        } else {
+            emit("  %dW", gpu->power_watts);
+        }
     }
 
-    printf(CLEAR_LINE "\n");
+    emit("  %s" CLEAR_LINE "\n", gpu->name);
 
     /* VRAM line */
     metrics_format_bytes(gpu->memory_used, used_str, sizeof(used_str));
     metrics_format_bytes(gpu->memory_total, total_str, sizeof(total_str));
 
     set_color(cfg->label_color);
-    printf(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, "VRAM");
+    emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, "VRAM");
 
     bar_color = get_threshold_color(cfg, gpu->memory_percent);
-    render_graph(cfg, gpu->memory_percent, bar_color, bar_width, HISTORY_GPU_MEM);
+    render_graph(cfg, gpu->memory_percent, bar_color, bar_width, gpu_history(slot, true),
+                 fresh);
 
-    printf("  ");
+    emit("  ");
     set_color(cfg->value_color);
-    printf("%5.1f%%", gpu->memory_percent);
+    emit("%5.1f%%", gpu->memory_percent);
     reset_style();
 
-    printf("  (%s / %s)" CLEAR_LINE "\n", used_str, total_str);
+    emit("  (%s / %s)" CLEAR_LINE "\n", used_str, total_str);
+
+    /* Top VRAM consumers */
+    if (cfg->show_processes) {
+        int rows = gpu->process_count < cfg->process_count ? gpu->process_count
+                                                           : cfg->process_count;
+        for (int i = 0; i < rows; i++) {
+            const gpu_process_t *p = &gpu->processes[i];
+            char mem_str[32];
+            metrics_format_bytes(p->memory_used, mem_str, sizeof(mem_str));
+
+            emit("%-*s  %-7d %-16s %9s", LABEL_WIDTH, "", p->pid, p->name, mem_str);
+            if (p->sm_percent >= 0) {
+                emit("  sm ");
+                set_color(get_threshold_color(cfg, (double)p->sm_percent));
+                emit("%3d%%", p->sm_percent);
+                reset_style();
+            }
+            emit(CLEAR_LINE "\n");
+        }
+    }
 }
 
-static void render_disk(const config_t *cfg, const disk_metrics_t *disk, int bar_width) {
+static void render_disk(const config_t *cfg, const disk_metrics_t *disk, bool stale,
+                        int bar_width) {
     char used_str[32], total_str[32];
     metrics_format_bytes(disk->used_bytes, used_str, sizeof(used_str));
     metrics_format_bytes(disk->total_bytes, total_str, sizeof(total_str));
@@ -380,67 +801,589 @@ static void render_disk(const config_t *cfg, const disk_metrics_t *disk, int bar
     }
 
     set_color(cfg->label_color);
-    printf(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, mount_display);
+    emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, mount_display);
 
     color_t bar_color = get_threshold_color(cfg, disk->used_percent);
     render_bar(cfg, disk->used_percent, bar_color, bar_width);
 
-    printf("  ");
+    emit("  ");
     set_color(cfg->value_color);
-    printf("%5.1f%%", disk->used_percent);
+    emit("%5.1f%%", disk->used_percent);
     reset_style();
 
-    printf("  (%s / %s)" CLEAR_LINE "\n", used_str, total_str);
+    emit("  (%s / %s)", used_str, total_str);
+    if (stale) {
+        set_color(cfg->warning_color);
+        emit("  stale");
+        reset_style();
+    }
+    emit(CLEAR_LINE "\n");
+}
+
+/* Top-N process lists, CPU on the left and memory on the right */
+static void render_processes(const config_t *cfg, const process_list_t *procs, bool stale) {
+    set_color(cfg->label_color);
+    emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, "Processes");
+    emit("(%d total)", procs->total_processes);
+    if (stale) {
+        set_color(cfg->warning_color);
+        emit("  stale");
+        reset_style();
+    }
+    emit(CLEAR_LINE "\n");
+
+    emit("  %-7s %-16s %7s     %-7s %-16s %9s" CLEAR_LINE "\n",
+           "PID", "TOP CPU", "CPU%", "PID", "TOP MEMORY", "RSS");
+
+    int rows = procs->cpu_count > procs->rss_count ? procs->cpu_count : procs->rss_count;
+    for (int i = 0; i < rows; i++) {
+        emit("  ");
+        if (i < procs->cpu_count) {
+            const process_info_t *p = &procs->by_cpu[i];
+            emit("%-7d %-16s ", p->pid, p->name);
+            set_color(get_threshold_color(cfg, p->cpu_percent));
+            emit("%6.1f%%", p->cpu_percent);
+            reset_style();
+        } else {
+            emit("%-7s %-16s %7s", "", "", "");
+        }
+
+        emit("     ");
+        if (i < procs->rss_count) {
+            const process_info_t *p = &procs->by_rss[i];
+            char rss_str[32];
+            metrics_format_bytes(p->rss_bytes, rss_str, sizeof(rss_str));
+            emit("%-7d %-16s %9s", p->pid, p->name, rss_str);
+        }
+        emit(CLEAR_LINE "\n");
+    }
+}
+
+/* I/O row shown under a disk's capacity row */
+static void render_disk_io(const config_t *cfg, const diskio_metrics_t *io) {
+    char read_str[32], write_str[32];
+    format_rate(io->read_bytes_per_sec, read_str, sizeof(read_str));
+    format_rate(io->write_bytes_per_sec, write_str, sizeof(write_str));
+
+    emit("%-*s  ", LABEL_WIDTH, "");
+    set_color(cfg->label_color);
+    emit("%-10s", io->device);
+    reset_style();
+
+    emit(" r %5.0f/s %10s  w %5.0f/s %10s  qd %4.1f  await %5.1fms  ",
+           io->read_iops, read_str, io->write_iops, write_str,
+           io->queue_depth, io->await_ms);
+    set_color(get_threshold_color(cfg, io->util_percent));
+    emit("%5.1f%%", io->util_percent);
+    reset_style();
+    emit(CLEAR_LINE "\n");
+}
+
+/* One direction of an interface: label, byte-rate graph, rates */
+static void render_net_direction(const config_t *cfg, const char *label,
+                                 const history_t *history, int bar_width,
+                                 double bytes_per_sec, double packets_per_sec,
+                                 double errors_per_sec, double drops_per_sec) {
+    char rate_str[32], pkt_str[16];
+    format_rate(bytes_per_sec, rate_str, sizeof(rate_str));
+    format_count_rate(packets_per_sec, pkt_str, sizeof(pkt_str));
+
+    set_color(cfg->label_color);
+    emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, label);
+
+    /* Rates have no natural ceiling, so scale to the visible window's peak */
+    double peak = history_max(history, bar_width);
+    if (cfg->graph_style == GRAPH_STYLE_LINE) {
+        render_sparkline(cfg, history, bar_width, peak);
+    } else {
+        render_bar(cfg, peak > 0.0 ? bytes_per_sec / peak * 100.0 : 0.0,
+                   cfg->bar_color, bar_width);
+    }
+
+    emit("  %11s  %6s pkt/s", rate_str, pkt_str);
+
+    if (errors_per_sec > 0.0 || drops_per_sec > 0.0) {
+        emit("  ");
+        set_color(cfg->critical_color);
+        emit("err %.0f/s drop %.0f/s", errors_per_sec, drops_per_sec);
+        reset_style();
+    }
+
+    emit(CLEAR_LINE "\n");
+}
+
+static void render_network(const config_t *cfg, const net_metrics_list_t *net, int bar_width) {
+    for (int i = 0; i < net->count; i++) {
+        const net_interface_metrics_t *iface = &net->ifaces[i];
+
+        /* "eth0 rx" / "     tx", truncating long names to fit the label */
+        char rx_label[LABEL_WIDTH + 1], tx_label[LABEL_WIDTH + 1];
+        int name_width = LABEL_WIDTH - 3;
+        snprintf(rx_label, sizeof(rx_label), "%-*.*s rx", name_width - 1, name_width - 1, iface->name);
+        snprintf(tx_label, sizeof(tx_label), "%-*s tx", name_width - 1, "");
+
+        render_net_direction(cfg, rx_label, iface->rx_history, bar_width,
+                             iface->rx_bytes_per_sec, iface->rx_packets_per_sec,
+                             iface->rx_errors_per_sec, iface->rx_drops_per_sec);
+        render_net_direction(cfg, tx_label, iface->tx_history, bar_width,
+                             iface->tx_bytes_per_sec, iface->tx_packets_per_sec,
+                             iface->tx_errors_per_sec, iface->tx_drops_per_sec);
+    }
+}
+
+/* Socket counts by state; full accept queues and overflows are critical */
+static void render_tcp(const config_t *cfg, const tcp_metrics_t *tcp) {
+    char a[16], b[16], c[16];
+
+    set_color(cfg->label_color);
+    emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, "TCP");
+
+    format_count_rate(tcp->established, a, sizeof(a));
+    format_count_rate(tcp->time_wait, b, sizeof(b));
+    format_count_rate(tcp->close_wait, c, sizeof(c));
+    emit("estab %s  time_wait %s  close_wait %s", a, b, c);
+    format_count_rate(tcp->syn_recv, a, sizeof(a));
+    format_count_rate(tcp->fin_wait + tcp->last_ack + tcp->closing + tcp->syn_sent,
+                      b, sizeof(b));
+    emit("  syn_recv %s  closing %s  listen %u", a, b, tcp->listen);
+
+    if (tcp->listen_full > 0) {
+        emit("  ");
+        set_color(cfg->critical_color);
+        emit("%u full", tcp->listen_full);
+        reset_style();
+    }
+    if (tcp->has_listen_stats) {
+        format_count_rate(tcp->listen_overflow_rate, a, sizeof(a));
+        format_count_rate(tcp->listen_drop_rate, b, sizeof(b));
+        emit("  overflow ");
+        set_color(tcp->listen_overflow_rate > 0.0 ? cfg->critical_color : cfg->value_color);
+        emit("%s/s", a);
+        reset_style();
+        emit(" drop ");
+        set_color(tcp->listen_drop_rate > 0.0 ? cfg->critical_color : cfg->value_color);
+        emit("%s/s", b);
+        reset_style();
+    }
+
+    emit(CLEAR_LINE "\n");
+}
+
+/* One PSI row: avg10 bar for "some", then the longer averages and "full" */
+static void render_pressure_row(const config_t *cfg, const char *label,
+                                const psi_resource_metrics_t *res, int bar_width) {
+    set_color(cfg->label_color);
+    emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, label);
+
+    render_bar(cfg, res->some.avg10, get_threshold_color(cfg, res->some.avg10), bar_width);
+
+    emit("  some ");
+    set_color(cfg->value_color);
+    emit("%5.1f%%", res->some.avg10);
+    reset_style();
+    emit(" %5.1f %5.1f", res->some.avg60, res->some.avg300);
+
+    if (res->has_full) {
+        emit("  full ");
+        set_color(get_threshold_color(cfg, res->full.avg10));
+        emit("%5.1f%%", res->full.avg10);
+        reset_style();
+        emit(" %5.1f %5.1f", res->full.avg60, res->full.avg300);
+    }
+
+    if (res->triggered) {
+        set_color(cfg->critical_color);
+        emit(BOLD "  STALL" RESET_COLOR);
+    }
+    emit(CLEAR_LINE "\n");
+}
+
+/* One per-CPU rate vector as a sparkline scaled to its busiest CPU, with
+   the CPUs flagged hot drawn in the critical color and called out */
+static void render_irq_vector(const config_t *cfg, const char *label, const float *rates,
+                              double total, const irq_metrics_t *irq, uint8_t flag,
+                              int bar_width) {
+    float peak = 0.0f;
+    for (int i = 0; i < irq->cpu_count; i++) {
+        if (rates[i] > peak) peak = rates[i];
+    }
+
+    for (int row_start = 0; row_start < irq->cpu_count; row_start += bar_width) {
+        set_color(cfg->label_color);
+        emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, row_start == 0 ? label : "");
+        emit(" ");
+
+        int row_end = row_start + bar_width;
+        if (row_end > irq->cpu_count) row_end = irq->cpu_count;
+
+        for (int i = row_start; i < row_end; i++) {
+            double level = peak > 0.0f ? rates[i] / peak * 100.0 : 0.0;
+            set_color((irq->hot[i] & flag) ? cfg->critical_color : cfg->bar_color);
+            emit("%s", sparkline_chars[sparkline_level(level)]);
+            reset_style();
+        }
+
+        if (row_start == 0) {
+            char rate_str[16];
+            format_count_rate(total, rate_str, sizeof(rate_str));
+            for (int i = row_end - row_start; i < bar_width; i++) emit_char(' ');
+            emit("   %7s/s", rate_str);
+
+            /* Name up to three hot CPUs with their share of the total */
+            int shown = 0;
+            for (int i = 0; i < irq->cpu_count && shown < 3; i++) {
+                if (!(irq->hot[i] & flag) || total <= 0.0) continue;
+                set_color(cfg->critical_color);
+                emit("%s cpu%d %.0f%%", shown == 0 ? "  hot" : "", i,
+                       rates[i] / total * 100.0);
+                reset_style();
+                shown++;
+            }
+        }
+
+        emit(CLEAR_LINE "\n");
+    }
+}
+
+static void render_interrupts(const config_t *cfg, const irq_metrics_t *irq, int bar_width) {
+    char a[16], b[16];
+
+    render_irq_vector(cfg, "HardIRQ", irq->hardirq_rate, irq->hardirq_total, irq,
+                      IRQ_HOT_HARD, bar_width);
+    render_irq_vector(cfg, "SoftIRQ", irq->softirq_rate, irq->softirq_total, irq,
+                      IRQ_HOT_SOFT, bar_width);
+
+    set_color(cfg->label_color);
+    emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, "Sched");
+    format_count_rate(irq->ctxt_rate, a, sizeof(a));
+    format_count_rate(irq->intr_rate, b, sizeof(b));
+    emit("ctxt %s/s  intr %s/s", a, b);
+    format_count_rate(irq->net_rx_total, a, sizeof(a));
+    emit("  net_rx %s/s", a);
+    if (irq->top_source[0] != '\0') {
+        format_count_rate(irq->top_source_rate, a, sizeof(a));
+        emit("  top %s %s/s", irq->top_source, a);
+    }
+    emit(CLEAR_LINE "\n");
+}
+
+/* Per-CPU IPC sparkline with totals; software counters only give rates */
+static void render_perf(const config_t *cfg, const perf_metrics_t *perf, int bar_width) {
+    char a[16], b[16], c[16];
+
+    if (perf->hardware) {
+        for (int row_start = 0; row_start < perf->cpu_count; row_start += bar_width) {
+            set_color(cfg->label_color);
+            emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, row_start == 0 ? "IPC" : "");
+            emit(" ");
+
+            int row_end = row_start + bar_width;
+            if (row_end > perf->cpu_count) row_end = perf->cpu_count;
+
+            set_color(cfg->bar_color);
+            for (int i = row_start; i < row_end; i++) {
+                emit("%s", sparkline_chars[sparkline_level(perf->ipc[i] * 100.0 /
+                                                             PERF_IPC_SCALE)]);
+            }
+            reset_style();
+
+            if (row_start == 0) {
+                for (int i = row_end - row_start; i < bar_width; i++) emit_char(' ');
+                set_color(cfg->value_color);
+                emit("   %4.2f IPC", perf->ipc_total);
+                reset_style();
+                emit("  %.1f MPKI  %.2f Gcyc/s", perf->mpki_total, perf->cycles_rate / 1e9);
+                if (perf->multiplexed) emit("  (scaled)");
+            }
+            emit(CLEAR_LINE "\n");
+        }
+    }
+
+    set_color(cfg->label_color);
+    emit(BOLD "%-*s" RESET_COLOR " ", LABEL_WIDTH, "Events");
+    format_count_rate(perf->ctx_switch_rate, a, sizeof(a));
+    format_count_rate(perf->page_fault_rate, b, sizeof(b));
+    format_count_rate(perf->migration_rate, c, sizeof(c));
+    emit("ctxsw %s/s  faults %s/s  migrations %s/s", a, b, c);
+    if (!perf->hardware) emit("  (no hardware counters)");
+    emit(CLEAR_LINE "\n");
+}
+
+/* One row per plugin series. Percent series use the thresholds; others
+   are scaled to the declared max, or to their recent peak without one. */
+static void render_plugin(const config_t *cfg, const plugin_view_t *p, int slot,
+                          int bar_width, bool fresh) {
+    for (int i = 0; i < p->series_count; i++) {
+        const dashboard_series_t *series = &p->series[i];
+        double value = p->values[i];
+        history_t *h = &plugin_histories[slot][i];
+        if (fresh) history_add(h, value);
+
+        bool percent = series->kind == DASHBOARD_SERIES_PERCENT;
+        double peak = series->max > 0.0 ? series->max :
+                      percent ? 100.0 : history_max(h, bar_width);
+        if (peak <= 0.0) peak = 1.0;
+
+        set_color(cfg->label_color);
+        emit(BOLD "%-*.*s" RESET_COLOR " ", LABEL_WIDTH, LABEL_WIDTH, series->name);
+
+        color_t color = percent ? get_threshold_color(cfg, value) : cfg->bar_color;
+        if (cfg->graph_style == GRAPH_STYLE_LINE) {
+            render_sparkline(cfg, h, bar_width, peak);
+        } else {
+            render_bar(cfg, value / peak * 100.0, color, bar_width);
+        }
+
+        const char *unit = series->unit ? series->unit : "";
+        char value_str[16];
+        set_color(percent ? color : cfg->value_color);
+        if (percent) {
+            emit(" %5.1f%%", value);
+        } else if (series->kind == DASHBOARD_SERIES_RATE) {
+            format_count_rate(value, value_str, sizeof(value_str));
+            emit(" %7s %s/s", value_str, unit);
+        } else {
+            emit(" %7.1f %s", value, unit);
+        }
+        reset_style();
+
+        if (i == 0) {
+            emit("  %s", p->name);
+            if (p->stale) {
+                set_color(cfg->warning_color);
+                emit(" stale");
+                reset_style();
+            }
+            /* Costlier than it declared: worth knowing when the tick runs long */
+            if (p->sample_cost_us > 0 && p->measured_cost_us > 2 * p->sample_cost_us) {
+                set_color(cfg->warning_color);
+                emit(" slow %u us", (unsigned)p->measured_cost_us);
+                reset_style();
+            }
+        }
+        emit(CLEAR_LINE "\n");
+    }
+}
+
+/* One row per script: its last good values, then why they may be old */
+static void render_exec(const config_t *cfg, const exec_command_metrics_t *cmd) {
+    set_color(cfg->label_color);
+    emit(BOLD "%-*.*s" RESET_COLOR " ", LABEL_WIDTH, LABEL_WIDTH, cmd->name);
+
+    for (int i = 0; i < cmd->value_count; i++) {
+        emit("%s%s ", i > 0 ? "  " : "", cmd->values[i].key);
+        set_color(cmd->stale ? cfg->warning_color : cfg->value_color);
+        emit("%g", cmd->values[i].value);
+        reset_style();
+    }
+    if (cmd->value_count == 0 && cmd->status == EXEC_STATUS_PENDING) {
+        emit("waiting");
+    }
+
+    set_color(cfg->critical_color);
+    switch (cmd->status) {
+        case EXEC_STATUS_TIMEOUT:
+            emit("  timed out");
+            break;
+        case EXEC_STATUS_FAILED:
+            if (cmd->exit_code > 0) emit("  exit %d", cmd->exit_code);
+            else if (cmd->exit_code < 0) emit("  signal %d", -cmd->exit_code);
+            else emit("  no values");
+            break;
+        case EXEC_STATUS_SPAWN_ERROR:
+            emit("  could not run");
+            break;
+        default:
+            break;
+    }
+    reset_style();
+
+    if (cmd->stale) {
+        set_color(cfg->warning_color);
+        emit("  stale %.0fs", cmd->age_sec);
+        reset_style();
+    }
+    emit(CLEAR_LINE "\n");
+}
+
+static void render_pressure(const config_t *cfg, const psi_metrics_t *psi, int bar_width) {
+    static const char *const labels[PSI_RESOURCE_COUNT] = { "CPU psi", "Mem psi", "IO psi" };
+
+    for (int r = 0; r < PSI_RESOURCE_COUNT; r++) {
+        if (psi->res[r].available) {
+            render_pressure_row(cfg, labels[r], &psi->res[r], bar_width);
+        }
+    }
+}
+
+static const diskio_metrics_t *find_disk_io(const diskio_metrics_list_t *list,
+                                            const char *mount_point) {
+    for (int i = 0; i < list->count; i++) {
+        if (list->disks[i].found && strcmp(list->disks[i].mount_point, mount_point) == 0) {
+            return &list->disks[i];
+        }
+    }
+    return NULL;
 }
 
 static void render_separator(void) {
-    printf(CLEAR_LINE "\n");
+    emit(CLEAR_LINE "\n");
 }
 
-static void render_footer(void) {
-    printf(CLEAR_LINE "\n");
+static void render_footer(const loop_jitter_t *jitter) {
+    emit(CLEAR_LINE "\n");
     set_color(COLOR_WHITE);
-    printf("Press Ctrl+C to exit");
+    emit("Press Ctrl+C to exit");
     reset_style();
-    printf(CLEAR_LINE "\n");
+    /* How late ticks are handled against their schedule */
+    if (jitter && jitter->ticks > 0) {
+        emit("   tick jitter %.2f ms avg, %.2f ms max", jitter->mean_ms, jitter->max_ms);
+        if (jitter->missed > 0) {
+            emit(", %llu missed", (unsigned long long)jitter->missed);
+        }
+    }
+    emit(CLEAR_LINE "\n");
 }
 
-void render_dashboard(const config_t *cfg,
-                      const cpu_metrics_t *cpu,
-                      const memory_metrics_t *mem,
-                      const disk_metrics_list_t *disks,
-                      const gpu_metrics_t *gpu) {
-    render_clear();
+void render_dashboard(const config_t *cfg, const dashboard_data_t *data) {
+    const cpu_metrics_t *cpu = data->cpu;
+    const memory_metrics_t *mem = data->mem;
+    const disk_metrics_list_t *disks = data->disks;
+    const gpu_metrics_list_t *gpus = data->gpus;
+    bool have_gpus = cfg->show_gpu && gpus && gpus->count > 0;
+
+    int term_width, term_height;
+    render_get_terminal_size(&term_width, &term_height);
+    framed = screen_begin(term_width, term_height);
+    if (!framed) {
+        emit(CURSOR_HOME);
+    }
     render_title(cfg);
 
     int bar_width = calculate_bar_width();
 
     if (cfg->show_cpu && cpu) {
-        render_cpu(cfg, cpu, bar_width);
+        render_cpu(cfg, cpu, cfg->show_cpu_freq ? data->freq : NULL, bar_width,
+                   data->fresh & DASHBOARD_FRESH_CPU);
+    }
+
+    if (cfg->show_cpu && cfg->show_cpu_cores && data->cores) {
+        render_cpu_cores(cfg, data->cores, bar_width);
+    }
+
+    if (cfg->show_cpu && cfg->show_cpu_freq && data->freq) {
+        render_cpu_freq(cfg, data->freq, bar_width, data->fresh & DASHBOARD_FRESH_CPU);
+    }
+
+    if (cfg->show_cpu && cfg->show_temperature && data->thermal) {
+        render_temperatures(cfg, data->thermal, bar_width);
     }
 
     if (cfg->show_memory && mem) {
-        render_memory(cfg, mem, bar_width);
+        render_memory(cfg, mem, bar_width, data->fresh & DASHBOARD_FRESH_MEMORY);
+        if (mem->breakdown_fields) {
+            render_memory_breakdown(cfg, mem, bar_width);
+        }
+        /* A single node is just the total again */
+        if (cfg->show_numa && data->numa && data->numa->count > 1) {
+            render_numa(cfg, data->numa, bar_width);
+        }
+    }
+
+    if (data->cgroup && ((cfg->show_cpu && cpu) || (cfg->show_memory && mem))) {
+        render_cgroup(cfg, data->cgroup);
     }
 
     /* GPU section */
-    if (cfg->show_gpu && gpu && gpu->available) {
+    if (have_gpus) {
         if (cfg->show_cpu || cfg->show_memory) {
             render_separator();
         }
-        render_gpu(cfg, gpu, bar_width);
+        for (int i = 0; i < gpus->count; i++) {
+            render_gpu(cfg, &gpus->gpus[i], i, bar_width, data->fresh & DASHBOARD_FRESH_GPU);
+        }
     }
 
     /* Disk section */
     if (cfg->show_disk && disks && disks->count > 0) {
-        if (cfg->show_cpu || cfg->show_memory || (cfg->show_gpu && gpu && gpu->available)) {
+        if (cfg->show_cpu || cfg->show_memory || have_gpus) {
             render_separator();
         }
         for (int i = 0; i < disks->count; i++) {
-            render_disk(cfg, &disks->disks[i], bar_width);
+            render_disk(cfg, &disks->disks[i], data->stale & DASHBOARD_STALE_DISKS, bar_width);
+
+            if (cfg->show_disk_io && data->diskio) {
+                const diskio_metrics_t *io = find_disk_io(data->diskio,
+                                                          disks->disks[i].mount_point);
+                if (io) {
+                    render_disk_io(cfg, io);
+                }
+            }
         }
     }
 
-    render_footer();
+    /* Network section */
+    if (cfg->show_network && data->net && data->net->count > 0) {
+        render_separator();
+        render_network(cfg, data->net, bar_width);
+    }
+    if (cfg->show_network && cfg->show_tcp && data->tcp) {
+        if (!(data->net && data->net->count > 0)) render_separator();
+        render_tcp(cfg, data->tcp);
+    }
+
+    /* Pressure section */
+    if (cfg->show_pressure && data->psi) {
+        render_separator();
+        render_pressure(cfg, data->psi, bar_width);
+    }
+
+    /* Interrupt section */
+    if (cfg->show_interrupts && data->irq && data->irq->cpu_count > 0) {
+        render_separator();
+        render_interrupts(cfg, data->irq, bar_width);
+    }
+
+    /* Performance counter section */
+    if (cfg->show_perf && data->perf) {
+        render_separator();
+        render_perf(cfg, data->perf, bar_width);
+    }
+
+    /* Plugin section; a plugin shows once it has produced a sample */
+    if (data->plugins) {
+        bool separated = false;
+        for (int i = 0; i < data->plugins->count; i++) {
+            if (!data->plugins->plugins[i].sampled) continue;
+            if (!separated) render_separator();
+            separated = true;
+            const plugin_view_t *plugin = &data->plugins->plugins[i];
+            render_plugin(cfg, plugin, i, bar_width,
+                          (data->fresh & DASHBOARD_FRESH_PLUGINS) && plugin->fresh);
+        }
+    }
+
+    /* Script collector section */
+    if (data->exec && data->exec->count > 0) {
+        render_separator();
+        for (int i = 0; i < data->exec->count; i++) {
+            render_exec(cfg, &data->exec->commands[i]);
+        }
+    }
+
+    /* Process section */
+    if (cfg->show_processes && data->procs) {
+        render_separator();
+        render_processes(cfg, data->procs, data->stale & DASHBOARD_STALE_PROCS);
+    }
+
+    render_footer(data->jitter);
+
+    if (framed) {
+        size_t len;
+        const char *changes = screen_end(&len);
+        fwrite(changes, 1, len, stdout);
+        framed = false;
+    }
     fflush(stdout);
 }
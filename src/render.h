@@ -2,8 +2,23 @@
 #define RENDER_H
 
 #include "config.h"
+#include "history.h"
 #include "metrics.h"
+#include "metrics_cgroup.h"
+#include "metrics_cpufreq.h"
+#include "metrics_diskio.h"
+#include "metrics_exec.h"
 #include "metrics_gpu.h"
+#include "metrics_irq.h"
+#include "metrics_net.h"
+#include "metrics_numa.h"
+#include "metrics_perf.h"
+#include "metrics_proc.h"
+#include "metrics_psi.h"
+#include "metrics_tcp.h"
+#include "metrics_thermal.h"
+#include "event_loop.h"
+#include "plugins.h"
 
 /* Initialize the terminal for dashboard rendering */
 void render_init(void);
@@ -11,15 +26,51 @@ void render_init(void);
 /* Cleanup terminal state (restore cursor, etc.) */
 void render_cleanup(void);
 
-/* Clear screen and move cursor to home */
+/* Repaint the whole screen with the next frame; frames otherwise send
+   only the cells that changed */
 void render_clear(void);
 
+/* The terminal was resized: the next frame repaints everything */
+void render_resize(void);
+
+/* Sources drawn from a snapshot that is overdue or failed to refresh */
+#define DASHBOARD_STALE_DISKS (1u << 0)
+#define DASHBOARD_STALE_PROCS (1u << 1)
+
+/* Sources sampled for this frame rather than carried over from an earlier
+   one; only these add a point to their graph history */
+#define DASHBOARD_FRESH_CPU (1u << 0)       /* Also the per-core clocks */
+#define DASHBOARD_FRESH_MEMORY (1u << 1)
+#define DASHBOARD_FRESH_GPU (1u << 2)
+#define DASHBOARD_FRESH_PLUGINS (1u << 3)
+
+/* Everything one frame can show; NULL members are skipped */
+typedef struct {
+    const cpu_metrics_t *cpu;
+    const cpu_core_metrics_t *cores;
+    const cpufreq_metrics_t *freq;          /* Per-CPU clocks (Linux) */
+    const thermal_metrics_t *thermal;       /* Per-package/per-core temperatures */
+    const memory_metrics_t *mem;
+    const numa_metrics_t *numa;             /* Per-node memory (Linux) */
+    const cgroup_metrics_t *cgroup;         /* Set when cpu/mem are cgroup-relative */
+    const disk_metrics_list_t *disks;
+    const diskio_metrics_list_t *diskio;   /* Matched to disks by mount point */
+    const gpu_metrics_list_t *gpus;
+    const net_metrics_list_t *net;
+    const tcp_metrics_t *tcp;               /* Socket states (Linux) */
+    const process_list_t *procs;
+    const psi_metrics_t *psi;
+    const irq_metrics_t *irq;
+    const perf_metrics_t *perf;
+    const plugin_metrics_t *plugins;        /* Series from loaded plugins */
+    const exec_metrics_t *exec;             /* Script collectors (POSIX) */
+    const loop_jitter_t *jitter;            /* Tick lateness (Linux event loop) */
+    unsigned stale;                         /* DASHBOARD_STALE_* */
+    unsigned fresh;                         /* DASHBOARD_FRESH_* */
+} dashboard_data_t;
+
 /* Render the complete dashboard */
-void render_dashboard(const config_t *cfg,
-                      const cpu_metrics_t *cpu,
-                      const memory_metrics_t *mem,
-                      const disk_metrics_list_t *disks,
-                      const gpu_metrics_t *gpu);
+void render_dashboard(const config_t *cfg, const dashboard_data_t *data);
 
 /* Get terminal dimensions */
 void render_get_terminal_size(int *width, int *height);
@@ -0,0 +1,116 @@
+#include "scheduler.h"
+#include <string.h>
+
+typedef struct {
+    int interval;                       /* Ticks between firings */
+    int rounds;                         /* Full turns left before it fires */
+    int next;                           /* Next task in the same slot, -1 ends */
+    uint64_t due_tick;                  /* Absolute tick of the next firing */
+} sched_task_t;
+
+static sched_task_t tasks[SCHED_MAX_TASKS];
+static int task_count = 0;
+static int slots[SCHED_WHEEL_SLOTS];    /* Head task of each slot, -1 if empty */
+static int cursor = 0;                  /* Slot of the current tick */
+static uint64_t current_tick = 0;
+static int tick_length_ms = SCHED_MIN_TICK_MS;
+static uint32_t pending = 0;            /* Added since the last advance */
+
+static int gcd(int a, int b) {
+    while (b != 0) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* Place task id delay ticks after the current one */
+static void schedule(int id, int delay) {
+    sched_task_t *t = &tasks[id];
+    int slot = (cursor + delay) % SCHED_WHEEL_SLOTS;
+    t->rounds = (delay - 1) / SCHED_WHEEL_SLOTS;
+    t->due_tick = current_tick + (uint64_t)delay;
+    t->next = slots[slot];
+    slots[slot] = id;
+}
+
+void sched_init(int tick_ms) {
+    tick_length_ms = tick_ms > 0 ? tick_ms : SCHED_MIN_TICK_MS;
+    task_count = 0;
+    cursor = 0;
+    current_tick = 0;
+    pending = 0;
+    for (int i = 0; i < SCHED_WHEEL_SLOTS; i++) {
+        slots[i] = -1;
+    }
+}
+
+int sched_pick_tick(const int *intervals_ms, int count) {
+    int tick = 0;
+    for (int i = 0; i < count; i++) {
+        if (intervals_ms[i] > 0) {
+            tick = gcd(intervals_ms[i], tick);
+        }
+    }
+    return tick >= SCHED_MIN_TICK_MS ? tick : SCHED_MIN_TICK_MS;
+}
+
+int sched_add(int interval_ms) {
+    if (task_count >= SCHED_MAX_TASKS) {
+        return -1;
+    }
+
+    int id = task_count++;
+    int interval = (interval_ms + tick_length_ms / 2) / tick_length_ms;
+    tasks[id].interval = interval > 0 ? interval : 1;
+    schedule(id, tasks[id].interval);
+    pending |= 1u << id;
+    return id;
+}
+
+uint32_t sched_advance(int ticks) {
+    uint32_t due = pending;
+    pending = 0;
+
+    for (int step = 0; step < ticks; step++) {
+        cursor = (cursor + 1) % SCHED_WHEEL_SLOTS;
+        current_tick++;
+
+        /* Detach the slot first: tasks due now are re-added behind it */
+        int id = slots[cursor];
+        slots[cursor] = -1;
+        while (id >= 0) {
+            sched_task_t *t = &tasks[id];
+            int next = t->next;
+            if (t->rounds > 0) {
+                t->rounds--;
+                t->next = slots[cursor];
+                slots[cursor] = id;
+            } else {
+                due |= 1u << id;
+                schedule(id, t->interval);
+            }
+            id = next;
+        }
+    }
+
+    return due;
+}
+
+int sched_ticks_until_due(void) {
+    if (pending) {
+        return 0;
+    }
+
+    uint64_t soonest = UINT64_MAX;
+    for (int i = 0; i < task_count; i++) {
+        if (tasks[i].due_tick < soonest) {
+            soonest = tasks[i].due_tick;
+        }
+    }
+    if (soonest == UINT64_MAX) {
+        return SCHED_WHEEL_SLOTS;
+    }
+    return soonest > current_tick ? (int)(soonest - current_tick) : 0;
+}
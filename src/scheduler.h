@@ -0,0 +1,37 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/* Hashed timer wheel deciding which collectors are due on each tick.
+   Intervals are whole numbers of ticks; a task whose interval is longer
+   than the wheel waits out extra rounds in its slot. Advancing the wheel
+   costs one slot visit per tick, however many tasks are registered. */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SCHED_WHEEL_SLOTS 64
+#define SCHED_MAX_TASKS 32
+/* Finest tick; intervals are rounded to multiples of it */
+#define SCHED_MIN_TICK_MS 50
+
+/* Reset the wheel with one tick lasting tick_ms */
+void sched_init(int tick_ms);
+
+/* Tick length that divides every interval in intervals_ms exactly, if
+   one of at least SCHED_MIN_TICK_MS exists (their GCD); otherwise
+   SCHED_MIN_TICK_MS */
+int sched_pick_tick(const int *intervals_ms, int count);
+
+/* Register a task firing every interval_ms (rounded to whole ticks, at
+   least one). It is due on the next sched_advance. Returns its id, or -1
+   if the table is full. */
+int sched_add(int interval_ms);
+
+/* Move the wheel on by ticks and return the ids due, as a bitmask. A task
+   that missed several firings while the caller was late fires once. */
+uint32_t sched_advance(int ticks);
+
+/* Ticks until the next task is due (0 if one is due now) */
+int sched_ticks_until_due(void);
+
+#endif /* SCHEDULER_H */
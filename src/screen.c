@@ -0,0 +1,315 @@
+#include "screen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Rewriting up to this many unchanged cells is cheaper than a cursor move */
+#define SCREEN_MAX_SKIP 4
+#define SCREEN_MAX_PARAMS 32
+
+static screen_cell_t *cells = NULL;     /* The frame being drawn */
+static screen_cell_t *shown = NULL;     /* What the terminal shows */
+static int grid_cols = 0;
+static int grid_rows = 0;
+static bool repaint = true;
+
+/* Drawing state of the frame */
+static int cursor_row = 0;
+static int cursor_col = 0;
+static uint8_t pen_fg = 0;
+static uint8_t pen_attrs = 0;
+static screen_cell_t *last_cell = NULL; /* Takes UTF-8 continuation bytes */
+
+/* Escape sequence parser */
+typedef enum { PARSE_TEXT, PARSE_ESC, PARSE_CSI } parse_state_t;
+static parse_state_t parse_state = PARSE_TEXT;
+static char params[SCREEN_MAX_PARAMS];
+static int param_len = 0;
+
+/* Output of screen_end */
+static char *out = NULL;
+static size_t out_len = 0;
+static size_t out_cap = 0;
+
+static const screen_cell_t blank_cell = { { ' ' }, 1, 0, 0 };
+
+static bool same_cell(const screen_cell_t *a, const screen_cell_t *b) {
+    return a->len == b->len && a->fg == b->fg && a->attrs == b->attrs &&
+           memcmp(a->glyph, b->glyph, a->len) == 0;
+}
+
+static void clear_cells(screen_cell_t *grid, int from, int to) {
+    for (int i = from; i < to; i++) {
+        grid[i] = blank_cell;
+    }
+}
+
+bool screen_begin(int cols, int rows) {
+    if (cols < 1) cols = 1;
+    if (rows < 1) rows = 1;
+    if (cols > SCREEN_MAX_COLS) cols = SCREEN_MAX_COLS;
+    if (rows > SCREEN_MAX_ROWS) rows = SCREEN_MAX_ROWS;
+
+    if (cols != grid_cols || rows != grid_rows) {
+        size_t count = (size_t)cols * (size_t)rows;
+        screen_cell_t *new_cells = realloc(cells, count * sizeof(*cells));
+        if (new_cells) cells = new_cells;
+        screen_cell_t *new_shown = realloc(shown, count * sizeof(*shown));
+        if (new_shown) shown = new_shown;
+        if (!new_cells || !new_shown) {
+            screen_cleanup();
+            return false;
+        }
+        grid_cols = cols;
+        grid_rows = rows;
+        repaint = true;
+    }
+
+    clear_cells(cells, 0, grid_cols * grid_rows);
+    cursor_row = cursor_col = 0;
+    pen_fg = pen_attrs = 0;
+    last_cell = NULL;
+    parse_state = PARSE_TEXT;
+    return true;
+}
+
+void screen_invalidate(void) {
+    repaint = true;
+}
+
+const screen_cell_t *screen_cell(int row, int col) {
+    if (!cells || row < 0 || row >= grid_rows || col < 0 || col >= grid_cols) {
+        return NULL;
+    }
+    return &cells[row * grid_cols + col];
+}
+
+/* ==================== Drawing ==================== */
+
+static void put_byte(unsigned char c) {
+    /* Continuation byte of the multi-byte character just started; a stray
+       one takes a column of its own, as the terminal draws it */
+    if ((c & 0xC0) == 0x80 && last_cell && ((unsigned char)last_cell->glyph[0] & 0xC0) == 0xC0 &&
+        last_cell->len < sizeof(last_cell->glyph)) {
+        last_cell->glyph[last_cell->len++] = (char)c;
+        return;
+    }
+
+    last_cell = NULL;
+    if (cursor_row < grid_rows && cursor_col < grid_cols) {
+        screen_cell_t *cell = &cells[cursor_row * grid_cols + cursor_col];
+        cell->glyph[0] = (char)c;
+        cell->len = 1;
+        /* Color and bold do not show on a space */
+        cell->fg = c == ' ' ? 0 : pen_fg;
+        cell->attrs = c == ' ' ? 0 : pen_attrs;
+        last_cell = cell;
+    }
+    cursor_col++;
+}
+
+static int next_param(const char **p) {
+    int value = 0;
+    while (**p >= '0' && **p <= '9') {
+        value = value * 10 + (**p - '0');
+        (*p)++;
+    }
+    if (**p == ';') (*p)++;
+    return value;
+}
+
+static void apply_sgr(void) {
+    const char *p = params;
+    if (param_len == 0) {
+        pen_fg = pen_attrs = 0;
+        return;
+    }
+    while (*p) {
+        const char *start = p;
+        int code = next_param(&p);
+        if (code == 0) {
+            pen_fg = pen_attrs = 0;
+        } else if (code == 1) {
+            pen_attrs |= SCREEN_ATTR_BOLD;
+        } else if (code == 22) {
+            pen_attrs &= (uint8_t)~SCREEN_ATTR_BOLD;
+        } else if (code >= 30 && code <= 37) {
+            pen_fg = (uint8_t)code;
+        } else if (code == 39) {
+            pen_fg = 0;
+        }
+        if (p == start) break;
+    }
+}
+
+static void run_csi(char final) {
+    params[param_len] = '\0';
+    int row_start = cursor_row * grid_cols;
+
+    if (final == 'm') {
+        apply_sgr();
+    } else if (final == 'K' && cursor_row < grid_rows && cursor_col < grid_cols) {
+        clear_cells(cells, row_start + cursor_col, row_start + grid_cols);
+    } else if (final == 'H') {
+        const char *p = params;
+        int row = next_param(&p);
+        int col = next_param(&p);
+        cursor_row = row > 0 ? row - 1 : 0;
+        cursor_col = col > 0 ? col - 1 : 0;
+    } else if (final == 'J' && strcmp(params, "2") == 0) {
+        clear_cells(cells, 0, grid_cols * grid_rows);
+    }
+}
+
+void screen_write(const char *text, size_t len) {
+    if (!cells) {
+        return;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)text[i];
+
+        if (parse_state == PARSE_ESC) {
+            parse_state = c == '[' ? PARSE_CSI : PARSE_TEXT;
+            param_len = 0;
+            continue;
+        }
+        if (parse_state == PARSE_CSI) {
+            if (c >= 0x40 && c <= 0x7E) {
+                run_csi((char)c);
+                parse_state = PARSE_TEXT;
+            } else if (param_len < SCREEN_MAX_PARAMS - 1) {
+                params[param_len++] = (char)c;
+            }
+            continue;
+        }
+
+        if (c == 0x1B) {
+            parse_state = PARSE_ESC;
+            last_cell = NULL;
+        } else if (c == '\n') {
+            cursor_row++;
+            cursor_col = 0;
+            last_cell = NULL;
+        } else if (c == '\r') {
+            cursor_col = 0;
+            last_cell = NULL;
+        } else if (c >= 0x20) {
+            put_byte(c);
+        }
+    }
+}
+
+/* ==================== Diffing ==================== */
+
+static void append(const char *data, size_t len) {
+    if (out_len + len > out_cap) {
+        size_t cap = out_cap ? out_cap : 4096;
+        while (cap < out_len + len) cap *= 2;
+        char *grown = realloc(out, cap);
+        if (!grown) return;
+        out = grown;
+        out_cap = cap;
+    }
+    memcpy(out + out_len, data, len);
+    out_len += len;
+}
+
+static void append_move(int row, int col) {
+    char seq[32];
+    int n = snprintf(seq, sizeof(seq), "\033[%d;%dH", row + 1, col + 1);
+    append(seq, (size_t)n);
+}
+
+static void append_style(uint8_t fg, uint8_t attrs) {
+    char seq[32];
+    int n = snprintf(seq, sizeof(seq), "\033[0%s", attrs & SCREEN_ATTR_BOLD ? ";1" : "");
+    if (fg) n += snprintf(seq + n, sizeof(seq) - (size_t)n, ";%d", fg);
+    seq[n++] = 'm';
+    append(seq, (size_t)n);
+}
+
+const char *screen_end(size_t *len) {
+    out_len = 0;
+    if (!cells) {
+        *len = 0;
+        return "";
+    }
+
+    if (repaint) {
+        append("\033[0m\033[H\033[2J", 11);
+        clear_cells(shown, 0, grid_cols * grid_rows);
+        repaint = false;
+    }
+
+    /* The terminal's cursor and style as this output leaves them; the
+       style is back to default after every frame */
+    int at_row = -1, at_col = -1;
+    uint8_t style_fg = 0, style_attrs = 0;
+
+    for (int row = 0; row < grid_rows; row++) {
+        for (int col = 0; col < grid_cols; col++) {
+            int i = row * grid_cols + col;
+            if (same_cell(&cells[i], &shown[i])) {
+                continue;
+            }
+
+            /* Close gaps by rewriting the unchanged cells in between when
+               they need no style change */
+            bool bridged = false;
+            if (at_row == row && col > at_col && col - at_col <= SCREEN_MAX_SKIP) {
+                bridged = true;
+                for (int c = at_col; c < col && bridged; c++) {
+                    const screen_cell_t *gap = &cells[row * grid_cols + c];
+                    bridged = gap->fg == style_fg && gap->attrs == style_attrs;
+                }
+                for (int c = at_col; c < col && bridged; c++) {
+                    const screen_cell_t *gap = &cells[row * grid_cols + c];
+                    append(gap->glyph, gap->len);
+                }
+            }
+            if (!bridged && (at_row != row || at_col != col)) {
+                append_move(row, col);
+            }
+
+            const screen_cell_t *cell = &cells[i];
+            if (cell->fg != style_fg || cell->attrs != style_attrs) {
+                append_style(cell->fg, cell->attrs);
+                style_fg = cell->fg;
+                style_attrs = cell->attrs;
+            }
+            append(cell->glyph, cell->len);
+            shown[i] = *cell;
+            at_row = row;
+            at_col = col + 1;
+        }
+    }
+
+    if (out_len > 0) {
+        if (style_fg || style_attrs) {
+            append("\033[0m", 4);
+        }
+        /* Leave the cursor where the frame's text ended, as a plain
+           redraw would */
+        int row = cursor_row < grid_rows ? cursor_row : grid_rows - 1;
+        int col = cursor_col < grid_cols ? cursor_col : grid_cols - 1;
+        if (at_row != row || at_col != col) {
+            append_move(row, col);
+        }
+    }
+
+    *len = out_len;
+    return out ? out : "";
+}
+
+void screen_cleanup(void) {
+    free(cells);
+    free(shown);
+    free(out);
+    cells = shown = NULL;
+    out = NULL;
+    out_len = out_cap = 0;
+    grid_cols = grid_rows = 0;
+    repaint = true;
+    last_cell = NULL;
+}
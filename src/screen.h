@@ -0,0 +1,49 @@
+#ifndef SCREEN_H
+#define SCREEN_H
+
+/* Off-screen cell grid for one frame. The renderer writes its usual styled
+   text into it (UTF-8, newlines and the few escape sequences it uses:
+   colors, bold, reset, clear to end of line, cursor home). Ending the frame
+   compares the grid with what the terminal already shows and produces only
+   the cursor moves and cells that changed. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Larger terminals are drawn into this much of the screen */
+#define SCREEN_MAX_COLS 512
+#define SCREEN_MAX_ROWS 256
+
+#define SCREEN_ATTR_BOLD (1u << 0)
+
+typedef struct {
+    char glyph[4];          /* One UTF-8 character, not terminated */
+    uint8_t len;            /* Bytes in glyph */
+    uint8_t fg;             /* SGR foreground (30-37), 0 = default */
+    uint8_t attrs;          /* SCREEN_ATTR_* */
+} screen_cell_t;
+
+/* Start a frame on a cols x rows terminal, every cell blank and the cursor
+   home. A size other than the previous frame's repaints everything. */
+bool screen_begin(int cols, int rows);
+
+/* Write text at the cursor. Text past the right or bottom edge is dropped
+   instead of wrapping or scrolling. */
+void screen_write(const char *text, size_t len);
+
+/* Repaint every cell at the end of the next frame (after a resize, or when
+   something else may have written to the terminal) */
+void screen_invalidate(void);
+
+/* Finish the frame: returns the bytes that bring the terminal up to date
+   and stores their length in len. Valid until the next screen_end. */
+const char *screen_end(size_t *len);
+
+/* The cell at row, col of the frame being drawn (NULL outside it) */
+const screen_cell_t *screen_cell(int row, int col);
+
+/* Free the grids */
+void screen_cleanup(void);
+
+#endif /* SCREEN_H */
@@ -0,0 +1,109 @@
+#ifndef THREAD_COMPAT_H
+#define THREAD_COMPAT_H
+
+/* Minimal thread, mutex and condition variable wrappers over pthreads
+   and Win32, covering what the background samplers need */
+
+#include <stdbool.h>
+
+#ifdef _WIN32
+#include <windows.h>
+
+typedef HANDLE thread_t;
+typedef CRITICAL_SECTION mutex_t;
+typedef CONDITION_VARIABLE cond_t;
+
+#define THREAD_FUNC(name, arg) DWORD WINAPI name(LPVOID arg)
+#define THREAD_RETURN return 0
+typedef LPTHREAD_START_ROUTINE thread_fn_t;
+
+static inline bool thread_start(thread_t *t, thread_fn_t fn, void *arg) {
+    *t = CreateThread(NULL, 0, fn, arg, 0, NULL);
+    return *t != NULL;
+}
+
+static inline void thread_join(thread_t t) {
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+
+static inline void thread_detach(thread_t t) { CloseHandle(t); }
+
+static inline void mutex_init(mutex_t *m) { InitializeCriticalSection(m); }
+static inline void mutex_destroy(mutex_t *m) { DeleteCriticalSection(m); }
+static inline void mutex_lock(mutex_t *m) { EnterCriticalSection(m); }
+static inline void mutex_unlock(mutex_t *m) { LeaveCriticalSection(m); }
+
+static inline void cond_init(cond_t *c) { InitializeConditionVariable(c); }
+static inline void cond_destroy(cond_t *c) { (void)c; }
+static inline void cond_signal(cond_t *c) { WakeConditionVariable(c); }
+static inline void cond_broadcast(cond_t *c) { WakeAllConditionVariable(c); }
+
+/* Wait with m held; returns with m held after a signal or timeout_ms */
+static inline void cond_wait_ms(cond_t *c, mutex_t *m, int timeout_ms) {
+    SleepConditionVariableCS(c, m, (DWORD)timeout_ms);
+}
+
+#else
+#include <pthread.h>
+#include <time.h>
+
+typedef pthread_t thread_t;
+typedef pthread_mutex_t mutex_t;
+typedef pthread_cond_t cond_t;
+
+#define THREAD_FUNC(name, arg) void *name(void *arg)
+#define THREAD_RETURN return NULL
+typedef void *(*thread_fn_t)(void *);
+
+static inline bool thread_start(thread_t *t, thread_fn_t fn, void *arg) {
+    return pthread_create(t, NULL, fn, arg) == 0;
+}
+
+static inline void thread_join(thread_t t) { pthread_join(t, NULL); }
+static inline void thread_detach(thread_t t) { pthread_detach(t); }
+
+static inline void mutex_init(mutex_t *m) { pthread_mutex_init(m, NULL); }
+static inline void mutex_destroy(mutex_t *m) { pthread_mutex_destroy(m); }
+static inline void mutex_lock(mutex_t *m) { pthread_mutex_lock(m); }
+static inline void mutex_unlock(mutex_t *m) { pthread_mutex_unlock(m); }
+
+/* Timed waits use CLOCK_MONOTONIC so wall-clock jumps cannot stall them */
+static inline void cond_init(cond_t *c) {
+#ifdef __APPLE__
+    pthread_cond_init(c, NULL);
+#else
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(c, &attr);
+    pthread_condattr_destroy(&attr);
+#endif
+}
+
+static inline void cond_destroy(cond_t *c) { pthread_cond_destroy(c); }
+static inline void cond_signal(cond_t *c) { pthread_cond_signal(c); }
+static inline void cond_broadcast(cond_t *c) { pthread_cond_broadcast(c); }
+
+/* Wait with m held; returns with m held after a signal or timeout_ms */
+static inline void cond_wait_ms(cond_t *c, mutex_t *m, int timeout_ms) {
+    struct timespec ts;
+#ifdef __APPLE__
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+    pthread_cond_timedwait_relative_np(c, m, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(c, m, &ts);
+#endif
+}
+
+#endif /* _WIN32 */
+
+#endif /* THREAD_COMPAT_H */
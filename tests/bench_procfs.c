@@ -0,0 +1,134 @@
+/* Compares the three ways of fetching the dashboard's per-tick /proc and
+   /sys files: one procfs_read() per file, a pread batch and an io_uring
+   batch. Reports read syscalls (from /proc/self/io syscr, which io_uring
+   reads do not touch), io_uring_enter calls and wall time per tick.
+
+   usage: bench_procfs [ticks] */
+#include <glob.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/procfs.h"
+
+#define MAX_FILES PROCFS_BATCH_MAX
+
+typedef enum { MODE_DIRECT, MODE_PREAD, MODE_URING } bench_mode_t;
+
+static const char *const patterns[] = {
+    "/proc/stat",
+    "/proc/meminfo",
+    "/proc/diskstats",
+    "/proc/net/dev",
+    "/proc/net/netstat",
+    "/proc/interrupts",
+    "/proc/softirqs",
+    "/proc/pressure/*",
+    "/sys/devices/system/node/node*/meminfo",
+    "/sys/devices/system/node/node*/numastat",
+    "/sys/devices/system/cpu/cpu*/cpufreq/scaling_cur_freq",
+    "/sys/class/hwmon/hwmon*/temp*_input",
+};
+
+static procfs_file_t files[MAX_FILES];
+static int file_count = 0;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Read syscalls made by this process so far */
+static unsigned long long read_syscalls(void) {
+    unsigned long long syscr = 0;
+    FILE *fp = fopen("/proc/self/io", "r");
+    if (!fp) {
+        return 0;
+    }
+    char line[128];
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "syscr: %llu", &syscr) == 1) break;
+    }
+    fclose(fp);
+    return syscr;
+}
+
+static void open_files(void) {
+    for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++) {
+        glob_t g;
+        if (glob(patterns[p], 0, NULL, &g) != 0) continue;
+        for (size_t i = 0; i < g.gl_pathc && file_count < MAX_FILES; i++) {
+            if (procfs_open(&files[file_count], g.gl_pathv[i], 4096)) {
+                file_count++;
+            }
+        }
+        globfree(&g);
+    }
+}
+
+static void close_files(void) {
+    for (int i = 0; i < file_count; i++) {
+        procfs_close(&files[i]);
+    }
+    file_count = 0;
+}
+
+static void run(bench_mode_t mode, int ticks, unsigned long long overhead) {
+    static const char *const names[] = { "procfs_read", "pread batch", "io_uring batch" };
+
+    if (mode != MODE_DIRECT) {
+        bool uring = procfs_batch_init(mode == MODE_URING);
+        if (mode == MODE_URING && !uring) {
+            printf("%-15s  unavailable (io_uring_setup failed), skipped\n", names[mode]);
+            procfs_batch_cleanup();
+            return;
+        }
+    }
+    open_files();
+    for (int i = 0; i < file_count; i++) {
+        procfs_read(&files[i]);     /* Size the buffers */
+        procfs_batch_add(&files[i]);
+    }
+
+    unsigned long long start_reads = read_syscalls();
+    double start = now_seconds();
+    for (int t = 0; t < ticks; t++) {
+        procfs_batch_submit();
+        for (int i = 0; i < file_count; i++) {
+            procfs_read(&files[i]);
+        }
+    }
+    double elapsed = now_seconds() - start;
+    unsigned long long reads = read_syscalls() - start_reads - overhead;
+
+    procfs_batch_stats_t stats;
+    procfs_batch_get_stats(&stats);
+    double per_tick_reads = (double)reads / ticks;
+    double per_tick_enters = (double)stats.enters / ticks;
+
+    printf("%-15s  %5.1f reads + %4.1f enters = %6.1f syscalls/tick  %8.1f us/tick\n",
+           names[mode], per_tick_reads, per_tick_enters, per_tick_reads + per_tick_enters,
+           elapsed * 1e6 / ticks);
+
+    close_files();
+    procfs_batch_cleanup();
+}
+
+int main(int argc, char **argv) {
+    int ticks = argc > 1 ? atoi(argv[1]) : 1000;
+    if (ticks < 1) ticks = 1;
+
+    /* Reads made by read_syscalls() itself */
+    unsigned long long a = read_syscalls();
+    unsigned long long overhead = read_syscalls() - a;
+
+    open_files();
+    printf("%d files, %d ticks\n", file_count, ticks);
+    close_files();
+
+    run(MODE_DIRECT, ticks, overhead);
+    run(MODE_PREAD, ticks, overhead);
+    run(MODE_URING, ticks, overhead);
+    return 0;
+}
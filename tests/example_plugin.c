@@ -0,0 +1,92 @@
+/* Example collector plugin: the 1-minute load average and the number of
+   runnable tasks from /proc/loadavg, read through an fd kept open between
+   samples. Also the fixture for the registry tests: EXAMPLE_PLUGIN_ABI
+   overrides the declared ABI version, EXAMPLE_PLUGIN_INTERVAL_MS the
+   minimum interval, and the hooks below count samples and force
+   failures. */
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../src/dashboard_plugin.h"
+
+typedef struct {
+    int fd;
+} loadavg_state_t;
+
+static unsigned int sample_calls = 0;
+static int fail_samples = 0;
+
+/* Test hooks */
+DASHBOARD_PLUGIN_EXPORT unsigned int example_plugin_samples(void) { return sample_calls; }
+DASHBOARD_PLUGIN_EXPORT void example_plugin_fail(int fail) { fail_samples = fail; }
+
+static const dashboard_series_t loadavg_series[] = {
+    { "Load1", "", DASHBOARD_SERIES_GAUGE, 0.0 },
+    { "Runnable", "tasks", DASHBOARD_SERIES_GAUGE, 0.0 },
+};
+
+static loadavg_state_t loadavg_state;
+
+static bool loadavg_init(void **state) {
+    loadavg_state.fd = open("/proc/loadavg", O_RDONLY | O_CLOEXEC);
+    if (loadavg_state.fd < 0) {
+        return false;
+    }
+    *state = &loadavg_state;
+    return true;
+}
+
+/* "0.52 0.58 0.59 2/611 12345": load1 and the running count */
+static bool loadavg_sample(void *state, double *values) {
+    loadavg_state_t *s = state;
+    char buf[128];
+
+    sample_calls++;
+    if (fail_samples) {
+        /* Fails halfway, after writing the first value */
+        values[0] = -1.0;
+        return false;
+    }
+
+    ssize_t n = pread(s->fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0) {
+        return false;
+    }
+    buf[n] = '\0';
+
+    char *p;
+    values[0] = strtod(buf, &p);
+    for (int field = 0; field < 2 && *p; field++) {
+        while (*p == ' ') p++;
+        while (*p && *p != ' ') p++;
+    }
+    values[1] = (double)strtoul(p, NULL, 10);
+    return true;
+}
+
+static void loadavg_cleanup(void *state) {
+    loadavg_state_t *s = state;
+    close(s->fd);
+    s->fd = -1;
+}
+
+static dashboard_plugin_t loadavg_plugin = {
+    .abi_version = DASHBOARD_PLUGIN_ABI_VERSION,
+    .struct_size = sizeof(dashboard_plugin_t),
+    .name = "loadavg",
+    .series = loadavg_series,
+    .series_count = 2,
+    .sample_cost_us = 20,
+    .min_interval_ms = 1000,
+    .init = loadavg_init,
+    .sample = loadavg_sample,
+    .cleanup = loadavg_cleanup,
+};
+
+DASHBOARD_PLUGIN_EXPORT const dashboard_plugin_t *dashboard_plugin_v1(void) {
+    const char *abi = getenv("EXAMPLE_PLUGIN_ABI");
+    const char *interval = getenv("EXAMPLE_PLUGIN_INTERVAL_MS");
+    if (abi) loadavg_plugin.abi_version = (uint32_t)atoi(abi);
+    if (interval) loadavg_plugin.min_interval_ms = (uint32_t)atoi(interval);
+    return &loadavg_plugin;
+}
@@ -0,0 +1,52 @@
+#ifndef FAKE_FS_H
+#define FAKE_FS_H
+
+/* Fake /proc and /sys trees for the collector tests, built under a
+   temporary root that the collector is pointed at. Include after the test
+   framework: the helpers fail through ASSERT. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static char root[64];
+
+/* Create root as /tmp/<name>_XXXXXX */
+static inline void make_root(const char *name) {
+    snprintf(root, sizeof(root), "/tmp/%s_XXXXXX", name);
+    ASSERT(mkdtemp(root) != NULL);
+}
+
+static inline void remove_root(void) {
+    char cmd[128];
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", root);
+    ASSERT(system(cmd) == 0);
+}
+
+/* mkdir -p of rel under root */
+static inline void make_dirs(const char *rel) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", root, rel);
+    for (char *p = path + strlen(root) + 1; *p; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            mkdir(path, 0755);
+            *p = '/';
+        }
+    }
+    mkdir(path, 0755);
+}
+
+/* Rewritten in place, since the collectors keep their fds open */
+static inline void write_file(const char *rel, const char *contents) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", root, rel);
+    FILE *fp = fopen(path, "w");
+    ASSERT(fp != NULL);
+    fputs(contents, fp);
+    fclose(fp);
+}
+
+#endif /* FAKE_FS_H */
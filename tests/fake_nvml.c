@@ -0,0 +1,229 @@
+/* Stand-in for libnvidia-ml.so.1 used by the GPU tests. Fakes
+   FAKE_NVML_DEVICES devices (default 8) with values derived from the
+   device index, and counts calls so tests can check what gets cached and
+   which thread queries the devices. FAKE_NVML_NO_SAMPLES makes
+   nvmlDeviceGetSamples unsupported. Each device runs two compute
+   processes: the test process itself and FAKE_MISSING_PID, and only the
+   test process gets utilization samples until
+   fake_nvml_stop_process_samples is called. */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define FAKE_MAX_DEVICES 64
+/* Samples returned by the first nvmlDeviceGetSamples call, as if NVML had
+   been buffering before the collector started; later calls return 3 */
+#define FAKE_BACKLOG 100
+/* Above the kernel's PID_MAX_LIMIT, so it never resolves to a process */
+#define FAKE_MISSING_PID 5000000
+
+typedef struct {
+    unsigned int index;
+    unsigned long long clock;   /* Timestamp of the newest fake sample */
+} fake_device_t;
+
+typedef struct {
+    unsigned int gpu;
+    unsigned int memory;
+} nvmlUtilization_t;
+
+typedef struct {
+    unsigned long long total;
+    unsigned long long free;
+    unsigned long long used;
+} nvmlMemory_t;
+
+typedef struct {
+    unsigned int pid;
+    unsigned long long usedGpuMemory;
+    unsigned int gpuInstanceId;
+    unsigned int computeInstanceId;
+} nvmlProcessInfo_t;
+
+typedef struct {
+    unsigned int pid;
+    unsigned long long timeStamp;
+    unsigned int smUtil;
+    unsigned int memUtil;
+    unsigned int encUtil;
+    unsigned int decUtil;
+} nvmlProcessUtilizationSample_t;
+
+typedef struct {
+    unsigned long long timeStamp;
+    union {
+        double dVal;
+        unsigned int uiVal;
+        unsigned long long ullVal;
+    } sampleValue;
+} nvmlSample_t;
+
+static fake_device_t fake_devices[FAKE_MAX_DEVICES];
+static unsigned int fake_count = 0;
+static unsigned int name_calls = 0;
+static int samples_supported = 1;
+static pthread_t init_thread;
+static unsigned int init_thread_queries = 0;
+static int process_samples_stopped = 0;
+
+/* Test hooks */
+unsigned int fake_nvml_name_calls(void) { return name_calls; }
+unsigned int fake_nvml_init_thread_queries(void) { return init_thread_queries; }
+void fake_nvml_stop_process_samples(void) {
+    __atomic_store_n(&process_samples_stopped, 1, __ATOMIC_RELEASE);
+}
+
+/* Per-frame queries made on the thread that called nvmlInit */
+static void count_query(void) {
+    if (pthread_equal(pthread_self(), init_thread)) {
+        __atomic_add_fetch(&init_thread_queries, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/* Utilization of the fake device: a base level plus 0, 10 or 20 */
+static unsigned int base_utilization(const fake_device_t *dev) {
+    return (dev->index + 1) * 5;
+}
+
+int nvmlInit_v2(void) {
+    const char *env = getenv("FAKE_NVML_DEVICES");
+    fake_count = env ? (unsigned int)atoi(env) : 8;
+    if (fake_count > FAKE_MAX_DEVICES) fake_count = FAKE_MAX_DEVICES;
+    for (unsigned int i = 0; i < fake_count; i++) {
+        fake_devices[i].index = i;
+        fake_devices[i].clock = 0;
+    }
+    samples_supported = getenv("FAKE_NVML_NO_SAMPLES") == NULL;
+    init_thread = pthread_self();
+    name_calls = 0;
+    init_thread_queries = 0;
+    process_samples_stopped = 0;
+    return 0;
+}
+
+int nvmlShutdown(void) {
+    return 0;
+}
+
+int nvmlDeviceGetCount_v2(unsigned int *count) {
+    *count = fake_count;
+    return 0;
+}
+
+int nvmlDeviceGetHandleByIndex_v2(unsigned int index, void **device) {
+    if (index >= fake_count) return 2;  /* NVML_ERROR_INVALID_ARGUMENT */
+    *device = &fake_devices[index];
+    return 0;
+}
+
+int nvmlDeviceGetName(void *device, char *name, unsigned int length) {
+    name_calls++;
+    snprintf(name, length, "Fake GPU %u", ((fake_device_t *)device)->index);
+    return 0;
+}
+
+int nvmlDeviceGetUtilizationRates(void *device, nvmlUtilization_t *util) {
+    count_query();
+    util->gpu = base_utilization(device);
+    util->memory = 0;
+    return 0;
+}
+
+int nvmlDeviceGetSamples(void *device, int type, unsigned long long last_seen,
+                         int *value_type, unsigned int *count, nvmlSample_t *samples) {
+    fake_device_t *dev = device;
+    (void)type;
+    (void)last_seen;
+    count_query();
+
+    if (!samples_supported) return 3;   /* NVML_ERROR_NOT_SUPPORTED */
+
+    unsigned int pending = dev->clock == 0 ? FAKE_BACKLOG : 3;
+    *value_type = 1;                    /* NVML_VALUE_TYPE_UNSIGNED_INT */
+    if (!samples) {
+        *count = pending;
+        return 0;
+    }
+    if (*count < pending) {
+        *count = pending;
+        return 7;                       /* NVML_ERROR_INSUFFICIENT_SIZE */
+    }
+
+    for (unsigned int i = 0; i < pending; i++) {
+        samples[i].timeStamp = ++dev->clock;
+        samples[i].sampleValue.uiVal = base_utilization(dev) + (i % 3) * 10;
+    }
+    *count = pending;
+    return 0;
+}
+
+int nvmlDeviceGetComputeRunningProcesses_v2(void *device, unsigned int *count,
+                                            nvmlProcessInfo_t *infos) {
+    unsigned int index = ((fake_device_t *)device)->index;
+    count_query();
+
+    if (*count < 2) {
+        *count = 2;
+        return 7;                       /* NVML_ERROR_INSUFFICIENT_SIZE */
+    }
+    /* Smallest first, so the collector has to sort */
+    infos[0].pid = FAKE_MISSING_PID;
+    infos[0].usedGpuMemory = 64ULL << 20;
+    infos[1].pid = (unsigned int)getpid();
+    infos[1].usedGpuMemory = (unsigned long long)(index + 1) << 28;
+    *count = 2;
+    return 0;
+}
+
+/* Only the test process shows SM activity */
+int nvmlDeviceGetProcessUtilization(void *device, nvmlProcessUtilizationSample_t *util,
+                                    unsigned int *count, unsigned long long last_seen) {
+    fake_device_t *dev = device;
+    count_query();
+
+    if (__atomic_load_n(&process_samples_stopped, __ATOMIC_ACQUIRE)) {
+        *count = 0;
+        return 6;                       /* NVML_ERROR_NOT_FOUND */
+    }
+    if (*count < 1) {
+        *count = 1;
+        return 7;
+    }
+    util[0].pid = (unsigned int)getpid();
+    util[0].timeStamp = last_seen + 1;
+    util[0].smUtil = 30 + dev->index;
+    util[0].memUtil = 0;
+    util[0].encUtil = 0;
+    util[0].decUtil = 0;
+    *count = 1;
+    return 0;
+}
+
+int nvmlDeviceGetMemoryInfo(void *device, nvmlMemory_t *mem) {
+    count_query();
+    unsigned int index = ((fake_device_t *)device)->index;
+    mem->total = 80ULL << 30;
+    mem->used = (unsigned long long)(index + 1) << 30;
+    mem->free = mem->total - mem->used;
+    return 0;
+}
+
+int nvmlDeviceGetTemperature(void *device, int sensor, unsigned int *temp) {
+    (void)sensor;
+    count_query();
+    *temp = 40 + ((fake_device_t *)device)->index;
+    return 0;
+}
+
+int nvmlDeviceGetPowerUsage(void *device, unsigned int *power_mw) {
+    count_query();
+    *power_mw = (100 + ((fake_device_t *)device)->index) * 1000;
+    return 0;
+}
+
+int nvmlDeviceGetEnforcedPowerLimit(void *device, unsigned int *limit_mw) {
+    (void)device;
+    *limit_mw = 700 * 1000;
+    return 0;
+}
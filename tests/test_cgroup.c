@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/metrics_cgroup.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+static char group_dir[64];
+
+/* Overwrite one file of the fake group. The collector keeps its fds open,
+   so rewrite in place rather than replacing the file. */
+static void write_file(const char *name, const char *contents) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s", group_dir, name);
+    FILE *fp = fopen(path, "w");
+    ASSERT(fp != NULL);
+    fputs(contents, fp);
+    fclose(fp);
+}
+
+static void make_group(void) {
+    strcpy(group_dir, "/tmp/test_cgroup_XXXXXX");
+    ASSERT(mkdtemp(group_dir) != NULL);
+
+    write_file("cpu.stat",
+               "usage_usec 1000000\nuser_usec 600000\nsystem_usec 400000\n"
+               "nr_periods 100\nnr_throttled 10\nthrottled_usec 50000\n");
+    write_file("cpu.max", "200000 100000\n");
+    write_file("memory.current", "1073741824\n");
+    write_file("memory.max", "2147483648\n");
+    write_file("memory.stat", "anon 536870912\nfile 536870912\ninactive_file 268435456\n");
+}
+
+static void remove_group(void) {
+    static const char *const names[] = {
+        "cpu.stat", "cpu.max", "memory.current", "memory.max", "memory.stat"
+    };
+    char path[128];
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        snprintf(path, sizeof(path), "%s/%s", group_dir, names[i]);
+        unlink(path);
+    }
+    rmdir(group_dir);
+}
+
+/* ==================== Limit Tests ==================== */
+
+TEST(test_reads_limits) {
+    make_group();
+    ASSERT(cgroup_metrics_init(group_dir));
+
+    cgroup_metrics_t cg;
+    ASSERT(cgroup_metrics_get(&cg));
+    ASSERT(cg.has_cpu);
+    ASSERT(cg.has_memory);
+    ASSERT(cg.cpu_limit_cores > 1.99 && cg.cpu_limit_cores < 2.01);
+    ASSERT_EQ(cg.mem_limit, 2147483648ULL);
+    ASSERT_EQ(cg.mem_current, 1073741824ULL);
+    ASSERT_EQ(cg.mem_working_set, 1073741824ULL - 268435456ULL);
+    ASSERT(cgroup_metrics_limited(&cg));
+
+    cgroup_metrics_cleanup();
+    remove_group();
+}
+
+TEST(test_max_means_unlimited) {
+    make_group();
+    write_file("cpu.max", "max 100000\n");
+    write_file("memory.max", "max\n");
+    ASSERT(cgroup_metrics_init(group_dir));
+
+    cgroup_metrics_t cg;
+    ASSERT(cgroup_metrics_get(&cg));
+    ASSERT(cg.cpu_limit_cores == 0.0);
+    ASSERT_EQ(cg.mem_limit, 0);
+    ASSERT(!cgroup_metrics_limited(&cg));
+
+    cgroup_metrics_cleanup();
+    remove_group();
+}
+
+/* ==================== Delta Tests ==================== */
+
+TEST(test_throttle_deltas) {
+    make_group();
+    ASSERT(cgroup_metrics_init(group_dir));   /* Baseline sample */
+
+    write_file("cpu.stat",
+               "usage_usec 1200000\nuser_usec 700000\nsystem_usec 500000\n"
+               "nr_periods 110\nnr_throttled 14\nthrottled_usec 80000\n");
+
+    cgroup_metrics_t cg;
+    ASSERT(cgroup_metrics_get(&cg));
+    ASSERT_EQ(cg.nr_throttled, 14);
+    ASSERT_EQ(cg.periods_delta, 10);
+    ASSERT_EQ(cg.throttled_delta, 4);
+    ASSERT(cg.throttled_ms > 29.99 && cg.throttled_ms < 30.01);
+    ASSERT(cg.cpu_total_percent > 0.0);
+
+    cgroup_metrics_cleanup();
+    remove_group();
+}
+
+/* ==================== Apply Tests ==================== */
+
+TEST(test_apply_caps_memory_at_limit) {
+    cgroup_metrics_t cg;
+    memset(&cg, 0, sizeof(cg));
+    cg.has_memory = true;
+    cg.mem_limit = 1000;
+    cg.mem_working_set = 950;
+
+    memory_metrics_t mem = { .total_bytes = 64000, .used_bytes = 6400, .free_bytes = 57600,
+                             .used_percent = 10.0, .breakdown_fields = MEMORY_FIELD_ALL };
+    cgroup_metrics_apply(&cg, NULL, &mem);
+    ASSERT_EQ(mem.breakdown_fields, 0);
+    ASSERT_EQ(mem.total_bytes, 1000);
+    ASSERT_EQ(mem.used_bytes, 950);
+    ASSERT_EQ(mem.free_bytes, 50);
+    ASSERT(mem.used_percent > 94.99 && mem.used_percent < 95.01);
+}
+
+TEST(test_missing_group) {
+    ASSERT(!cgroup_metrics_init("/nonexistent/cgroup/group"));
+    cgroup_metrics_t cg;
+    ASSERT(!cgroup_metrics_get(&cg));
+    cgroup_metrics_cleanup();
+}
+
+int main(void) {
+    printf("Running cgroup tests...\n\n");
+
+    printf("Limit tests:\n");
+    RUN_TEST(test_reads_limits);
+    RUN_TEST(test_max_means_unlimited);
+
+    printf("\nDelta tests:\n");
+    RUN_TEST(test_throttle_deltas);
+
+    printf("\nApply tests:\n");
+    RUN_TEST(test_apply_caps_memory_at_limit);
+    RUN_TEST(test_missing_group);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../src/collector_pool.h"
+#include "../src/disk_job.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+/* ==================== Fake collector ==================== */
+
+/* Writes its run number; delay_ms and fail are set by the tests */
+typedef struct {
+    int runs;
+    int prepared;
+    int releases;
+    int delay_ms;
+    int fail;
+} fake_job_t;
+
+static fake_job_t fake;
+static int buffers[3];
+
+static bool collect_fake(void *arg, void *out) {
+    fake_job_t *job = arg;
+    int delay_ms = __atomic_load_n(&job->delay_ms, __ATOMIC_ACQUIRE);
+    if (delay_ms > 0) usleep((useconds_t)delay_ms * 1000);
+    if (__atomic_load_n(&job->fail, __ATOMIC_ACQUIRE)) return false;
+    *(int *)out = __atomic_add_fetch(&job->runs, 1, __ATOMIC_ACQ_REL);
+    return true;
+}
+
+static void prepare_fake(void *arg) {
+    ((fake_job_t *)arg)->prepared++;
+}
+
+static void release_fake(void *buffer) {
+    (void)buffer;
+    fake.releases++;
+}
+
+static bool collect_quick(void *arg, void *out) {
+    (void)arg;
+    *(int *)out = 1;
+    return true;
+}
+
+static int add_fake_job(int deadline_ms) {
+    memset(&fake, 0, sizeof(fake));
+    memset(buffers, 0, sizeof(buffers));
+    collector_job_t job = {
+        .name = "fake",
+        .collect = collect_fake,
+        .prepare = prepare_fake,
+        .release = release_fake,
+        .arg = &fake,
+        .buffers = { &buffers[0], &buffers[1], &buffers[2] },
+        .deadline_ms = deadline_ms,
+    };
+    return collector_pool_add(&job);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* ==================== Snapshot Tests ==================== */
+
+TEST(test_runs_and_publishes) {
+    ASSERT(collector_pool_init());
+    int id = add_fake_job(1000);
+    ASSERT(id >= 0);
+
+    collector_status_t status;
+    ASSERT(collector_pool_latest(id, &status) == NULL);
+
+    for (int frame = 1; frame <= 5; frame++) {
+        collector_pool_submit(POOL_ALL_JOBS);
+        collector_pool_wait();
+        const int *snap = collector_pool_latest(id, &status);
+        ASSERT(snap != NULL);
+        ASSERT_EQ(*snap, frame);
+        ASSERT(!status.stale);
+    }
+    ASSERT_EQ(fake.prepared, 5);
+
+    ASSERT_EQ(collector_pool_cleanup(), 0);
+    /* Every buffer is released once the workers are gone */
+    ASSERT_EQ(fake.releases, 3);
+}
+
+TEST(test_slow_job_goes_stale) {
+    ASSERT(collector_pool_init());
+    int id = add_fake_job(50);
+
+    collector_status_t status;
+    collector_pool_submit(POOL_ALL_JOBS);
+    collector_pool_wait();
+    ASSERT_EQ(*(const int *)collector_pool_latest(id, &status), 1);
+
+    /* The frame gives up at the deadline and keeps the old snapshot */
+    __atomic_store_n(&fake.delay_ms, 300, __ATOMIC_RELEASE);
+    double start = now_seconds();
+    collector_pool_submit(POOL_ALL_JOBS);
+    collector_pool_wait();
+    ASSERT(now_seconds() - start < 0.2);
+    ASSERT_EQ(*(const int *)collector_pool_latest(id, &status), 1);
+    ASSERT(status.stale);
+
+    /* Still running: not queued or prepared again, and not waited for */
+    start = now_seconds();
+    collector_pool_submit(POOL_ALL_JOBS);
+    collector_pool_wait();
+    ASSERT(now_seconds() - start < 0.02);
+    ASSERT_EQ(fake.prepared, 2);
+
+    usleep(350000);
+    ASSERT_EQ(*(const int *)collector_pool_latest(id, &status), 2);
+    ASSERT(!status.stale);
+
+    collector_pool_cleanup();
+}
+
+TEST(test_failed_run_keeps_snapshot) {
+    ASSERT(collector_pool_init());
+    int id = add_fake_job(1000);
+
+    collector_status_t status;
+    collector_pool_submit(POOL_ALL_JOBS);
+    collector_pool_wait();
+    ASSERT_EQ(*(const int *)collector_pool_latest(id, &status), 1);
+
+    __atomic_store_n(&fake.fail, 1, __ATOMIC_RELEASE);
+    collector_pool_submit(POOL_ALL_JOBS);
+    collector_pool_wait();
+    ASSERT_EQ(*(const int *)collector_pool_latest(id, &status), 1);
+    ASSERT(status.stale);
+
+    collector_pool_cleanup();
+}
+
+/* ==================== Disk Job Tests ==================== */
+
+/* Nodes with hundreds of mounts get every one checked */
+#define MANY_MOUNTS 200
+
+TEST(test_disk_job_beyond_64_mounts) {
+    static const char *mounts[MANY_MOUNTS];
+    for (int i = 0; i < MANY_MOUNTS; i++) {
+        mounts[i] = (i % 2) ? "/tmp" : "/";
+    }
+
+    static disk_job_t job;
+    static disk_metrics_list_t snapshots[3];
+    ASSERT(collector_pool_init());
+    collector_job_t desc = {
+        .name = "disks",
+        .collect = disk_job_collect,
+        .prepare = disk_job_prepare,
+        .release = disk_job_release,
+        .arg = &job,
+        .buffers = { &snapshots[0], &snapshots[1], &snapshots[2] },
+        .deadline_ms = 2000,
+    };
+    int id = collector_pool_add(&desc);
+
+    job.source = mounts;
+    job.source_count = MANY_MOUNTS;
+    collector_pool_submit(POOL_ALL_JOBS);
+    collector_pool_wait();
+
+    collector_status_t status;
+    const disk_metrics_list_t *disks = collector_pool_latest(id, &status);
+    ASSERT(disks != NULL);
+    ASSERT_EQ(disks->count, MANY_MOUNTS);
+    ASSERT(strcmp(disks->disks[MANY_MOUNTS - 1].mount_point, "/tmp") == 0);
+
+    /* The copy was taken at submit; the source may change afterwards */
+    ASSERT_EQ(job.count, MANY_MOUNTS);
+    ASSERT(job.path_ptrs[MANY_MOUNTS - 1] != mounts[MANY_MOUNTS - 1]);
+
+    collector_pool_cleanup();
+    disk_job_free(&job);
+}
+
+/* ==================== Shutdown Tests ==================== */
+
+/* Last: the stuck worker outlives the pool */
+TEST(test_cleanup_leaves_hung_worker) {
+    static int quick_buffers[3];
+    ASSERT(collector_pool_init());
+    int id = add_fake_job(10);
+    __atomic_store_n(&fake.delay_ms, 3000, __ATOMIC_RELEASE);
+    collector_job_t quick = {
+        .name = "quick",
+        .collect = collect_quick,
+        .buffers = { &quick_buffers[0], &quick_buffers[1], &quick_buffers[2] },
+        .deadline_ms = 1000,
+    };
+    int quick_id = collector_pool_add(&quick);
+
+    collector_pool_submit(POOL_ALL_JOBS);
+    collector_pool_wait();
+
+    double start = now_seconds();
+    uint32_t running = collector_pool_cleanup();
+    double took = now_seconds() - start;
+    ASSERT(took > 0.9 && took < 1.5);
+    /* Only the stuck job is reported, so the caller keeps its state */
+    ASSERT_EQ(running, 1u << id);
+    ASSERT(!(running & (1u << quick_id)));
+    /* Its buffers stay with the worker */
+    ASSERT_EQ(fake.releases, 0);
+}
+
+int main(void) {
+    printf("Running collector pool tests...\n\n");
+
+    printf("Snapshot tests:\n");
+    RUN_TEST(test_runs_and_publishes);
+    RUN_TEST(test_slow_job_goes_stale);
+    RUN_TEST(test_failed_run_keeps_snapshot);
+
+    printf("\nDisk job tests:\n");
+    RUN_TEST(test_disk_job_beyond_64_mounts);
+
+    printf("\nShutdown tests:\n");
+    RUN_TEST(test_cleanup_leaves_hung_worker);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
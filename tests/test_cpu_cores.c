@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../src/cpu_cores.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %d but got %d\n    at %s:%d\n", (int)(b), (int)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_DOUBLE_EQ(a, b) do { \
+    if (fabs((a) - (b)) > 0.001) { \
+        printf("FAILED\n    Expected %.3f but got %.3f\n    at %s:%d\n", (double)(b), (double)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+static cpu_core_ticks_t prev, cur;
+static cpu_core_metrics_t out;
+
+static void reset(void) {
+    memset(&prev, 0, sizeof(prev));
+    memset(&cur, 0, sizeof(cur));
+    memset(&out, 0, sizeof(out));
+}
+
+/* Test: per-core percentages from simple deltas */
+TEST(test_compute_basic) {
+    reset();
+    /* core 0: 30 user + 20 system out of 100 */
+    cur.user[0] = 30; cur.system[0] = 20; cur.total[0] = 100;
+    /* core 1: fully idle */
+    cur.total[1] = 100;
+
+    cpu_cores_compute(&prev, &cur, 2, &out);
+
+    ASSERT_EQ(out.count, 2);
+    ASSERT_DOUBLE_EQ(out.user_percent[0], 30.0);
+    ASSERT_DOUBLE_EQ(out.system_percent[0], 20.0);
+    ASSERT_DOUBLE_EQ(out.total_percent[0], 50.0);
+    ASSERT_DOUBLE_EQ(out.total_percent[1], 0.0);
+}
+
+/* Test: one hot core among many idle ones is reported on its own */
+TEST(test_compute_hot_core_not_averaged) {
+    reset();
+    for (int i = 0; i < 256; i++) {
+        prev.total[i] = 1000;
+        cur.total[i] = 1100;
+    }
+    cur.user[17] = 100;
+
+    cpu_cores_compute(&prev, &cur, 256, &out);
+
+    ASSERT_EQ(out.count, 256);
+    ASSERT_DOUBLE_EQ(out.total_percent[17], 100.0);
+    ASSERT_DOUBLE_EQ(out.total_percent[16], 0.0);
+    ASSERT_DOUBLE_EQ(out.total_percent[18], 0.0);
+}
+
+/* Test: a core whose counters did not advance or went backwards reads 0% */
+TEST(test_compute_stalled_or_offline_core) {
+    reset();
+    prev.user[0] = 50; prev.total[0] = 100;
+    cur.user[0] = 50; cur.total[0] = 100;    /* no progress */
+    prev.user[1] = 50; prev.total[1] = 100;  /* offlined: counters zeroed */
+
+    cpu_cores_compute(&prev, &cur, 2, &out);
+
+    ASSERT_DOUBLE_EQ(out.total_percent[0], 0.0);
+    ASSERT_DOUBLE_EQ(out.total_percent[1], 0.0);
+}
+
+/* Test: large absolute counters still produce correct deltas */
+TEST(test_compute_large_counters) {
+    reset();
+    prev.user[0] = 0x123456789000ULL; prev.total[0] = 0x223456789000ULL;
+    cur.user[0] = prev.user[0] + 75;  cur.total[0] = prev.total[0] + 100;
+
+    cpu_cores_compute(&prev, &cur, 1, &out);
+
+    ASSERT_DOUBLE_EQ(out.user_percent[0], 75.0);
+}
+
+/* Test: count is clamped to MAX_CPU_CORES */
+TEST(test_compute_clamps_count) {
+    reset();
+    cpu_cores_compute(&prev, &cur, MAX_CPU_CORES + 10, &out);
+    ASSERT_EQ(out.count, MAX_CPU_CORES);
+}
+
+int main(void) {
+    printf("Running per-core CPU tests...\n\n");
+
+    printf("Delta kernel tests:\n");
+    RUN_TEST(test_compute_basic);
+    RUN_TEST(test_compute_hot_core_not_averaged);
+    RUN_TEST(test_compute_stalled_or_offline_core);
+    RUN_TEST(test_compute_large_counters);
+    RUN_TEST(test_compute_clamps_count);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/metrics_cpufreq.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+/* ==================== Fake sysfs tree ==================== */
+
+#include "fake_fs.h"
+
+static void add_cpu(int cpu, const char *cur_khz, const char *max_khz) {
+    char rel[128];
+    snprintf(rel, sizeof(rel), "devices/system/cpu/cpu%d/cpufreq", cpu);
+    make_dirs(rel);
+    snprintf(rel, sizeof(rel), "devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq", cpu);
+    write_file(rel, cur_khz);
+    snprintf(rel, sizeof(rel), "devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+    write_file(rel, max_khz);
+}
+
+/* ==================== cpufreq Tests ==================== */
+
+TEST(test_reads_scaling_cur_freq) {
+    make_root("test_cpufreq");
+
+    add_cpu(0, "3500000\n", "4000000\n");
+    add_cpu(1, "1500000\n", "4000000\n");
+    /* Neighbours of the cpuN directories that must be skipped */
+    make_dirs("devices/system/cpu/cpufreq");
+    make_dirs("devices/system/cpu/cpuidle");
+
+    ASSERT(cpufreq_metrics_init(root, "/nonexistent"));
+
+    static cpufreq_metrics_t f;
+    ASSERT(cpufreq_metrics_get(&f));
+    ASSERT_EQ(f.count, 2);
+    ASSERT_EQ((int)f.cur_mhz[0], 3500);
+    ASSERT_EQ((int)f.cur_mhz[1], 1500);
+    ASSERT_EQ((int)f.max_mhz[1], 4000);
+    ASSERT_EQ((int)f.avg_mhz, 2500);
+    ASSERT_EQ((int)f.avg_max_mhz, 4000);
+    ASSERT(!f.has_throttle_counts);
+
+    /* Values are re-read through the open fds */
+    write_file("devices/system/cpu/cpu1/cpufreq/scaling_cur_freq", "800000\n");
+    ASSERT(cpufreq_metrics_get(&f));
+    ASSERT_EQ((int)f.cur_mhz[1], 800);
+
+    cpufreq_metrics_cleanup();
+    remove_root();
+}
+
+TEST(test_throttle_count_deltas) {
+    make_root("test_cpufreq");
+
+    add_cpu(0, "2000000\n", "4000000\n");
+    make_dirs("devices/system/cpu/cpu0/thermal_throttle");
+    write_file("devices/system/cpu/cpu0/thermal_throttle/core_throttle_count", "17\n");
+
+    ASSERT(cpufreq_metrics_init(root, "/nonexistent"));
+
+    static cpufreq_metrics_t f;
+    ASSERT(cpufreq_metrics_get(&f));
+    ASSERT(f.has_throttle_counts);
+    /* Events before init are not reported */
+    ASSERT_EQ(f.throttle_events, 0);
+
+    write_file("devices/system/cpu/cpu0/thermal_throttle/core_throttle_count", "20\n");
+    ASSERT(cpufreq_metrics_get(&f));
+    ASSERT_EQ(f.throttle_events, 3);
+
+    ASSERT(cpufreq_metrics_get(&f));
+    ASSERT_EQ(f.throttle_events, 0);
+
+    cpufreq_metrics_cleanup();
+    remove_root();
+}
+
+/* ==================== cpuinfo Tests ==================== */
+
+TEST(test_cpuinfo_fallback) {
+    make_root("test_cpufreq");
+
+    write_file("cpuinfo",
+               "processor\t: 0\n"
+               "model name\t: Fake CPU\n"
+               "cpu MHz\t\t: 2100.000\n"
+               "\n"
+               "processor\t: 1\n"
+               "model name\t: Fake CPU\n"
+               "cpu MHz\t\t: 2900.500\n"
+               "\n");
+
+    char cpuinfo[128];
+    snprintf(cpuinfo, sizeof(cpuinfo), "%s/cpuinfo", root);
+    ASSERT(cpufreq_metrics_init(root, cpuinfo));
+
+    static cpufreq_metrics_t f;
+    ASSERT(cpufreq_metrics_get(&f));
+    ASSERT_EQ(f.count, 2);
+    ASSERT_EQ((int)f.cur_mhz[0], 2100);
+    ASSERT_EQ((int)f.cur_mhz[1], 2900);
+    ASSERT_EQ((int)f.avg_mhz, 2500);
+    /* cpuinfo has no maximum */
+    ASSERT(f.avg_max_mhz == 0.0f);
+
+    cpufreq_metrics_cleanup();
+    remove_root();
+}
+
+TEST(test_no_sources) {
+    make_root("test_cpufreq");
+    ASSERT(!cpufreq_metrics_init(root, "/nonexistent"));
+
+    static cpufreq_metrics_t f;
+    ASSERT(!cpufreq_metrics_get(&f));
+    ASSERT_EQ(f.count, 0);
+
+    cpufreq_metrics_cleanup();
+    remove_root();
+}
+
+int main(void) {
+    printf("Running CPU frequency tests...\n\n");
+
+    printf("cpufreq tests:\n");
+    RUN_TEST(test_reads_scaling_cur_freq);
+    RUN_TEST(test_throttle_count_deltas);
+
+    printf("\ncpuinfo tests:\n");
+    RUN_TEST(test_cpuinfo_fallback);
+    RUN_TEST(test_no_sources);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "../src/event_loop.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* ==================== Tick Tests ==================== */
+
+TEST(test_ticks_follow_schedule) {
+    ASSERT(event_loop_init());
+    ASSERT(event_loop_start(20));
+
+    /* Work inside a tick does not push the following ticks back */
+    double start = now_seconds();
+    int ticks = 0;
+    while (ticks < 10) {
+        loop_event_t ev;
+        ASSERT(event_loop_next(&ev));
+        ASSERT_EQ(ev.kind, LOOP_EVENT_TICK);
+        ticks += ev.ticks;
+        usleep(5000);
+    }
+    double took = now_seconds() - start;
+    ASSERT(took >= 0.195 && took < 0.26);
+
+    loop_jitter_t jitter;
+    event_loop_get_jitter(&jitter);
+    ASSERT(jitter.ticks > 0);
+    ASSERT(jitter.max_ms >= jitter.mean_ms);
+
+    event_loop_cleanup();
+}
+
+TEST(test_overrun_reports_missed_ticks) {
+    ASSERT(event_loop_init());
+    ASSERT(event_loop_start(20));
+
+    usleep(75000);
+    loop_event_t ev;
+    ASSERT(event_loop_next(&ev));
+    ASSERT_EQ(ev.kind, LOOP_EVENT_TICK);
+    ASSERT(ev.ticks >= 3);
+
+    loop_jitter_t jitter;
+    event_loop_get_jitter(&jitter);
+    ASSERT_EQ(jitter.ticks, 1);
+    ASSERT_EQ(jitter.missed, (uint64_t)ev.ticks - 1);
+
+    event_loop_cleanup();
+}
+
+/* ==================== Signal and Fd Tests ==================== */
+
+TEST(test_signals_become_events) {
+    ASSERT(event_loop_init());
+    ASSERT(event_loop_start(1000));
+
+    /* Blocked, so it waits for the loop instead of running a handler */
+    raise(SIGWINCH);
+    loop_event_t ev;
+    ASSERT(event_loop_next(&ev));
+    ASSERT_EQ(ev.kind, LOOP_EVENT_RESIZE);
+
+    raise(SIGTERM);
+    ASSERT(event_loop_next(&ev));
+    ASSERT_EQ(ev.kind, LOOP_EVENT_QUIT);
+
+    event_loop_cleanup();
+}
+
+TEST(test_watched_fd) {
+    ASSERT(event_loop_init());
+    ASSERT(event_loop_start(1000));
+
+    int fds[2];
+    ASSERT(pipe(fds) == 0);
+    ASSERT(event_loop_watch(fds[0], LOOP_WATCH_IN));
+    ASSERT(write(fds[1], "x", 1) == 1);
+
+    loop_event_t ev;
+    ASSERT(event_loop_next(&ev));
+    ASSERT_EQ(ev.kind, LOOP_EVENT_FD);
+    ASSERT_EQ(ev.fd, fds[0]);
+    ASSERT(ev.events & LOOP_WATCH_IN);
+
+    /* Once unwatched, the next event is the timer */
+    event_loop_unwatch(fds[0]);
+    ASSERT(event_loop_next(&ev));
+    ASSERT_EQ(ev.kind, LOOP_EVENT_TICK);
+
+    close(fds[0]);
+    close(fds[1]);
+    event_loop_cleanup();
+}
+
+int main(void) {
+    printf("Running event loop tests...\n\n");
+
+    printf("Tick tests:\n");
+    RUN_TEST(test_ticks_follow_schedule);
+    RUN_TEST(test_overrun_reports_missed_ticks);
+
+    printf("\nSignal and fd tests:\n");
+    RUN_TEST(test_signals_become_events);
+    RUN_TEST(test_watched_fd);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../src/metrics_exec.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static exec_command_config_t command(const char *name, const char *cmdline,
+                                     int interval_ms, int timeout_ms) {
+    exec_command_config_t c;
+    memset(&c, 0, sizeof(c));
+    snprintf(c.name, sizeof(c.name), "%s", name);
+    snprintf(c.command, sizeof(c.command), "%s", cmdline);
+    c.interval_ms = interval_ms;
+    c.timeout_ms = timeout_ms;
+    return c;
+}
+
+/* Poll like the render loop until the first command leaves status, or
+   fail after ~3 s; every poll must return promptly */
+static void poll_until_not(exec_metrics_t *m, exec_status_t status) {
+    for (int tries = 0; tries < 300; tries++) {
+        double start = now_seconds();
+        ASSERT(exec_metrics_get(m));
+        ASSERT(now_seconds() - start < 0.05);
+        if (m->commands[0].status != status) return;
+        usleep(10000);
+    }
+    ASSERT(!"command never finished");
+}
+
+/* ==================== Parser Tests ==================== */
+
+TEST(test_parse_key_values) {
+    const char *out = "depth 42\n# comment\n\n  lag\t1.5\nbroken\nname text\nlast -3";
+    exec_value_t v[MAX_EXEC_VALUES];
+
+    int n = exec_parse_output(out, strlen(out), v, MAX_EXEC_VALUES);
+    ASSERT_EQ(n, 3);
+    ASSERT(strcmp(v[0].key, "depth") == 0);
+    ASSERT(v[0].value == 42.0);
+    ASSERT(strcmp(v[1].key, "lag") == 0);
+    ASSERT(v[1].value == 1.5);
+    ASSERT(strcmp(v[2].key, "last") == 0);
+    ASSERT(v[2].value == -3.0);
+}
+
+TEST(test_parse_limits) {
+    const char *out = "a_key_much_longer_than_the_limit 1\nb 2\nc 3\n";
+    exec_value_t v[2];
+
+    ASSERT_EQ(exec_parse_output(out, strlen(out), v, 2), 2);
+    ASSERT_EQ(strlen(v[0].key), EXEC_KEY_LEN - 1);
+}
+
+/* ==================== Run Tests ==================== */
+
+TEST(test_runs_command) {
+    exec_command_config_t c = command("queue", "echo 'depth 42'; echo 'lag 1.5'", 10000, 2000);
+    ASSERT(exec_metrics_init(&c, 1));
+
+    static exec_metrics_t m;
+    poll_until_not(&m, EXEC_STATUS_PENDING);
+    ASSERT_EQ(m.count, 1);
+    ASSERT(strcmp(m.commands[0].name, "queue") == 0);
+    ASSERT_EQ(m.commands[0].status, EXEC_STATUS_OK);
+    ASSERT_EQ(m.commands[0].value_count, 2);
+    ASSERT(m.commands[0].values[0].value == 42.0);
+    ASSERT(!m.commands[0].stale);
+
+    exec_metrics_cleanup();
+}
+
+TEST(test_failed_run_keeps_last_values) {
+    char flag[] = "/tmp/test_exec_XXXXXX";
+    int fd = mkstemp(flag);
+    ASSERT(fd >= 0);
+    close(fd);
+    unlink(flag);
+
+    /* Good once, then exits 3 after printing a value that must be ignored */
+    char cmdline[128];
+    snprintf(cmdline, sizeof(cmdline),
+             "if [ -e %s ]; then echo 'v 2'; exit 3; fi; touch %s; echo 'v 1'", flag, flag);
+    exec_command_config_t c = command("check", cmdline, 100, 1000);
+    ASSERT(exec_metrics_init(&c, 1));
+
+    static exec_metrics_t m;
+    poll_until_not(&m, EXEC_STATUS_PENDING);
+    ASSERT_EQ(m.commands[0].status, EXEC_STATUS_OK);
+    poll_until_not(&m, EXEC_STATUS_OK);
+
+    ASSERT_EQ(m.commands[0].status, EXEC_STATUS_FAILED);
+    ASSERT_EQ(m.commands[0].exit_code, 3);
+    ASSERT(m.commands[0].values[0].value == 1.0);
+    ASSERT(m.commands[0].stale);
+
+    exec_metrics_cleanup();
+    unlink(flag);
+}
+
+TEST(test_hung_command_times_out) {
+    exec_command_config_t c[2] = {
+        command("hung", "sleep 30", 10000, 100),
+        command("empty", "", 10000, 100),
+    };
+    /* The empty command is skipped */
+    ASSERT(exec_metrics_init(c, 2));
+
+    static exec_metrics_t m;
+    double start = now_seconds();
+    poll_until_not(&m, EXEC_STATUS_PENDING);
+    ASSERT_EQ(m.count, 1);
+    ASSERT_EQ(m.commands[0].status, EXEC_STATUS_TIMEOUT);
+    ASSERT(now_seconds() - start < 1.0);
+
+    exec_metrics_cleanup();
+}
+
+TEST(test_no_commands) {
+    exec_command_config_t c = command("none", "", 1000, 100);
+    ASSERT(!exec_metrics_init(&c, 1));
+
+    static exec_metrics_t m;
+    ASSERT(!exec_metrics_get(&m));
+    ASSERT_EQ(m.count, 0);
+
+    exec_metrics_cleanup();
+}
+
+int main(void) {
+    printf("Running exec collector tests...\n\n");
+
+    printf("Parser tests:\n");
+    RUN_TEST(test_parse_key_values);
+    RUN_TEST(test_parse_limits);
+
+    printf("\nRun tests:\n");
+    RUN_TEST(test_runs_command);
+    RUN_TEST(test_failed_run_keeps_last_values);
+    RUN_TEST(test_hung_command_times_out);
+    RUN_TEST(test_no_commands);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
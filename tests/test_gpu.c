@@ -0,0 +1,246 @@
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+#include "../src/metrics_gpu.h"
+
+/* Runs against tests/fake_nvml.c, found through LD_LIBRARY_PATH */
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+/* Look up a counter exported by the fake library the collector loaded */
+static unsigned int fake_counter(const char *symbol) {
+    void *lib = dlopen("libnvidia-ml.so.1", RTLD_NOW | RTLD_NOLOAD);
+    ASSERT(lib != NULL);
+    unsigned int (*fn)(void);
+    *(void **)&fn = dlsym(lib, symbol);
+    ASSERT(fn != NULL);
+    unsigned int value = fn();
+    dlclose(lib);
+    return value;
+}
+
+/* Call a hook exported by the fake library the collector loaded */
+static void fake_hook(const char *symbol) {
+    void *lib = dlopen("libnvidia-ml.so.1", RTLD_NOW | RTLD_NOLOAD);
+    ASSERT(lib != NULL);
+    void (*fn)(void);
+    *(void **)&fn = dlsym(lib, symbol);
+    ASSERT(fn != NULL);
+    fn();
+    dlclose(lib);
+}
+
+/* Poll until the sampler has published utilization and memory for every
+   device; summaries are held between samples, so they stay valid after */
+static void wait_for_sampler(gpu_metrics_list_t *list) {
+    for (int tries = 0; tries < 300; tries++) {
+        ASSERT(gpu_metrics_get(list));
+        bool ready = true;
+        for (int i = 0; i < list->count; i++) {
+            if (list->gpus[i].utilization_max == 0 || list->gpus[i].memory_total == 0) {
+                ready = false;
+            }
+        }
+        if (ready) return;
+        usleep(10000);
+    }
+    ASSERT(!"sampler never published");
+}
+
+/* ==================== Enumeration Tests ==================== */
+
+TEST(test_enumerates_all_devices) {
+    static gpu_metrics_list_t list;
+    setenv("FAKE_NVML_DEVICES", "8", 1);
+
+    ASSERT(gpu_metrics_init());
+    wait_for_sampler(&list);
+    ASSERT_EQ(list.count, 8);
+
+    for (int i = 0; i < list.count; i++) {
+        char expected[32];
+        snprintf(expected, sizeof(expected), "Fake GPU %d", i);
+        ASSERT_EQ(list.gpus[i].index, i);
+        ASSERT(strcmp(list.gpus[i].name, expected) == 0);
+        ASSERT_EQ(list.gpus[i].temperature_celsius, 40 + i);
+        ASSERT_EQ(list.gpus[i].memory_used, (uint64_t)(i + 1) << 30);
+        ASSERT_EQ(list.gpus[i].power_limit_watts, 700);
+        ASSERT(list.gpus[i].available);
+    }
+
+    gpu_metrics_cleanup();
+}
+
+TEST(test_device_count_capped) {
+    static gpu_metrics_list_t list;
+    setenv("FAKE_NVML_DEVICES", "20", 1);
+
+    ASSERT(gpu_metrics_init());
+    ASSERT(gpu_metrics_get(&list));
+    ASSERT_EQ(list.count, MAX_GPUS);
+
+    gpu_metrics_cleanup();
+}
+
+TEST(test_no_devices) {
+    static gpu_metrics_list_t list;
+    setenv("FAKE_NVML_DEVICES", "0", 1);
+
+    ASSERT(!gpu_metrics_init());
+    ASSERT(!gpu_metrics_get(&list));
+    ASSERT_EQ(list.count, 0);
+
+    gpu_metrics_cleanup();
+}
+
+/* ==================== Sampler Tests ==================== */
+
+TEST(test_sampled_utilization_range) {
+    static gpu_metrics_list_t list;
+    setenv("FAKE_NVML_DEVICES", "3", 1);
+
+    ASSERT(gpu_metrics_init());
+    wait_for_sampler(&list);
+
+    /* The fake cycles base, base+10, base+20 */
+    for (int i = 0; i < list.count; i++) {
+        int base = (i + 1) * 5;
+        ASSERT_EQ(list.gpus[i].utilization_min, base);
+        ASSERT_EQ(list.gpus[i].utilization_max, base + 20);
+        ASSERT_EQ(list.gpus[i].utilization_percent, base + 10);
+    }
+
+    gpu_metrics_cleanup();
+}
+
+TEST(test_falls_back_to_utilization_rates) {
+    static gpu_metrics_list_t list;
+    setenv("FAKE_NVML_DEVICES", "2", 1);
+    setenv("FAKE_NVML_NO_SAMPLES", "1", 1);
+
+    ASSERT(gpu_metrics_init());
+    wait_for_sampler(&list);
+
+    for (int i = 0; i < list.count; i++) {
+        int base = (i + 1) * 5;
+        ASSERT_EQ(list.gpus[i].utilization_min, base);
+        ASSERT_EQ(list.gpus[i].utilization_max, base);
+        ASSERT_EQ(list.gpus[i].utilization_percent, base);
+    }
+
+    gpu_metrics_cleanup();
+    unsetenv("FAKE_NVML_NO_SAMPLES");
+}
+
+/* ==================== Process Tests ==================== */
+
+TEST(test_processes_attributed) {
+    static gpu_metrics_list_t list;
+    setenv("FAKE_NVML_DEVICES", "2", 1);
+    prctl(PR_SET_NAME, "gpu_worker", 0, 0, 0);
+
+    ASSERT(gpu_metrics_init());
+    wait_for_sampler(&list);
+
+    for (int i = 0; i < list.count; i++) {
+        const gpu_metrics_t *gpu = &list.gpus[i];
+        ASSERT_EQ(gpu->process_count, 2);
+
+        /* Largest VRAM user first */
+        ASSERT_EQ(gpu->processes[0].pid, getpid());
+        ASSERT(strcmp(gpu->processes[0].name, "gpu_worker") == 0);
+        ASSERT_EQ(gpu->processes[0].memory_used, (uint64_t)(i + 1) << 28);
+        ASSERT_EQ(gpu->processes[0].sm_percent, 30 + i);
+
+        ASSERT(strcmp(gpu->processes[1].name, "?") == 0);
+        ASSERT_EQ(gpu->processes[1].sm_percent, -1);
+    }
+
+    /* While the PID stays on the GPU its name comes from the cache */
+    prctl(PR_SET_NAME, "renamed", 0, 0, 0);
+    usleep(700000);
+    ASSERT(gpu_metrics_get(&list));
+    ASSERT(strcmp(list.gpus[0].processes[0].name, "gpu_worker") == 0);
+
+    /* A pass with no new utilization sample keeps the last known value */
+    fake_hook("fake_nvml_stop_process_samples");
+    usleep(700000);
+    ASSERT(gpu_metrics_get(&list));
+    ASSERT_EQ(list.gpus[0].processes[0].sm_percent, 30);
+    ASSERT_EQ(list.gpus[0].processes[1].sm_percent, -1);
+
+    gpu_metrics_cleanup();
+    prctl(PR_SET_NAME, "test_gpu", 0, 0, 0);
+}
+
+/* ==================== Caching Tests ==================== */
+
+TEST(test_name_queried_once) {
+    static gpu_metrics_list_t list;
+    setenv("FAKE_NVML_DEVICES", "4", 1);
+
+    ASSERT(gpu_metrics_init());
+    for (int frame = 0; frame < 10; frame++) {
+        ASSERT(gpu_metrics_get(&list));
+    }
+
+    /* One name lookup per device at init, none per frame */
+    ASSERT_EQ(fake_counter("fake_nvml_name_calls"), 4);
+    /* Device queries all come from the sampler thread */
+    ASSERT_EQ(fake_counter("fake_nvml_init_thread_queries"), 0);
+
+    gpu_metrics_cleanup();
+}
+
+int main(void) {
+    printf("Running GPU tests...\n\n");
+
+    printf("Enumeration tests:\n");
+    RUN_TEST(test_enumerates_all_devices);
+    RUN_TEST(test_device_count_capped);
+    RUN_TEST(test_no_devices);
+
+    printf("\nSampler tests:\n");
+    RUN_TEST(test_sampled_utilization_range);
+    RUN_TEST(test_falls_back_to_utilization_rates);
+
+    printf("\nProcess tests:\n");
+    RUN_TEST(test_processes_attributed);
+
+    printf("\nCaching tests:\n");
+    RUN_TEST(test_name_queried_once);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
@@ -4,6 +4,19 @@
 #include <math.h>
 #include "../src/config.h"
 #include "../src/render.h"
+#include "../src/history.h"
+
+#ifdef _WIN32
+#include <io.h>
+#define dup _dup
+#define dup2 _dup2
+#define close _close
+#define fileno _fileno
+#define NULL_DEVICE "NUL"
+#else
+#include <unistd.h>
+#define NULL_DEVICE "/dev/null"
+#endif
 
 /* Simple test framework */
 static int tests_run = 0;
@@ -188,6 +201,86 @@ TEST(test_history_count_enum) {
     ASSERT_EQ(RENDER_HISTORY_COUNT, 4);
 }
 
+/* Test: history_max scans only the newest n samples */
+TEST(test_history_max_window) {
+    history_t h;
+    history_clear(&h);
+
+    ASSERT_DOUBLE_EQ(history_max(&h, 10), 0.0);
+
+    history_add(&h, 900.0);   /* Falls outside a 3-sample window */
+    history_add(&h, 10.0);
+    history_add(&h, 30.0);
+    history_add(&h, 20.0);
+
+    ASSERT_DOUBLE_EQ(history_max(&h, 3), 30.0);
+    ASSERT_DOUBLE_EQ(history_max(&h, 4), 900.0);
+    ASSERT_DOUBLE_EQ(history_max(&h, 100), 900.0);
+}
+
+/* Test: history_min scans only the newest n samples */
+TEST(test_history_min_window) {
+    history_t h;
+    history_clear(&h);
+
+    ASSERT_DOUBLE_EQ(history_min(&h, 10), 0.0);
+
+    history_add(&h, 5.0);     /* Falls outside a 3-sample window */
+    history_add(&h, 800.0);
+    history_add(&h, 1200.0);
+    history_add(&h, 900.0);
+
+    ASSERT_DOUBLE_EQ(history_min(&h, 3), 800.0);
+    ASSERT_DOUBLE_EQ(history_min(&h, 4), 5.0);
+    ASSERT_DOUBLE_EQ(history_min(&h, 100), 5.0);
+}
+
+/* ==================== Render Tests ==================== */
+
+/* Draw a frame with its terminal output discarded */
+static void render_quietly(const config_t *cfg, const dashboard_data_t *data) {
+    fflush(stdout);
+    int saved = dup(fileno(stdout));
+    FILE *sink = fopen(NULL_DEVICE, "w");
+    ASSERT(saved >= 0 && sink != NULL);
+    dup2(fileno(sink), fileno(stdout));
+
+    render_dashboard(cfg, data);
+
+    fflush(stdout);
+    dup2(saved, fileno(stdout));
+    close(saved);
+    fclose(sink);
+}
+
+/* Test: frames redrawn without a new CPU sample add no history points */
+TEST(test_render_adds_history_only_when_fresh) {
+    config_t cfg;
+    config_init_defaults(&cfg);
+    cfg.graph_style = GRAPH_STYLE_LINE;
+    cfg.show_cpu_cores = false;
+
+    cpu_metrics_t cpu;
+    memset(&cpu, 0, sizeof(cpu));
+    cpu.total_percent = 42.0;
+    cpu.temperature_celsius = -1;
+
+    render_history_clear(RENDER_HISTORY_CPU);
+    dashboard_data_t data = { .cpu = &cpu, .fresh = DASHBOARD_FRESH_CPU };
+    render_quietly(&cfg, &data);
+    ASSERT_EQ(render_history_count(RENDER_HISTORY_CPU), 1);
+
+    /* Redrawn for some other collector: the CPU graph is unchanged */
+    data.fresh = DASHBOARD_FRESH_MEMORY;
+    render_quietly(&cfg, &data);
+    render_quietly(&cfg, &data);
+    ASSERT_EQ(render_history_count(RENDER_HISTORY_CPU), 1);
+
+    data.fresh = DASHBOARD_FRESH_CPU;
+    render_quietly(&cfg, &data);
+    ASSERT_EQ(render_history_count(RENDER_HISTORY_CPU), 2);
+}
+
 int main(void) {
     printf("Running graph/history tests...\n\n");
 
@@ -206,6 +299,11 @@ int main(void) {
     RUN_TEST(test_history_boundary_values);
     RUN_TEST(test_all_history_types);
     RUN_TEST(test_history_count_enum);
+    RUN_TEST(test_history_max_window);
+    RUN_TEST(test_history_min_window);
+
+    printf("\nRender tests:\n");
+    RUN_TEST(test_render_adds_history_only_when_fresh);
 
     printf("\n========================================\n");
     printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/metrics_irq.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+/* ==================== Fake /proc ==================== */
+
+#include "fake_fs.h"
+
+/* Four CPUs; CPU 2 is offline, so /proc/interrupts skips its column while
+   /proc/softirqs (possible CPUs) keeps it */
+static void write_sample(unsigned nic_on_cpu3, unsigned net_rx_on_cpu3, unsigned loc_on_cpu0,
+                         unsigned ctxt) {
+    char buf[2048];
+    snprintf(buf, sizeof(buf),
+             "           CPU0       CPU1       CPU3\n"
+             "  0:         10          0          0   IO-APIC   2-edge      timer\n"
+             " 24:        100        100        %u   PCI-MSI 524288-edge      eth0-TxRx-0\n"
+             " 25:         50         50         50   PCI-MSI 524289-edge      nvme0q1\n"
+             "LOC:     %u     900000     900000   Local timer interrupts\n"
+             "ERR:          0\n",
+             nic_on_cpu3, loc_on_cpu0);
+    write_file("interrupts", buf);
+
+    snprintf(buf, sizeof(buf),
+             "                    CPU0       CPU1       CPU2       CPU3\n"
+             "          HI:          1          1          0          1\n"
+             "       TIMER:       1000       1000          0       1000\n"
+             "      NET_RX:         10         10          0         %u\n"
+             "         RCU:        500        500          0        500\n",
+             net_rx_on_cpu3);
+    write_file("softirqs", buf);
+
+    snprintf(buf, sizeof(buf),
+             "cpu  1 2 3 4 5 6 7 8 9 10\n"
+             "intr 5000 10 0 0\n"
+             "ctxt %u\n"
+             "btime 1700000000\n",
+             ctxt);
+    write_file("stat", buf);
+}
+
+/* ==================== Kernel Tests ==================== */
+
+TEST(test_rates_compute) {
+    uint64_t prev[5] = { 100, 200, 300, 400, 500 };
+    uint64_t cur[5] = { 150, 200, 1300, 390, 500 };
+    float out[5];
+
+    irq_rates_compute(prev, cur, 5, 2.0f, out);
+    ASSERT_EQ((int)out[0], 100);
+    ASSERT_EQ((int)out[1], 0);
+    ASSERT_EQ((int)out[2], 2000);
+    /* Went backwards: clamped rather than wrapping */
+    ASSERT_EQ((int)out[3], 0);
+}
+
+TEST(test_find_hot) {
+    float rates[4] = { 1000.0f, 1100.0f, 9000.0f, 900.0f };
+    uint8_t hot[4] = { 0, 0, 0, 0 };
+
+    ASSERT_EQ(irq_find_hot(rates, 4, 500.0f, IRQ_HOT_HARD, hot), 1);
+    ASSERT_EQ(hot[2], IRQ_HOT_HARD);
+    ASSERT_EQ(hot[0], 0);
+
+    /* Imbalanced but below the floor: not worth flagging */
+    memset(hot, 0, sizeof(hot));
+    float quiet[4] = { 1.0f, 1.0f, 90.0f, 1.0f };
+    ASSERT_EQ(irq_find_hot(quiet, 4, 500.0f, IRQ_HOT_HARD, hot), 0);
+
+    /* A single CPU cannot be imbalanced */
+    ASSERT_EQ(irq_find_hot(rates + 2, 1, 0.0f, IRQ_HOT_HARD, hot), 0);
+}
+
+/* ==================== Collector Tests ==================== */
+
+TEST(test_nic_pinned_to_one_cpu) {
+    make_root("test_irq");
+    write_sample(100, 10, 900000, 1000);
+    ASSERT(irq_metrics_init(root));
+
+    /* eth0 and NET_RX move on CPU 3; the local timer (an architecture
+       row, not device load) fires a lot on CPU 0 */
+    usleep(20000);
+    write_sample(1000100, 4000010, 9900000, 2000);
+
+    static irq_metrics_t irq;
+    ASSERT(irq_metrics_get(&irq));
+
+    ASSERT_EQ(irq.cpu_count, 4);
+    ASSERT(irq.hardirq_rate[3] > 0.0f);
+    ASSERT_EQ((int)irq.hardirq_rate[0], 0);
+    ASSERT_EQ((int)irq.hardirq_rate[2], 0);
+    ASSERT(irq.net_rx_rate[3] > 0.0f);
+    ASSERT((int)irq.softirq_rate[3] == (int)irq.net_rx_rate[3]);
+
+    ASSERT_EQ(irq.hot[3], IRQ_HOT_HARD | IRQ_HOT_SOFT);
+    ASSERT_EQ(irq.hot_count, 1);
+    ASSERT(strcmp(irq.top_source, "eth0-TxRx-0") == 0);
+    ASSERT(irq.top_source_rate > 0.0);
+    ASSERT(irq.ctxt_rate > 0.0);
+
+    irq_metrics_cleanup();
+    remove_root();
+}
+
+TEST(test_missing_files) {
+    make_root("test_irq");
+    ASSERT(!irq_metrics_init(root));
+
+    static irq_metrics_t irq;
+    ASSERT(!irq_metrics_get(&irq));
+
+    remove_root();
+}
+
+int main(void) {
+    printf("Running interrupt metrics tests...\n\n");
+
+    printf("Kernel tests:\n");
+    RUN_TEST(test_rates_compute);
+    RUN_TEST(test_find_hot);
+
+    printf("\nCollector tests:\n");
+    RUN_TEST(test_nic_pinned_to_one_cpu);
+    RUN_TEST(test_missing_files);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
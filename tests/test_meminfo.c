@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/meminfo.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define KB(n) ((uint64_t)(n) * 1024)
+
+/* Trimmed /proc/meminfo from a 16 GB host with a 1 GB HugeTLB pool */
+static const char sample[] =
+    "MemTotal:       16000000 kB\n"
+    "MemFree:         2000000 kB\n"
+    "MemAvailable:    9000000 kB\n"
+    "Buffers:          500000 kB\n"
+    "Cached:          6000000 kB\n"
+    "SwapCached:         1000 kB\n"
+    "Active:          7000000 kB\n"
+    "SwapTotal:       4000000 kB\n"
+    "SwapFree:        3000000 kB\n"
+    "Dirty:              2048 kB\n"
+    "Writeback:           512 kB\n"
+    "AnonPages:       5000000 kB\n"
+    "Shmem:            300000 kB\n"
+    "KReclaimable:     400000 kB\n"
+    "Slab:             600000 kB\n"
+    "SReclaimable:     400000 kB\n"
+    "AnonHugePages:    204800 kB\n"
+    "HugePages_Total:     512\n"
+    "HugePages_Free:      128\n"
+    "HugePages_Rsvd:        0\n"
+    "Hugepagesize:       2048 kB\n"
+    "Hugetlb:         1048576 kB\n";
+
+/* ==================== Field Selection Tests ==================== */
+
+TEST(test_all_fields) {
+    memory_metrics_t mem;
+    ASSERT(meminfo_parse(sample, strlen(sample), MEMORY_FIELD_ALL, &mem));
+
+    ASSERT_EQ(mem.total_bytes, KB(16000000));
+    ASSERT_EQ(mem.free_bytes, KB(9000000));
+    ASSERT_EQ(mem.used_bytes, KB(7000000));
+    ASSERT_EQ(mem.breakdown_fields, MEMORY_FIELD_ALL);
+
+    ASSERT_EQ(mem.unused_bytes, KB(2000000));
+    ASSERT_EQ(mem.buffers_bytes, KB(500000));
+    /* Cached + SReclaimable - Shmem */
+    ASSERT_EQ(mem.cached_bytes, KB(6100000));
+    ASSERT_EQ(mem.dirty_bytes, KB(2048));
+    ASSERT_EQ(mem.writeback_bytes, KB(512));
+    ASSERT_EQ(mem.swap_total_bytes, KB(4000000));
+    ASSERT_EQ(mem.swap_used_bytes, KB(1000000));
+    ASSERT_EQ(mem.hugetlb_total_bytes, KB(512 * 2048));
+    ASSERT_EQ(mem.hugetlb_used_bytes, KB(384 * 2048));
+    ASSERT_EQ(mem.thp_bytes, KB(204800));
+}
+
+TEST(test_selected_fields_only) {
+    memory_metrics_t mem;
+    ASSERT(meminfo_parse(sample, strlen(sample), MEMORY_FIELD_SWAP, &mem));
+
+    ASSERT_EQ(mem.breakdown_fields, MEMORY_FIELD_SWAP);
+    ASSERT_EQ(mem.swap_used_bytes, KB(1000000));
+    ASSERT_EQ(mem.cached_bytes, 0);
+    ASSERT_EQ(mem.dirty_bytes, 0);
+    ASSERT_EQ(mem.hugetlb_total_bytes, 0);
+
+    ASSERT(meminfo_parse(sample, strlen(sample), 0, &mem));
+    ASSERT_EQ(mem.breakdown_fields, 0);
+    ASSERT_EQ(mem.used_bytes, KB(7000000));
+}
+
+/* ==================== Fallback Tests ==================== */
+
+TEST(test_without_mem_available) {
+    /* Pre-3.14 kernels: estimate from free + buffers + cached */
+    static const char old[] =
+        "MemTotal:        1000000 kB\n"
+        "MemFree:          100000 kB\n"
+        "Buffers:           50000 kB\n"
+        "Cached:           250000 kB\n";
+    memory_metrics_t mem;
+    ASSERT(meminfo_parse(old, strlen(old), MEMORY_FIELD_ALL, &mem));
+    ASSERT_EQ(mem.free_bytes, KB(400000));
+    /* Missing groups read as zero, e.g. no swap configured */
+    ASSERT_EQ(mem.swap_total_bytes, 0);
+}
+
+TEST(test_missing_total) {
+    static const char broken[] = "MemFree:          100000 kB\n";
+    memory_metrics_t mem;
+    ASSERT(!meminfo_parse(broken, strlen(broken), MEMORY_FIELD_ALL, &mem));
+}
+
+int main(void) {
+    printf("Running meminfo parser tests...\n\n");
+
+    printf("Field selection tests:\n");
+    RUN_TEST(test_all_fields);
+    RUN_TEST(test_selected_fields_only);
+
+    printf("\nFallback tests:\n");
+    RUN_TEST(test_without_mem_available);
+    RUN_TEST(test_missing_total);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
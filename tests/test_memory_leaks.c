@@ -52,6 +52,8 @@ static SIZE_T get_current_memory_usage(void) {
 }
 #else
 /* Placeholder for non-Windows platforms */
+typedef size_t SIZE_T;
+
 static size_t get_current_memory_usage(void) {
     return 0;
 }
@@ -189,7 +191,7 @@ TEST(test_disk_metrics_no_leaks) {
 
 /* Test: repeated multi-disk metrics collection doesn't leak */
 TEST(test_multi_disk_metrics_no_leaks) {
-    disk_metrics_list_t disks;
+    disk_metrics_list_t disks = { NULL, 0, 0 };
     SIZE_T initial_mem = get_current_memory_usage();
 
     ASSERT(metrics_init() == true);
@@ -207,6 +209,7 @@ TEST(test_multi_disk_metrics_no_leaks) {
         ASSERT(disks.count > 0);
     }
 
+    metrics_free_disks(&disks);
     metrics_cleanup();
 
     SIZE_T final_mem = get_current_memory_usage();
@@ -245,7 +248,7 @@ TEST(test_full_metrics_cycle_no_leaks) {
     for (int i = 0; i < LEAK_TEST_ITERATIONS / 10; i++) {
         cpu_metrics_t cpu;
         memory_metrics_t mem;
-        disk_metrics_list_t disks;
+        disk_metrics_list_t disks = { NULL, 0, 0 };
 
         ASSERT(metrics_init() == true);
 
@@ -260,6 +263,7 @@ TEST(test_full_metrics_cycle_no_leaks) {
         metrics_get_memory(&mem);
         metrics_get_disks(paths, 1, &disks);
 
+        metrics_free_disks(&disks);
         metrics_cleanup();
     }
 
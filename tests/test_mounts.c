@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/mounts.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+static const char *const sample_mountinfo =
+    "22 1 259:2 / / rw,relatime shared:1 - ext4 /dev/nvme0n1p2 rw\n"
+    "23 22 0:21 / /proc rw,nosuid shared:12 - proc proc rw\n"
+    "24 22 259:1 / /boot/efi rw,relatime shared:2 - vfat /dev/nvme0n1p1 rw\n"
+    "25 22 259:3 / /var/lib/kubelet/pods/a rw shared:3 - xfs /dev/nvme1n1 rw\n"
+    "26 22 259:4 / /var/lib/kubelet/pods/b rw shared:4 - xfs /dev/nvme2n1 rw\n"
+    "27 22 259:5 / /mnt/with\\040space rw - ext4 /dev/sdb1 rw\n"
+    "28 22 259:6 / /mnt/with\\040space rw - ext4 /dev/sdc1 rw\n";
+
+static char mountinfo_path[64];
+
+static void write_mountinfo(const char *contents) {
+    strcpy(mountinfo_path, "/tmp/test_mountinfo_XXXXXX");
+    int fd = mkstemp(mountinfo_path);
+    ASSERT(fd >= 0);
+    ASSERT(write(fd, contents, strlen(contents)) == (ssize_t)strlen(contents));
+    close(fd);
+}
+
+static bool has_mount(const char **paths, int count, const char *path) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(paths[i], path) == 0) return true;
+    }
+    return false;
+}
+
+/* ==================== Filter Tests ==================== */
+
+TEST(test_fstype_filter) {
+    const char *fstypes[] = { "ext4", "vfat" };
+    mount_filter_t filter = { fstypes, 2, NULL, 0 };
+
+    write_mountinfo(sample_mountinfo);
+    ASSERT(mounts_init(mountinfo_path, &filter));
+
+    int count = 0;
+    const char **paths = mounts_get(&count);
+    ASSERT_EQ(count, 3);
+    ASSERT(has_mount(paths, count, "/"));
+    ASSERT(has_mount(paths, count, "/boot/efi"));
+    ASSERT(!has_mount(paths, count, "/proc"));
+
+    mounts_cleanup();
+    unlink(mountinfo_path);
+}
+
+TEST(test_glob_filter) {
+    const char *fstypes[] = { "xfs", "ext4" };
+    const char *patterns[] = { "/var/lib/kubelet/pods/*" };
+    mount_filter_t filter = { fstypes, 2, patterns, 1 };
+
+    write_mountinfo(sample_mountinfo);
+    ASSERT(mounts_init(mountinfo_path, &filter));
+
+    int count = 0;
+    const char **paths = mounts_get(&count);
+    ASSERT_EQ(count, 2);
+    ASSERT(has_mount(paths, count, "/var/lib/kubelet/pods/a"));
+    ASSERT(has_mount(paths, count, "/var/lib/kubelet/pods/b"));
+
+    mounts_cleanup();
+    unlink(mountinfo_path);
+}
+
+TEST(test_default_skips_pseudo_filesystems) {
+    mount_filter_t filter = { NULL, 0, NULL, 0 };
+
+    write_mountinfo(sample_mountinfo);
+    ASSERT(mounts_init(mountinfo_path, &filter));
+
+    int count = 0;
+    const char **paths = mounts_get(&count);
+    ASSERT(has_mount(paths, count, "/"));
+    ASSERT(!has_mount(paths, count, "/proc"));
+
+    mounts_cleanup();
+    unlink(mountinfo_path);
+}
+
+/* ==================== Parse Tests ==================== */
+
+TEST(test_escapes_and_overmounts) {
+    const char *patterns[] = { "/mnt/*" };
+    mount_filter_t filter = { NULL, 0, patterns, 1 };
+
+    write_mountinfo(sample_mountinfo);
+    ASSERT(mounts_init(mountinfo_path, &filter));
+
+    /* "\040" decodes to a space; the stacked mount is listed once */
+    int count = 0;
+    const char **paths = mounts_get(&count);
+    ASSERT_EQ(count, 1);
+    ASSERT(strcmp(paths[0], "/mnt/with space") == 0);
+
+    mounts_cleanup();
+    unlink(mountinfo_path);
+}
+
+TEST(test_many_mounts) {
+    /* Well past the old 16-path limit */
+    size_t cap = 400 * 96;
+    char *contents = malloc(cap);
+    ASSERT(contents != NULL);
+    size_t len = 0;
+    for (int i = 0; i < 400; i++) {
+        len += (size_t)snprintf(contents + len, cap - len,
+                                "%d 1 8:%d / /data/vol%d rw - ext4 /dev/sd%d rw\n",
+                                100 + i, i, i, i);
+    }
+
+    const char *fstypes[] = { "ext4" };
+    mount_filter_t filter = { fstypes, 1, NULL, 0 };
+
+    write_mountinfo(contents);
+    ASSERT(mounts_init(mountinfo_path, &filter));
+
+    int count = 0;
+    const char **paths = mounts_get(&count);
+    ASSERT_EQ(count, 400);
+    ASSERT(strcmp(paths[399], "/data/vol399") == 0);
+
+    /* A regular file never signals a change */
+    ASSERT(!mounts_refresh());
+
+    mounts_cleanup();
+    unlink(mountinfo_path);
+    free(contents);
+}
+
+int main(void) {
+    printf("Running mount discovery tests...\n\n");
+
+    printf("Filter tests:\n");
+    RUN_TEST(test_fstype_filter);
+    RUN_TEST(test_glob_filter);
+    RUN_TEST(test_default_skips_pseudo_filesystems);
+
+    printf("\nParse tests:\n");
+    RUN_TEST(test_escapes_and_overmounts);
+    RUN_TEST(test_many_mounts);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/metrics_numa.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+/* ==================== Fake sysfs tree ==================== */
+
+#include "fake_fs.h"
+
+static void write_node(int node, unsigned total_kb, unsigned free_kb,
+                       unsigned miss, unsigned foreign, unsigned local, unsigned other) {
+    char rel[128], buf[512];
+
+    snprintf(rel, sizeof(rel), "devices/system/node/node%d", node);
+    make_dirs(rel);
+
+    snprintf(rel, sizeof(rel), "devices/system/node/node%d/meminfo", node);
+    snprintf(buf, sizeof(buf),
+             "Node %d MemTotal:       %u kB\n"
+             "Node %d MemFree:        %u kB\n"
+             "Node %d MemUsed:        %u kB\n"
+             "Node %d SwapCached:            0 kB\n"
+             "Node %d FilePages:       1024 kB\n",
+             node, total_kb, node, free_kb, node, total_kb - free_kb, node, node);
+    write_file(rel, buf);
+
+    snprintf(rel, sizeof(rel), "devices/system/node/node%d/numastat", node);
+    snprintf(buf, sizeof(buf),
+             "numa_hit %u\nnuma_miss %u\nnuma_foreign %u\n"
+             "interleave_hit 0\nlocal_node %u\nother_node %u\n",
+             local, miss, foreign, local, other);
+    write_file(rel, buf);
+}
+
+/* ==================== Node Tests ==================== */
+
+TEST(test_reads_nodes_in_order) {
+    make_root("test_numa");
+
+    write_node(10, 8192, 2048, 0, 0, 100, 0);
+    write_node(0, 4096, 1024, 0, 0, 100, 0);
+    write_node(1, 4096, 4096, 0, 0, 100, 0);
+    /* Neighbours of the nodeN directories that must be skipped */
+    make_dirs("devices/system/node/power");
+    write_file("devices/system/node/possible", "0-1\n");
+
+    ASSERT(numa_metrics_init(root));
+
+    static numa_metrics_t numa;
+    ASSERT(numa_metrics_get(&numa));
+    ASSERT_EQ(numa.count, 3);
+    ASSERT_EQ(numa.nodes[0].node, 0);
+    ASSERT_EQ(numa.nodes[1].node, 1);
+    ASSERT_EQ(numa.nodes[2].node, 10);
+
+    ASSERT_EQ(numa.nodes[0].total, 4096ULL * 1024);
+    ASSERT_EQ(numa.nodes[0].free, 1024ULL * 1024);
+    ASSERT_EQ(numa.nodes[0].used, 3072ULL * 1024);
+    ASSERT_EQ(numa.nodes[0].file, 1024ULL * 1024);
+
+    numa_metrics_cleanup();
+    remove_root();
+}
+
+TEST(test_cross_node_rates) {
+    make_root("test_numa");
+
+    write_node(0, 4096, 1024, 10, 0, 1000, 0);
+    write_node(1, 4096, 1024, 0, 5, 1000, 0);
+    ASSERT(numa_metrics_init(root));
+
+    /* Node 0 served 300 allocations, a third of them for remote tasks */
+    write_node(0, 4096, 1024, 60, 0, 1200, 100);
+    write_node(1, 4096, 1024, 0, 55, 1000, 0);
+    usleep(10000);
+
+    static numa_metrics_t numa;
+    ASSERT(numa_metrics_get(&numa));
+    ASSERT_EQ(numa.count, 2);
+    ASSERT(numa.nodes[0].miss_rate > 0.0);
+    ASSERT(numa.nodes[0].foreign_rate == 0.0);
+    ASSERT(numa.nodes[0].other_node_rate > 0.0);
+    ASSERT_EQ((int)(numa.nodes[0].local_percent + 0.5f), 67);
+
+    ASSERT(numa.nodes[1].miss_rate == 0.0);
+    ASSERT(numa.nodes[1].foreign_rate > 0.0);
+    /* No allocations at all reads as fully local */
+    ASSERT_EQ((int)numa.nodes[1].local_percent, 100);
+
+    /* Rates are per interval, so an idle interval drops them to zero */
+    ASSERT(numa_metrics_get(&numa));
+    ASSERT(numa.nodes[0].miss_rate == 0.0);
+
+    numa_metrics_cleanup();
+    remove_root();
+}
+
+TEST(test_no_nodes) {
+    make_root("test_numa");
+    ASSERT(!numa_metrics_init(root));
+
+    static numa_metrics_t numa;
+    ASSERT(!numa_metrics_get(&numa));
+    ASSERT_EQ(numa.count, 0);
+
+    numa_metrics_cleanup();
+    remove_root();
+}
+
+int main(void) {
+    printf("Running NUMA tests...\n\n");
+
+    printf("Node tests:\n");
+    RUN_TEST(test_reads_nodes_in_order);
+    RUN_TEST(test_cross_node_rates);
+    RUN_TEST(test_no_nodes);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
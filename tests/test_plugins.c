@@ -0,0 +1,204 @@
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/plugins.h"
+
+/* Runs against tests/example_plugin.c, whose path is passed as argv[1] */
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+static const char *plugin_path;
+
+/* Look up a hook exported by the copy of the plugin the registry loaded */
+static void *plugin_hook(const char *symbol) {
+    void *lib = dlopen(plugin_path, RTLD_NOW | RTLD_NOLOAD);
+    ASSERT(lib != NULL);
+    void *fn = dlsym(lib, symbol);
+    ASSERT(fn != NULL);
+    dlclose(lib);
+    return fn;
+}
+
+static unsigned int sample_calls(void) {
+    unsigned int (*fn)(void);
+    *(void **)&fn = plugin_hook("example_plugin_samples");
+    return fn();
+}
+
+static void fail_samples(int fail) {
+    void (*fn)(int);
+    *(void **)&fn = plugin_hook("example_plugin_fail");
+    fn(fail);
+}
+
+/* ==================== Loading Tests ==================== */
+
+TEST(test_load_and_sample) {
+    char err[256];
+    ASSERT(plugins_load(plugin_path, err, sizeof(err)));
+
+    static plugin_metrics_t m;
+    ASSERT(plugins_get(&m));
+    ASSERT_EQ(m.count, 1);
+
+    const plugin_view_t *p = &m.plugins[0];
+    ASSERT(strcmp(p->name, "loadavg") == 0);
+    ASSERT_EQ(p->series_count, 2);
+    ASSERT(strcmp(p->series[1].name, "Runnable") == 0);
+    ASSERT(p->sampled);
+    ASSERT(!p->stale);
+    ASSERT_EQ(p->sample_cost_us, 20);
+    ASSERT(p->values[0] >= 0.0);
+    /* This process is running while it reads /proc/loadavg */
+    ASSERT(p->values[1] >= 1.0);
+
+    plugins_cleanup();
+    ASSERT(dlopen(plugin_path, RTLD_NOW | RTLD_NOLOAD) == NULL);
+}
+
+TEST(test_rejects_abi_version) {
+    char err[256];
+    setenv("EXAMPLE_PLUGIN_ABI", "2", 1);
+    ASSERT(!plugins_load(plugin_path, err, sizeof(err)));
+    unsetenv("EXAMPLE_PLUGIN_ABI");
+
+    ASSERT(strstr(err, "ABI version 2") != NULL);
+    ASSERT(dlopen(plugin_path, RTLD_NOW | RTLD_NOLOAD) == NULL);
+
+    static plugin_metrics_t m;
+    ASSERT(!plugins_get(&m));
+    ASSERT_EQ(m.count, 0);
+}
+
+TEST(test_missing_library) {
+    char err[256] = "";
+    ASSERT(!plugins_load("/nonexistent/libnothing.so", err, sizeof(err)));
+    ASSERT(err[0] != '\0');
+}
+
+/* ==================== Sampling Tests ==================== */
+
+TEST(test_min_interval) {
+    char err[256];
+    setenv("EXAMPLE_PLUGIN_INTERVAL_MS", "100", 1);
+    ASSERT(plugins_load(plugin_path, err, sizeof(err)));
+    unsetenv("EXAMPLE_PLUGIN_INTERVAL_MS");
+
+    static plugin_metrics_t m;
+    ASSERT(plugins_get(&m));
+    ASSERT(plugins_get(&m));
+    ASSERT(plugins_get(&m));
+    ASSERT_EQ(sample_calls(), 1);
+
+    usleep(120000);
+    ASSERT(plugins_get(&m));
+    ASSERT_EQ(sample_calls(), 2);
+
+    plugins_cleanup();
+}
+
+TEST(test_failed_sample_keeps_values) {
+    char err[256];
+    setenv("EXAMPLE_PLUGIN_INTERVAL_MS", "0", 1);
+    ASSERT(plugins_load(plugin_path, err, sizeof(err)));
+    unsetenv("EXAMPLE_PLUGIN_INTERVAL_MS");
+
+    static plugin_metrics_t m;
+    ASSERT(plugins_get(&m));
+    const double *slots = m.plugins[0].values;
+    double load = slots[0];
+    double runnable = slots[1];
+
+    fail_samples(1);
+    ASSERT(plugins_get(&m));
+    ASSERT(m.plugins[0].stale);
+    ASSERT(m.plugins[0].sampled);
+    ASSERT(m.plugins[0].values[0] == load);
+    ASSERT(m.plugins[0].values[1] == runnable);
+
+    /* Same preallocated slots every tick */
+    fail_samples(0);
+    ASSERT(plugins_get(&m));
+    ASSERT(!m.plugins[0].stale);
+    ASSERT(m.plugins[0].values == slots);
+    ASSERT_EQ(sample_calls(), 3);
+
+    plugins_cleanup();
+}
+
+TEST(test_failing_plugin_keeps_interval) {
+    char err[256];
+    setenv("EXAMPLE_PLUGIN_INTERVAL_MS", "100", 1);
+    ASSERT(plugins_load(plugin_path, err, sizeof(err)));
+    unsetenv("EXAMPLE_PLUGIN_INTERVAL_MS");
+    fail_samples(1);
+
+    /* Never succeeded, yet still sampled at most once per interval */
+    static plugin_metrics_t m;
+    ASSERT(plugins_get(&m));
+    ASSERT(plugins_get(&m));
+    ASSERT(plugins_get(&m));
+    ASSERT(!m.plugins[0].sampled);
+    ASSERT(m.plugins[0].stale);
+    ASSERT_EQ(sample_calls(), 1);
+
+    usleep(120000);
+    ASSERT(plugins_get(&m));
+    ASSERT_EQ(sample_calls(), 2);
+
+    fail_samples(0);
+    plugins_cleanup();
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s PLUGIN\n", argv[0]);
+        return 1;
+    }
+    plugin_path = argv[1];
+
+    printf("Running plugin registry tests...\n\n");
+
+    printf("Loading tests:\n");
+    RUN_TEST(test_load_and_sample);
+    RUN_TEST(test_rejects_abi_version);
+    RUN_TEST(test_missing_library);
+
+    printf("\nSampling tests:\n");
+    RUN_TEST(test_min_interval);
+    RUN_TEST(test_failed_sample_keeps_values);
+    RUN_TEST(test_failing_plugin_keeps_interval);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
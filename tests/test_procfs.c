@@ -0,0 +1,330 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/procfs.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+/* Write contents to a fresh temp file and return its path */
+static const char *write_temp(const char *contents) {
+    static char path[64];
+    strcpy(path, "/tmp/test_procfs_XXXXXX");
+    int fd = mkstemp(path);
+    ASSERT(fd >= 0);
+    ASSERT(write(fd, contents, strlen(contents)) == (ssize_t)strlen(contents));
+    close(fd);
+    return path;
+}
+
+/* ==================== Scanner Tests ==================== */
+
+TEST(test_parse_u64_basic) {
+    const char *s = "  12345 678";
+    const char *end = s + strlen(s);
+    uint64_t v = 0;
+
+    const char *p = procfs_parse_u64(s, end, &v);
+    ASSERT(p != NULL);
+    ASSERT_EQ(v, 12345);
+
+    p = procfs_parse_u64(p, end, &v);
+    ASSERT(p == end);
+    ASSERT_EQ(v, 678);
+}
+
+TEST(test_parse_u64_no_digits) {
+    const char *s = "  kB";
+    uint64_t v = 99;
+    ASSERT(procfs_parse_u64(s, s + strlen(s), &v) == NULL);
+    ASSERT_EQ(v, 99);
+}
+
+TEST(test_parse_u64_stops_at_end) {
+    /* end cuts the number short: must not read past it */
+    const char *s = "123456";
+    uint64_t v = 0;
+    const char *p = procfs_parse_u64(s, s + 3, &v);
+    ASSERT(p == s + 3);
+    ASSERT_EQ(v, 123);
+}
+
+TEST(test_parse_decimal) {
+    const char *s = "avg10=7.81 12";
+    const char *end = s + strlen(s);
+    double v = 0.0;
+
+    const char *p = procfs_parse_decimal(s + 6, end, &v);
+    ASSERT(p != NULL);
+    ASSERT(v > 7.8099 && v < 7.8101);
+
+    /* Plain integers parse too */
+    p = procfs_parse_decimal(p, end, &v);
+    ASSERT(p == end);
+    ASSERT(v == 12.0);
+}
+
+TEST(test_next_line) {
+    const char *s = "first\nsecond\nthird";
+    const char *end = s + strlen(s);
+
+    const char *p = procfs_next_line(s, end);
+    ASSERT(procfs_has_prefix(p, end, "second"));
+    p = procfs_next_line(p, end);
+    ASSERT(procfs_has_prefix(p, end, "third"));
+    p = procfs_next_line(p, end);
+    ASSERT(p == end);
+}
+
+TEST(test_has_prefix_short_buffer) {
+    const char *s = "Mem";
+    ASSERT(!procfs_has_prefix(s, s + 3, "MemTotal:"));
+    ASSERT(procfs_has_prefix(s, s + 3, "Me"));
+}
+
+/* ==================== File Tests ==================== */
+
+TEST(test_read_file) {
+    const char *path = write_temp("cpu  1 2 3 4\n");
+    procfs_file_t f;
+
+    ASSERT(procfs_open(&f, path, 64));
+    ASSERT(procfs_read(&f));
+    ASSERT_EQ(f.len, 13);
+    ASSERT(memcmp(f.buf, "cpu  1 2 3 4\n", 13) == 0);
+
+    /* Re-reading returns the same contents from offset 0 */
+    ASSERT(procfs_read(&f));
+    ASSERT_EQ(f.len, 13);
+
+    procfs_close(&f);
+    unlink(path);
+}
+
+TEST(test_read_grows_buffer) {
+    char contents[1000];
+    memset(contents, 'x', sizeof(contents) - 1);
+    contents[sizeof(contents) - 1] = '\0';
+
+    const char *path = write_temp(contents);
+    procfs_file_t f;
+
+    ASSERT(procfs_open(&f, path, 16));
+    ASSERT(procfs_read(&f));
+    ASSERT_EQ(f.len, sizeof(contents) - 1);
+    ASSERT(f.cap >= f.len);
+
+    procfs_close(&f);
+    unlink(path);
+}
+
+TEST(test_open_missing_file) {
+    procfs_file_t f;
+    ASSERT(!procfs_open(&f, "/nonexistent/procfs/file", 64));
+    ASSERT_EQ(f.fd, -1);
+    ASSERT(!procfs_read(&f));
+    procfs_close(&f);  /* Must be safe */
+}
+
+/* ==================== Batch Tests ==================== */
+
+static void rewrite(const char *path, const char *contents) {
+    FILE *fp = fopen(path, "w");
+    ASSERT(fp != NULL);
+    fputs(contents, fp);
+    fclose(fp);
+}
+
+/* Each batch test runs with io_uring (where permitted) and with pread */
+static void check_batch_snapshot(bool allow_uring) {
+    char path[64];
+    strcpy(path, write_temp("first\n"));
+    procfs_file_t f;
+
+    bool uring = procfs_batch_init(allow_uring);
+    ASSERT(procfs_open(&f, path, 64));
+    ASSERT(procfs_batch_add(&f));
+    ASSERT(!procfs_batch_add(&f));      /* Already registered */
+
+    ASSERT_EQ(procfs_batch_submit(), 1);
+    rewrite(path, "second\n");
+
+    /* The first read after a submit returns the batched contents */
+    ASSERT(procfs_read(&f));
+    ASSERT_EQ(f.len, 6);
+    ASSERT(memcmp(f.buf, "first\n", 6) == 0);
+
+    /* Later reads go to the file again */
+    ASSERT(procfs_read(&f));
+    ASSERT_EQ(f.len, 7);
+    ASSERT(memcmp(f.buf, "second\n", 7) == 0);
+
+    procfs_batch_stats_t stats;
+    procfs_batch_get_stats(&stats);
+    ASSERT_EQ(stats.submits, 1);
+    if (uring) {
+        ASSERT_EQ(stats.enters, 1);
+        ASSERT_EQ(stats.preads, 0);
+    } else {
+        ASSERT_EQ(stats.preads, 1);
+    }
+
+    procfs_close(&f);
+    procfs_batch_cleanup();
+    unlink(path);
+}
+
+TEST(test_batch_snapshot_uring) {
+    check_batch_snapshot(true);
+}
+
+TEST(test_batch_snapshot_pread) {
+    check_batch_snapshot(false);
+}
+
+TEST(test_batch_large_file_falls_back) {
+    char contents[1000];
+    memset(contents, 'x', sizeof(contents) - 1);
+    contents[sizeof(contents) - 1] = '\0';
+
+    char path[64];
+    strcpy(path, write_temp(contents));
+    procfs_file_t f;
+
+    procfs_batch_init(true);
+    ASSERT(procfs_open(&f, path, 16));
+    ASSERT(procfs_batch_add(&f));
+
+    /* A full buffer may be truncated, so procfs_read grows and re-reads */
+    ASSERT_EQ(procfs_batch_submit(), 0);
+    ASSERT(procfs_read(&f));
+    ASSERT_EQ(f.len, sizeof(contents) - 1);
+
+    /* The grown buffer fits the whole file in the next batch */
+    ASSERT_EQ(procfs_batch_submit(), 1);
+
+    procfs_close(&f);
+    procfs_batch_cleanup();
+    unlink(path);
+}
+
+TEST(test_batch_close_unregisters) {
+    char path_a[64], path_b[64];
+    strcpy(path_a, write_temp("a\n"));
+    strcpy(path_b, write_temp("b\n"));
+    procfs_file_t a, b;
+
+    procfs_batch_init(true);
+    ASSERT(procfs_open(&a, path_a, 64));
+    ASSERT(procfs_open(&b, path_b, 64));
+    ASSERT(procfs_batch_add(&a));
+    ASSERT(procfs_batch_add(&b));
+
+    procfs_close(&a);
+    ASSERT_EQ(procfs_batch_submit(), 1);
+    ASSERT(b.batched);
+    ASSERT_EQ(b.batch_slot, 0);
+
+    procfs_close(&b);
+    ASSERT_EQ(procfs_batch_submit(), 0);
+
+    procfs_batch_cleanup();
+    unlink(path_a);
+    unlink(path_b);
+}
+
+TEST(test_batch_groups) {
+    char path_a[64], path_b[64];
+    strcpy(path_a, write_temp("a\n"));
+    strcpy(path_b, write_temp("b\n"));
+    procfs_file_t a, b;
+
+    procfs_batch_init(true);
+    ASSERT(procfs_open(&a, path_a, 64));
+    ASSERT(procfs_open(&b, path_b, 64));
+    procfs_batch_set_group(1u << 0);
+    ASSERT(procfs_batch_add(&a));
+    procfs_batch_set_group(1u << 1);
+    ASSERT(procfs_batch_add(&b));
+
+    ASSERT_EQ(procfs_batch_submit_groups(1u << 1), 1);
+    ASSERT(!a.batched);
+    ASSERT(b.batched);
+
+    /* Unconsumed contents do not outlive the next submit */
+    ASSERT_EQ(procfs_batch_submit_groups(1u << 0), 1);
+    ASSERT(a.batched);
+    ASSERT(!b.batched);
+
+    ASSERT_EQ(procfs_batch_submit(), 2);
+
+    procfs_close(&a);
+    procfs_close(&b);
+    procfs_batch_cleanup();
+    unlink(path_a);
+    unlink(path_b);
+}
+
+TEST(test_batch_disabled) {
+    procfs_file_t f;
+    ASSERT(procfs_open(&f, "/proc/self/stat", 1024));
+    ASSERT(!procfs_batch_add(&f));
+    ASSERT_EQ(procfs_batch_submit(), 0);
+    procfs_close(&f);
+}
+
+int main(void) {
+    printf("Running procfs tests...\n\n");
+
+    printf("Scanner tests:\n");
+    RUN_TEST(test_parse_u64_basic);
+    RUN_TEST(test_parse_u64_no_digits);
+    RUN_TEST(test_parse_u64_stops_at_end);
+    RUN_TEST(test_parse_decimal);
+    RUN_TEST(test_next_line);
+    RUN_TEST(test_has_prefix_short_buffer);
+
+    printf("\nFile tests:\n");
+    RUN_TEST(test_read_file);
+    RUN_TEST(test_read_grows_buffer);
+    RUN_TEST(test_open_missing_file);
+
+    printf("\nBatch tests:\n");
+    RUN_TEST(test_batch_snapshot_uring);
+    RUN_TEST(test_batch_snapshot_pread);
+    RUN_TEST(test_batch_large_file_falls_back);
+    RUN_TEST(test_batch_close_unregisters);
+    RUN_TEST(test_batch_groups);
+    RUN_TEST(test_batch_disabled);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
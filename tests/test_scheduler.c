@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../src/scheduler.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+/* ==================== Tick Tests ==================== */
+
+TEST(test_pick_tick) {
+    int intervals[] = { 1000, 2500, 10000 };
+    ASSERT_EQ(sched_pick_tick(intervals, 3), 500);
+
+    int single[] = { 1000 };
+    ASSERT_EQ(sched_pick_tick(single, 1), 1000);
+
+    /* Unset intervals are ignored */
+    int unset[] = { 0, 3000, 2000 };
+    ASSERT_EQ(sched_pick_tick(unset, 3), 1000);
+
+    /* Co-prime intervals fall back to the finest tick */
+    int coprime[] = { 1000, 1001 };
+    ASSERT_EQ(sched_pick_tick(coprime, 2), SCHED_MIN_TICK_MS);
+}
+
+/* ==================== Firing Tests ==================== */
+
+TEST(test_tasks_fire_on_interval) {
+    sched_init(500);
+    int fast = sched_add(1000);
+    int slow = sched_add(2500);
+    ASSERT_EQ(fast, 0);
+    ASSERT_EQ(slow, 1);
+
+    /* Everything is due once straight away */
+    ASSERT_EQ(sched_advance(0), 0x3u);
+    ASSERT_EQ(sched_ticks_until_due(), 2);
+
+    int fast_runs = 0, slow_runs = 0;
+    for (int tick = 1; tick <= 20; tick++) {
+        uint32_t due = sched_advance(1);
+        if (due & (1u << fast)) {
+            fast_runs++;
+            ASSERT_EQ(tick % 2, 0);
+        }
+        if (due & (1u << slow)) {
+            slow_runs++;
+            ASSERT_EQ(tick % 5, 0);
+        }
+    }
+    ASSERT_EQ(fast_runs, 10);
+    ASSERT_EQ(slow_runs, 4);
+}
+
+TEST(test_interval_longer_than_wheel) {
+    sched_init(50);
+    int id = sched_add(50 * (SCHED_WHEEL_SLOTS * 2 + 3));
+    sched_advance(0);
+
+    int runs = 0;
+    int first = 0;
+    for (int tick = 1; tick <= SCHED_WHEEL_SLOTS * 5; tick++) {
+        if (sched_advance(1) & (1u << id)) {
+            if (runs++ == 0) first = tick;
+        }
+    }
+    ASSERT_EQ(first, SCHED_WHEEL_SLOTS * 2 + 3);
+    ASSERT_EQ(runs, 2);
+}
+
+TEST(test_late_caller_fires_once) {
+    sched_init(100);
+    int id = sched_add(100);
+    sched_add(1000);
+    sched_advance(0);
+
+    /* Ten ticks missed: each task fires once, not once per missed tick */
+    uint32_t due = sched_advance(10);
+    ASSERT_EQ(due, 0x3u);
+
+    /* And the schedule stays on its original phase */
+    ASSERT_EQ(sched_ticks_until_due(), 1);
+    ASSERT_EQ(sched_advance(1), 1u << id);
+}
+
+int main(void) {
+    printf("Running scheduler tests...\n\n");
+
+    printf("Tick tests:\n");
+    RUN_TEST(test_pick_tick);
+
+    printf("\nFiring tests:\n");
+    RUN_TEST(test_tasks_fire_on_interval);
+    RUN_TEST(test_interval_longer_than_wheel);
+    RUN_TEST(test_late_caller_fires_once);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
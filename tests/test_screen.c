@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/screen.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+/* Draw one frame of text and return the output as a string */
+static char output[8192];
+
+static const char *frame(int cols, int rows, const char *text) {
+    ASSERT(screen_begin(cols, rows));
+    screen_write(text, strlen(text));
+    size_t len;
+    const char *changes = screen_end(&len);
+    ASSERT(len < sizeof(output));
+    memcpy(output, changes, len);
+    output[len] = '\0';
+    return output;
+}
+
+/* ==================== Grid Tests ==================== */
+
+TEST(test_text_and_styles_fill_cells) {
+    screen_cleanup();
+    ASSERT(screen_begin(20, 4));
+    const char *text = "\033[1m\033[32mCPU\033[0m [\xe2\x96\x81]\n\033[K\nab\033[Hx";
+    screen_write(text, strlen(text));
+
+    const screen_cell_t *c = screen_cell(0, 0);
+    ASSERT_EQ(c->glyph[0], 'x');
+    c = screen_cell(0, 1);
+    ASSERT_EQ(c->glyph[0], 'P');
+    ASSERT_EQ(c->fg, 32);
+    ASSERT_EQ(c->attrs, SCREEN_ATTR_BOLD);
+
+    /* A multi-byte character is one cell, and resets leave plain text */
+    c = screen_cell(0, 5);
+    ASSERT_EQ(c->len, 3);
+    ASSERT(memcmp(c->glyph, "\xe2\x96\x81", 3) == 0);
+    ASSERT_EQ(screen_cell(0, 6)->glyph[0], ']');
+    ASSERT_EQ(screen_cell(0, 6)->fg, 0);
+    ASSERT_EQ(screen_cell(2, 1)->glyph[0], 'b');
+    ASSERT(screen_cell(4, 0) == NULL);
+
+    size_t len;
+    screen_end(&len);
+}
+
+TEST(test_stray_continuation_byte_takes_a_column) {
+    screen_cleanup();
+    ASSERT(screen_begin(20, 2));
+
+    /* A UTF-8 degree sign is one cell */
+    const char *utf8 = "45\xc2\xb0" "C|";
+    screen_write(utf8, strlen(utf8));
+    ASSERT_EQ(screen_cell(0, 2)->len, 2);
+    ASSERT_EQ(screen_cell(0, 3)->glyph[0], 'C');
+    ASSERT_EQ(screen_cell(0, 4)->glyph[0], '|');
+
+    /* A bare Latin-1 0xB0 is not merged into the "5" before it */
+    const char *bare = "\n45\xb0" "C|";
+    screen_write(bare, strlen(bare));
+    ASSERT_EQ(screen_cell(1, 1)->len, 1);
+    ASSERT_EQ(screen_cell(1, 2)->len, 1);
+    ASSERT_EQ((unsigned char)screen_cell(1, 2)->glyph[0], 0xB0);
+    ASSERT_EQ(screen_cell(1, 3)->glyph[0], 'C');
+    ASSERT_EQ(screen_cell(1, 4)->glyph[0], '|');
+
+    size_t len;
+    screen_end(&len);
+}
+
+TEST(test_overflow_is_clipped) {
+    screen_cleanup();
+    ASSERT(screen_begin(4, 2));
+    const char *text = "abcdefgh\n1\n2\n3";
+    screen_write(text, strlen(text));
+    ASSERT_EQ(screen_cell(0, 3)->glyph[0], 'd');
+    ASSERT_EQ(screen_cell(1, 0)->glyph[0], '1');
+    size_t len;
+    screen_end(&len);
+}
+
+/* ==================== Diff Tests ==================== */
+
+TEST(test_first_frame_paints_everything) {
+    screen_cleanup();
+    const char *out = frame(20, 3, "hello\nworld\n");
+    ASSERT(strstr(out, "\033[2J") != NULL);
+    ASSERT(strstr(out, "hello") != NULL);
+    ASSERT(strstr(out, "world") != NULL);
+}
+
+TEST(test_unchanged_frame_sends_nothing) {
+    screen_cleanup();
+    frame(20, 3, "hello\nworld\n");
+    const char *out = frame(20, 3, "hello\nworld\n");
+    ASSERT_EQ(strlen(out), 0);
+}
+
+TEST(test_only_changed_cells_are_sent) {
+    screen_cleanup();
+    frame(20, 3, "cpu   12.0%\nmem   40.0%\n");
+    const char *out = frame(20, 3, "cpu   13.0%\nmem   40.0%\n");
+    /* A move to row 1, column 8, the new digit, then the cursor parks */
+    ASSERT(strncmp(out, "\033[1;8H3", 7) == 0);
+    ASSERT(strstr(out, "cpu") == NULL);
+    ASSERT(strstr(out, "mem") == NULL);
+    ASSERT(strstr(out, "\033[2J") == NULL);
+}
+
+TEST(test_nearby_changes_share_a_move) {
+    screen_cleanup();
+    frame(20, 1, "a1b2c");
+    const char *out = frame(20, 1, "a9b9c");
+    /* Rewriting "b" is shorter than a second cursor move */
+    ASSERT(strncmp(out, "\033[1;2H9b9", 9) == 0);
+}
+
+TEST(test_style_change_and_removed_text) {
+    screen_cleanup();
+    frame(20, 2, "\033[32mok\033[0m\nextra line\n");
+    const char *out = frame(20, 2, "\033[31mok\033[0m\n");
+    /* Recolored cells carry their style, and the style is reset after */
+    ASSERT(strncmp(out, "\033[1;1H\033[0;31mok", 15) == 0);
+    /* The vanished line is blanked, in the default style */
+    ASSERT(strstr(out, "\033[2;1H\033[0m          ") != NULL);
+}
+
+TEST(test_resize_and_invalidate_repaint) {
+    screen_cleanup();
+    frame(20, 2, "same\n");
+    const char *out = frame(30, 2, "same\n");
+    ASSERT(strstr(out, "\033[2J") != NULL);
+    ASSERT(strstr(out, "same") != NULL);
+
+    screen_invalidate();
+    out = frame(30, 2, "same\n");
+    ASSERT(strstr(out, "\033[2J") != NULL);
+    ASSERT(strstr(out, "same") != NULL);
+
+    out = frame(30, 2, "same\n");
+    ASSERT_EQ(strlen(out), 0);
+    screen_cleanup();
+}
+
+int main(void) {
+    printf("Running screen tests...\n\n");
+
+    printf("Grid tests:\n");
+    RUN_TEST(test_text_and_styles_fill_cells);
+    RUN_TEST(test_stray_continuation_byte_takes_a_column);
+    RUN_TEST(test_overflow_is_clipped);
+
+    printf("\nDiff tests:\n");
+    RUN_TEST(test_first_frame_paints_everything);
+    RUN_TEST(test_unchanged_frame_sends_nothing);
+    RUN_TEST(test_only_changed_cells_are_sent);
+    RUN_TEST(test_nearby_changes_share_a_move);
+    RUN_TEST(test_style_change_and_removed_text);
+    RUN_TEST(test_resize_and_invalidate_repaint);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
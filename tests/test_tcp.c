@@ -0,0 +1,204 @@
+#include <arpa/inet.h>
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../src/metrics_tcp.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+/* ==================== Fake netlink replies ==================== */
+
+static uint64_t reply[1024];
+static size_t reply_len;
+
+static void add_msg(uint16_t type, uint32_t seq, uint8_t state,
+                    uint32_t rqueue, uint32_t wqueue) {
+    struct nlmsghdr *h = (struct nlmsghdr *)((char *)reply + reply_len);
+    size_t payload = type == SOCK_DIAG_BY_FAMILY ? sizeof(struct inet_diag_msg) : sizeof(int);
+
+    memset(h, 0, NLMSG_SPACE(payload));
+    h->nlmsg_len = NLMSG_LENGTH(payload);
+    h->nlmsg_type = type;
+    h->nlmsg_seq = seq;
+    if (type == SOCK_DIAG_BY_FAMILY) {
+        struct inet_diag_msg *msg = NLMSG_DATA(h);
+        msg->idiag_family = AF_INET;
+        msg->idiag_state = state;
+        msg->idiag_rqueue = rqueue;
+        msg->idiag_wqueue = wqueue;
+    }
+    reply_len += NLMSG_SPACE(payload);
+}
+
+/* ==================== Aggregation Tests ==================== */
+
+TEST(test_counts_states) {
+    static tcp_metrics_t tcp;
+    memset(&tcp, 0, sizeof(tcp));
+    reply_len = 0;
+
+    add_msg(SOCK_DIAG_BY_FAMILY, 7, TCP_ESTABLISHED, 0, 0);
+    add_msg(SOCK_DIAG_BY_FAMILY, 7, TCP_ESTABLISHED, 0, 0);
+    add_msg(SOCK_DIAG_BY_FAMILY, 7, TCP_TIME_WAIT, 0, 0);
+    add_msg(SOCK_DIAG_BY_FAMILY, 7, TCP_CLOSE_WAIT, 0, 0);
+    add_msg(SOCK_DIAG_BY_FAMILY, 7, TCP_FIN_WAIT2, 0, 0);
+    /* Listener with 128 of 128 accept slots taken, and one with room */
+    add_msg(SOCK_DIAG_BY_FAMILY, 7, TCP_LISTEN, 128, 128);
+    add_msg(SOCK_DIAG_BY_FAMILY, 7, TCP_LISTEN, 3, 4096);
+    /* A late reply to an earlier dump is ignored */
+    add_msg(SOCK_DIAG_BY_FAMILY, 6, TCP_ESTABLISHED, 0, 0);
+
+    ASSERT_EQ(tcp_diag_accumulate(reply, reply_len, 7, &tcp), 0);
+    ASSERT_EQ(tcp.established, 2);
+    ASSERT_EQ(tcp.time_wait, 1);
+    ASSERT_EQ(tcp.close_wait, 1);
+    ASSERT_EQ(tcp.fin_wait, 1);
+    ASSERT_EQ(tcp.listen, 2);
+    ASSERT_EQ(tcp.listen_full, 1);
+    ASSERT_EQ(tcp.total, 7);
+
+    /* Counts accumulate across datagrams until NLMSG_DONE */
+    reply_len = 0;
+    add_msg(SOCK_DIAG_BY_FAMILY, 7, TCP_ESTABLISHED, 0, 0);
+    add_msg(NLMSG_DONE, 7, 0, 0, 0);
+    ASSERT_EQ(tcp_diag_accumulate(reply, reply_len, 7, &tcp), 1);
+    ASSERT_EQ(tcp.established, 3);
+}
+
+TEST(test_error_reply) {
+    static tcp_metrics_t tcp;
+    memset(&tcp, 0, sizeof(tcp));
+    reply_len = 0;
+
+    add_msg(NLMSG_ERROR, 3, 0, 0, 0);
+    ASSERT_EQ(tcp_diag_accumulate(reply, reply_len, 3, &tcp), -1);
+    ASSERT_EQ(tcp.total, 0);
+}
+
+/* ==================== Live Tests ==================== */
+
+TEST(test_counts_loopback_connection) {
+    /* A listener plus one connection: two ESTABLISHED ends */
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT(listener >= 0);
+    struct sockaddr_in addr = { .sin_family = AF_INET };
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT(bind(listener, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    ASSERT(listen(listener, 4) == 0);
+    socklen_t addr_len = sizeof(addr);
+    ASSERT(getsockname(listener, (struct sockaddr *)&addr, &addr_len) == 0);
+
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT(client >= 0);
+    ASSERT(connect(client, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+
+    if (!tcp_metrics_init(NULL)) {
+        printf("(no sock_diag) ");
+        close(client);
+        close(listener);
+        return;
+    }
+
+    static tcp_metrics_t tcp;
+    ASSERT(tcp_metrics_get(&tcp));
+    ASSERT(tcp.listen >= 1);
+    ASSERT(tcp.established >= 2);
+    ASSERT(tcp.total >= 3);
+
+    tcp_metrics_cleanup();
+    ASSERT(!tcp_metrics_get(&tcp));
+    close(client);
+    close(listener);
+}
+
+TEST(test_listen_overflow_rate) {
+    char root[64], path[128];
+    strcpy(root, "/tmp/test_tcp_XXXXXX");
+    ASSERT(mkdtemp(root) != NULL);
+    snprintf(path, sizeof(path), "%s/net", root);
+    ASSERT(mkdir(path, 0755) == 0);
+    snprintf(path, sizeof(path), "%s/net/netstat", root);
+
+    FILE *fp = fopen(path, "w");
+    ASSERT(fp != NULL);
+    fputs("TcpExt: SyncookiesSent ListenOverflows ListenDrops TCPBacklogDrop\n"
+          "TcpExt: 0 100 150 0\n"
+          "IpExt: InNoRoutes\n"
+          "IpExt: 0\n", fp);
+    fclose(fp);
+
+    if (!tcp_metrics_init(root)) {
+        printf("(no sock_diag) ");
+    } else {
+        fp = fopen(path, "w");
+        ASSERT(fp != NULL);
+        fputs("TcpExt: SyncookiesSent ListenOverflows ListenDrops TCPBacklogDrop\n"
+              "TcpExt: 0 110 160 0\n", fp);
+        fclose(fp);
+        usleep(10000);
+
+        static tcp_metrics_t tcp;
+        ASSERT(tcp_metrics_get(&tcp));
+        ASSERT(tcp.has_listen_stats);
+        ASSERT(tcp.listen_overflow_rate > 0.0);
+        ASSERT(tcp.listen_drop_rate > 0.0);
+
+        ASSERT(tcp_metrics_get(&tcp));
+        ASSERT(tcp.listen_overflow_rate == 0.0);
+        tcp_metrics_cleanup();
+    }
+
+    snprintf(path, sizeof(path), "rm -rf %s", root);
+    ASSERT(system(path) == 0);
+}
+
+int main(void) {
+    printf("Running TCP socket state tests...\n\n");
+
+    printf("Aggregation tests:\n");
+    RUN_TEST(test_counts_states);
+    RUN_TEST(test_error_reply);
+
+    printf("\nLive tests:\n");
+    RUN_TEST(test_counts_loopback_connection);
+    RUN_TEST(test_listen_overflow_rate);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}
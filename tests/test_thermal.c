@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/metrics_thermal.h"
+
+/* Simple test framework */
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) static void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n    at %s:%d\n", #cond, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("FAILED\n    Expected %lld but got %lld\n    at %s:%d\n", (long long)(b), (long long)(a), __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while(0)
+
+/* ==================== Fake sysfs tree ==================== */
+
+#include "fake_fs.h"
+
+/* ==================== hwmon Tests ==================== */
+
+TEST(test_coretemp_package_and_cores) {
+    make_root("test_thermal");
+
+    /* An unrelated sensor first, to check it is skipped */
+    make_dirs("class/hwmon/hwmon0");
+    write_file("class/hwmon/hwmon0/name", "nvme\n");
+    write_file("class/hwmon/hwmon0/temp1_input", "40000\n");
+
+    make_dirs("class/hwmon/hwmon1");
+    write_file("class/hwmon/hwmon1/name", "coretemp\n");
+    write_file("class/hwmon/hwmon1/temp1_label", "Package id 0\n");
+    write_file("class/hwmon/hwmon1/temp1_input", "61000\n");
+    write_file("class/hwmon/hwmon1/temp2_label", "Core 0\n");
+    write_file("class/hwmon/hwmon1/temp2_input", "55000\n");
+    write_file("class/hwmon/hwmon1/temp10_label", "Core 4\n");
+    write_file("class/hwmon/hwmon1/temp10_input", "58499\n");
+
+    ASSERT(thermal_metrics_init(root));
+
+    static thermal_metrics_t t;
+    ASSERT(thermal_metrics_get(&t));
+    ASSERT_EQ(t.cpu_celsius, 61);
+    ASSERT_EQ(t.package_count, 1);
+    ASSERT(strcmp(t.packages[0].label, "Pkg0") == 0);
+    ASSERT_EQ(t.core_count, 2);
+    /* temp2 sorts before temp10 */
+    ASSERT(strcmp(t.cores[0].label, "Core0") == 0);
+    ASSERT_EQ(t.cores[0].celsius, 55);
+    ASSERT(strcmp(t.cores[1].label, "Core4") == 0);
+    ASSERT_EQ(t.cores[1].celsius, 58);
+
+    /* Values are re-read through the open fds */
+    write_file("class/hwmon/hwmon1/temp1_input", "72000\n");
+    ASSERT(thermal_metrics_get(&t));
+    ASSERT_EQ(t.cpu_celsius, 72);
+
+    thermal_metrics_cleanup();
+    remove_root();
+}
+
+TEST(test_k10temp_prefers_tdie) {
+    make_root("test_thermal");
+
+    make_dirs("class/hwmon/hwmon2");
+    write_file("class/hwmon/hwmon2/name", "k10temp\n");
+    write_file("class/hwmon/hwmon2/temp1_label", "Tctl\n");
+    write_file("class/hwmon/hwmon2/temp1_input", "75000\n");
+    write_file("class/hwmon/hwmon2/temp2_label", "Tdie\n");
+    write_file("class/hwmon/hwmon2/temp2_input", "65000\n");
+    write_file("class/hwmon/hwmon2/temp3_label", "Tccd1\n");
+    write_file("class/hwmon/hwmon2/temp3_input", "60000\n");
+
+    ASSERT(thermal_metrics_init(root));
+
+    static thermal_metrics_t t;
+    ASSERT(thermal_metrics_get(&t));
+    ASSERT_EQ(t.cpu_celsius, 65);
+    ASSERT_EQ(t.core_count, 1);
+    ASSERT(strcmp(t.cores[0].label, "Tccd1") == 0);
+
+    thermal_metrics_cleanup();
+    remove_root();
+}
+
+/* ==================== Thermal zone Tests ==================== */
+
+TEST(test_thermal_zone_fallback) {
+    make_root("test_thermal");
+
+    make_dirs("class/thermal/thermal_zone0");
+    write_file("class/thermal/thermal_zone0/type", "acpitz\n");
+    write_file("class/thermal/thermal_zone0/temp", "30000\n");
+    make_dirs("class/thermal/thermal_zone1");
+    write_file("class/thermal/thermal_zone1/type", "x86_pkg_temp\n");
+    write_file("class/thermal/thermal_zone1/temp", "48000\n");
+
+    ASSERT(thermal_metrics_init(root));
+
+    static thermal_metrics_t t;
+    ASSERT(thermal_metrics_get(&t));
+    /* acpitz is ignored when a CPU zone exists */
+    ASSERT_EQ(t.package_count, 1);
+    ASSERT_EQ(t.cpu_celsius, 48);
+
+    thermal_metrics_cleanup();
+    remove_root();
+}
+
+TEST(test_no_sensors) {
+    make_root("test_thermal");
+    ASSERT(!thermal_metrics_init(root));
+
+    static thermal_metrics_t t;
+    ASSERT(!thermal_metrics_get(&t));
+    ASSERT_EQ(t.cpu_celsius, -1);
+
+    thermal_metrics_cleanup();
+    remove_root();
+}
+
+int main(void) {
+    printf("Running thermal sensor tests...\n\n");
+
+    printf("hwmon tests:\n");
+    RUN_TEST(test_coretemp_package_and_cores);
+    RUN_TEST(test_k10temp_prefers_tdie);
+
+    printf("\nThermal zone tests:\n");
+    RUN_TEST(test_thermal_zone_fallback);
+    RUN_TEST(test_no_sensors);
+
+    printf("\n========================================\n");
+    printf("Tests: %d passed, %d total\n", tests_passed, tests_run);
+    printf("========================================\n");
+
+    return 0;
+}